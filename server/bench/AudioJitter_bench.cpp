@@ -0,0 +1,172 @@
+/* Plays a synthetic stream on a paced device without a sound card (null audio backend, realtime) and reports
+   jitter of the device callbacks and underruns - first with the audio callback in this process, then through
+   the out-of-process audio engine. Meanwhile busy threads load every CPU core and an app thread periodically
+   holds, for tens of milliseconds, a lock the audio callback also takes (like logging or app state would).
+   Usage: pdbAudioJitter [seconds per mode] [number of load threads] [path to pdbAudioEngine] */
+
+#include "Config.h"
+#include "systems/audio/AudioOutputNull.h"
+#include "systems/audio/AudioOutputRemote.h"
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const unsigned int sampleRate = 22050;
+const unsigned int bufferFrames = 256;
+const auto appStallPeriod = std::chrono::milliseconds(250);
+const auto appStallDuration = std::chrono::milliseconds(40);
+
+std::mutex appMutex;
+std::atomic<bool> loadRunning(false);
+
+struct CallbackState
+{
+    double phase = 0.0;
+    /* Measured here only in process - remotely the engine measures the device side */
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point lastCallbackTime;
+    uint64_t nCallbacks = 0;
+    uint64_t nUnderruns = 0;
+    double totalJitterMicroseconds = 0.0;
+    double maxJitterMicroseconds = 0.0;
+    bool measure = false;
+};
+
+int sineCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime, RtAudioStreamStatus status, void* userData)
+{
+    CallbackState& state = *static_cast<CallbackState*>(userData);
+    const auto callbackTime = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(appMutex);
+        int16_t* output = static_cast<int16_t*>(outputBuffer);
+        for (unsigned int i = 0; i < nBufferFrames; ++i)
+        {
+            output[i] = (int16_t)(8000.0 * std::sin(state.phase));
+            state.phase += 2.0 * M_PI * 440.0 / sampleRate;
+        }
+    }
+
+    if (state.measure)
+    {
+        const double periodMicroseconds = 1e6 * nBufferFrames / sampleRate;
+        if (state.nCallbacks > 0)
+        {
+            const double jitter = std::abs(std::chrono::duration<double, std::micro>(callbackTime - state.lastCallbackTime).count() - periodMicroseconds);
+            state.totalJitterMicroseconds += jitter;
+            state.maxJitterMicroseconds = std::max(state.maxJitterMicroseconds, jitter);
+        }
+        else state.startTime = callbackTime;
+        /* A device double buffers - buffer n must be ready before buffer n - 1 finished playing, every late buffer is a glitch */
+        const double deadlineMicroseconds = (state.nCallbacks + 1) * periodMicroseconds;
+        if (std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - state.startTime).count() > deadlineMicroseconds)
+            ++state.nUnderruns;
+        state.lastCallbackTime = callbackTime;
+        ++state.nCallbacks;
+    }
+    return 0;
+}
+
+std::vector<std::thread> startLoad(int nLoadThreads)
+{
+    loadRunning = true;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nLoadThreads; ++i)
+    {
+        threads.emplace_back([]
+        {
+            volatile double value = 0.0;
+            while (loadRunning) for (int j = 0; j < 10000; ++j) value = value + std::sqrt((double)j);
+        });
+    }
+    threads.emplace_back([]
+    {
+        while (loadRunning)
+        {
+            std::this_thread::sleep_for(appStallPeriod);
+            std::lock_guard<std::mutex> lock(appMutex);
+            std::this_thread::sleep_for(appStallDuration);
+        }
+    });
+    return threads;
+}
+
+void stopLoad(std::vector<std::thread>& threads)
+{
+    loadRunning = false;
+    for (auto& thread : threads) thread.join();
+}
+
+void printResult(const std::string& mode, uint64_t nCallbacks, uint64_t nUnderruns, double averageJitter, double maxJitter)
+{
+    std::cout << mode << ": " << nCallbacks << " device callbacks, " << nUnderruns << " underruns, jitter avg "
+        << averageJitter << " us, max " << maxJitter << " us" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const int nSeconds = (argc > 1) ? std::stoi(argv[1]) : 10;
+    const int nLoadThreads = (argc > 2) ? std::stoi(argv[2]) : (int)std::thread::hardware_concurrency();
+
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+    Pdb::Config config = Pdb::Config::getInstance();
+    config.remoteEngineBackend = Pdb::AudioBackend::NULL_OUTPUT;
+    config.remoteEngineSpawn = true;
+    if (argc > 3) config.remoteEnginePath = argv[3];
+    Pdb::Config::publish(config);
+
+    std::cout << "Buffer " << bufferFrames << " frames at " << sampleRate << " Hz, " << nLoadThreads << " load threads, app stalls of "
+        << appStallDuration.count() << " ms every " << appStallPeriod.count() << " ms." << std::endl;
+
+    {
+        CallbackState state;
+        state.measure = true;
+        Pdb::AudioOutputNull output(true);
+        unsigned int nFrames = bufferFrames;
+        output.open(1, sampleRate, RTAUDIO_SINT16, &nFrames, &sineCallback, &state);
+        auto loadThreads = startLoad(nLoadThreads);
+        output.start();
+        std::this_thread::sleep_for(std::chrono::seconds(nSeconds));
+        output.close();
+        stopLoad(loadThreads);
+        printResult("In process", state.nCallbacks, state.nUnderruns,
+            state.nCallbacks > 1 ? state.totalJitterMicroseconds / (state.nCallbacks - 1) : 0.0, state.maxJitterMicroseconds);
+    }
+
+    {
+        CallbackState state;
+        Pdb::AudioOutputRemote output;
+        unsigned int nFrames = bufferFrames;
+        output.open(1, sampleRate, RTAUDIO_SINT16, &nFrames, &sineCallback, &state);
+        if (!output.isOpen())
+        {
+            std::cerr << "Audio engine not available." << std::endl;
+            return 1;
+        }
+        auto loadThreads = startLoad(nLoadThreads);
+        output.start();
+        std::this_thread::sleep_for(std::chrono::seconds(nSeconds));
+        const Pdb::AudioOutputRemote::Stats stats = output.getStats();
+        output.close();
+        stopLoad(loadThreads);
+        printResult("Out of process (" + std::to_string(config.remoteRingMilliseconds) + " ms ring)", stats.nCallbacks, stats.nUnderruns,
+            stats.averageJitterMicroseconds, stats.maxJitterMicroseconds);
+    }
+
+    return 0;
+}
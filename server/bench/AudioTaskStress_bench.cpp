@@ -0,0 +1,111 @@
+/* Fires thousands of prompts through AudioManager on the null audio backend (no sound card, drained
+   as fast as possible) and reports the process thread count and prompt latencies.
+   Usage: pdbAudioTaskStress [prompt.mp3] [number of prompts] */
+
+#include "Config.h"
+#include "systems/audio/AudioManager.h"
+#include "systems/executor/RunLoopExecutor.h"
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+int currentThreadCount()
+{
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);)
+    {
+        if (line.compare(0, 8, "Threads:") == 0) return std::stoi(line.substr(8));
+    }
+    return -1;
+}
+
+double percentile(std::vector<double> values, double fraction)
+{
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(fraction * values.size()))];
+}
+
+double microsecondsSince(std::chrono::steady_clock::time_point timePoint)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - timePoint).count();
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string promptPath = (argc > 1) ? argv[1] : "../data/synthesized_sounds/apps/audiobook/messages/pl/2x.mp3";
+    int nPrompts = (argc > 2) ? std::stoi(argv[2]) : 5000;
+
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+    Pdb::Config config = Pdb::Config::getInstance();
+    config.audioBackend = Pdb::AudioBackend::NULL_OUTPUT;
+    config.nullAudioBackendRealtime = false;
+    Pdb::Config::publish(config);
+
+    if (!boost::filesystem::exists(promptPath))
+    {
+        std::cerr << "Prompt file " << promptPath << " not found." << std::endl;
+        return 1;
+    }
+
+    std::atomic<int> nPlayingOverlays(0);
+    Pdb::AudioManager audioManager(nPlayingOverlays);
+    Pdb::AudioTrack prompt(promptPath, Pdb::AudioTrack::Type::VOICE_MESSAGE);
+    Pdb::RunLoopExecutor executor;
+
+    const int threadCountBefore = currentThreadCount();
+    int peakThreadCount = threadCountBefore;
+    std::vector<double> playCallLatencies, completionLatencies;
+    size_t nInFlight = 0;
+    int nRejected = 0;
+    const size_t maxInFlight = audioManager.getMp3AudioStreamCount();
+
+    auto benchmarkStartTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < nPrompts; ++i)
+    {
+        while (nInFlight >= maxInFlight) executor.waitAndRunPending(std::chrono::milliseconds(100));
+
+        auto playTime = std::chrono::steady_clock::now();
+        Pdb::AudioTask* audioTask = audioManager.play({ prompt });
+        if (!audioTask)
+        {
+            ++nRejected;
+            continue;
+        }
+        playCallLatencies.push_back(microsecondsSince(playTime));
+        ++nInFlight;
+        audioTask->then(executor, [&, playTime]
+        {
+            completionLatencies.push_back(microsecondsSince(playTime));
+            --nInFlight;
+        });
+
+        if (i % 64 == 0) peakThreadCount = std::max(peakThreadCount, currentThreadCount());
+    }
+    while (nInFlight > 0) executor.waitAndRunPending(std::chrono::milliseconds(100));
+    double totalSeconds = microsecondsSince(benchmarkStartTime) / 1e6;
+
+    std::cout << "Prompts played: " << completionLatencies.size() << " (rejected: " << nRejected << ") in " << totalSeconds << " s" << std::endl;
+    std::cout << "Threads: before " << threadCountBefore << ", peak " << peakThreadCount << ", after " << currentThreadCount() << std::endl;
+    std::cout << "AudioManager::play() call [us]: p50 " << percentile(playCallLatencies, 0.5) << ", p99 " << percentile(playCallLatencies, 0.99)
+        << ", max " << percentile(playCallLatencies, 1.0) << std::endl;
+    std::cout << "Prompt completion [us]: p50 " << percentile(completionLatencies, 0.5) << ", p99 " << percentile(completionLatencies, 0.99)
+        << ", max " << percentile(completionLatencies, 1.0) << std::endl;
+
+    return 0;
+}
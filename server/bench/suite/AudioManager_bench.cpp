@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+#include "Config.h"
+#include "systems/audio/AudioManager.h"
+#include "systems/audio/AudioOutputNull.h"
+#include "systems/audio/AudioStream.h"
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace
+{
+
+const int nPrompts = 200;
+const auto timeout = std::chrono::seconds(2);
+
+void setNullBackendRealtime()
+{
+    Pdb::Config config = Pdb::Config::getInstance();
+    config.nullAudioBackendRealtime = true;
+    Pdb::Config::publish(config);
+}
+
+/* The mp3 prompt when available, a generated WAV (played by a decoded stream) otherwise */
+std::unique_ptr<Pdb::AudioTrack> createPrompt(Pdb::Benchmark& benchmark)
+{
+    std::string promptPath = benchmark.getOptions().promptPath;
+    if (!boost::filesystem::exists(promptPath)) promptPath = benchmark.getWavFile(1.0, 22050);
+    benchmark.setParameter("prompt", promptPath);
+    return std::make_unique<Pdb::AudioTrack>(promptPath, Pdb::AudioTrack::Type::VOICE_MESSAGE);
+}
+
+bool waitUntil(const std::function<bool()>& condition)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() - startTime > timeout) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/* Stops the prompt and waits until its task and stream are back in the pools */
+bool stopPrompt(Pdb::AudioTask* audioTask)
+{
+    audioTask->stop();
+    return waitUntil([&] { return audioTask->isAvailable(); });
+}
+
+/* Duration of AudioManager::play() - finding free task and stream, opening the track and the output */
+void playCall(Pdb::Benchmark& benchmark)
+{
+    setNullBackendRealtime();
+    std::atomic<int> nPlayingOverlays(0);
+    Pdb::AudioManager audioManager(nPlayingOverlays);
+    std::unique_ptr<Pdb::AudioTrack> prompt = createPrompt(benchmark);
+
+    for (int i = 0; i < nPrompts; ++i)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        Pdb::AudioTask* audioTask = audioManager.play({ *prompt });
+        const auto duration = std::chrono::steady_clock::now() - startTime;
+        if (!audioTask || !stopPrompt(audioTask)) return benchmark.skip("prompt could not be played");
+        benchmark.addSample(duration);
+    }
+}
+
+/* From AudioManager::play() until the stream filled the first buffer of the (paced) null device */
+void promptStartLatency(Pdb::Benchmark& benchmark)
+{
+    setNullBackendRealtime();
+    std::atomic<int> nPlayingOverlays(0);
+    Pdb::AudioManager audioManager(nPlayingOverlays);
+    std::unique_ptr<Pdb::AudioTrack> prompt = createPrompt(benchmark);
+
+    for (int i = 0; i < nPrompts; ++i)
+    {
+        const unsigned long nStartedRuns = Pdb::AudioOutputNull::getStartedRunCount();
+        const auto startTime = std::chrono::steady_clock::now();
+        Pdb::AudioTask* audioTask = audioManager.play({ *prompt });
+        if (!audioTask || !waitUntil([&] { return Pdb::AudioOutputNull::getStartedRunCount() != nStartedRuns; }))
+            return benchmark.skip("prompt did not start playing");
+        benchmark.addSample(std::chrono::steady_clock::now() - startTime);
+        if (!stopPrompt(audioTask)) return benchmark.skip("prompt could not be stopped");
+    }
+}
+
+/* From AudioManager::play() of a prompt until the content played by another audio manager filled a ducked buffer */
+void promptDuckingLatency(Pdb::Benchmark& benchmark)
+{
+    setNullBackendRealtime();
+    std::atomic<int> nPlayingOverlays(0);
+    Pdb::AudioManager contentAudioManager(nPlayingOverlays);
+    Pdb::AudioManager promptAudioManager(nPlayingOverlays);
+    Pdb::AudioTrack content(benchmark.getWavFile(60.0, 22050), Pdb::AudioTrack::Type::STANDARD);
+    std::unique_ptr<Pdb::AudioTrack> prompt = createPrompt(benchmark);
+
+    Pdb::AudioTask* contentAudioTask = contentAudioManager.play({ content });
+    if (!contentAudioTask) return benchmark.skip("content could not be played");
+
+    for (int i = 0; i < nPrompts; ++i)
+    {
+        const unsigned long nDuckedBuffers = Pdb::AudioStream::getDuckedBufferCount();
+        const auto startTime = std::chrono::steady_clock::now();
+        Pdb::AudioTask* audioTask = promptAudioManager.play({ *prompt });
+        if (!audioTask || !waitUntil([&] { return Pdb::AudioStream::getDuckedBufferCount() != nDuckedBuffers; }))
+            return benchmark.skip("content was not ducked");
+        benchmark.addSample(std::chrono::steady_clock::now() - startTime);
+        if (!stopPrompt(audioTask) || !waitUntil([&] { return nPlayingOverlays == 0; }))
+            return benchmark.skip("prompt could not be stopped");
+    }
+    contentAudioTask->stop();
+    waitUntil([&] { return contentAudioTask->isAvailable(); });
+}
+
+}
+
+PDB_BENCHMARK("audiomanager_play", playCall);
+PDB_BENCHMARK("prompt_start_latency", promptStartLatency);
+PDB_BENCHMARK("prompt_ducking_latency", promptDuckingLatency);
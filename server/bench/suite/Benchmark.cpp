@@ -0,0 +1,126 @@
+#include "Benchmark.h"
+#include "systems/audio/transcoding/WavFileWriter.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <utility>
+
+namespace Pdb
+{
+
+namespace
+{
+
+std::vector<std::pair<std::string, Benchmark::Function>>& registry()
+{
+    static std::vector<std::pair<std::string, Benchmark::Function>> benchmarks;
+    return benchmarks;
+}
+
+std::string quoted(const std::string& text)
+{
+    std::string result = "\"";
+    for (char character : text)
+    {
+        if (character == '"' || character == '\\') result += '\\';
+        if ((unsigned char)character < 0x20) result += ' ';
+        else result += character;
+    }
+    return result + "\"";
+}
+
+double percentile(const std::vector<double>& sortedValues, double fraction)
+{
+    return sortedValues[std::min(sortedValues.size() - 1, (size_t)(fraction * sortedValues.size()))];
+}
+
+}
+
+bool Benchmark::add(const std::string& name, Function function)
+{
+    registry().emplace_back(name, std::move(function));
+    return true;
+}
+
+std::string Benchmark::runAll(const std::string& filter, const Options& options)
+{
+    auto benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::string results;
+    for (const auto& entry : benchmarks)
+    {
+        if (entry.first.find(filter) == std::string::npos) continue;
+        std::cerr << "Running " << entry.first << "..." << std::endl;
+        Benchmark benchmark(entry.first, options);
+        entry.second(benchmark);
+        if (!benchmark.skipReason_.empty()) std::cerr << "  skipped: " << benchmark.skipReason_ << std::endl;
+        results += (results.empty() ? "\n    " : ",\n    ") + benchmark.toJson();
+    }
+    return "[" + results + "\n  ]";
+}
+
+void Benchmark::measure(size_t nIterations, const std::function<void()>& iteration)
+{
+    for (int i = 0; i < 3; ++i) iteration();
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto minimumDuration = std::chrono::duration<double>(options_.minimumSeconds);
+    for (size_t i = 0; i < nIterations || std::chrono::steady_clock::now() - startTime < minimumDuration; ++i)
+    {
+        const auto iterationStartTime = std::chrono::steady_clock::now();
+        iteration();
+        addSample(std::chrono::steady_clock::now() - iterationStartTime);
+    }
+}
+
+std::string Benchmark::getWavFile(double seconds, unsigned int sampleRate) const
+{
+    const std::string filePath = options_.temporaryDirectory + "/" + std::to_string((int)(seconds * 1000)) + "ms_"
+        + std::to_string(sampleRate) + ".wav";
+    if (boost::filesystem::exists(filePath)) return filePath;
+
+    std::vector<int16_t> samples((size_t)(seconds * sampleRate));
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const double time = (double)i / sampleRate;
+        const double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 4.0 * time);
+        samples[i] = (int16_t)(12000.0 * envelope * std::sin(2.0 * M_PI * 220.0 * time));
+    }
+    WavFileWriter writer;
+    if (!writer.open(filePath, sampleRate, 1) || !writer.write(samples.data(), samples.size()) || !writer.close())
+        std::cerr << "Could not write " << filePath << std::endl;
+    return filePath;
+}
+
+std::string Benchmark::toJson() const
+{
+    std::ostringstream json;
+    json << std::setprecision(6) << "{ \"name\": " << quoted(name_);
+    for (const auto& parameter : parameters_) json << ", " << quoted(parameter.first) << ": " << quoted(parameter.second);
+    if (!skipReason_.empty() || samples_.empty())
+    {
+        json << ", \"skipped\": " << quoted(skipReason_.empty() ? "no samples" : skipReason_) << " }";
+        return json.str();
+    }
+
+    std::vector<double> sortedSamples = samples_;
+    std::sort(sortedSamples.begin(), sortedSamples.end());
+    const double mean = std::accumulate(sortedSamples.begin(), sortedSamples.end(), 0.0) / sortedSamples.size();
+    json << ", \"iterations\": " << sortedSamples.size() << ", \"unit\": \"us\", \"mean\": " << mean
+        << ", \"min\": " << sortedSamples.front() << ", \"p50\": " << percentile(sortedSamples, 0.5)
+        << ", \"p90\": " << percentile(sortedSamples, 0.9) << ", \"p99\": " << percentile(sortedSamples, 0.99)
+        << ", \"max\": " << sortedSamples.back();
+    if (nItemsPerIteration_ > 0.0 && mean > 0.0)
+        json << ", " << quoted(itemName_ + "PerSecond") << ": " << nItemsPerIteration_ * 1e6 / mean;
+    json << " }";
+    return json.str();
+}
+
+}
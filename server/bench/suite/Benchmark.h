@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Pdb
+{
+
+/* A single measurement of pdbBench. Benchmarks register themselves with PDB_BENCHMARK and time their
+   iterations with measure(), results are written as JSON by the runner. */
+class Benchmark
+{
+public:
+    using Function = std::function<void(Benchmark&)>;
+
+    struct Options
+    {
+        std::string promptPath;         /* Mp3 prompt, benchmarks needing it are skipped when it does not exist */
+        std::string temporaryDirectory; /* Generated test files */
+        double minimumSeconds;          /* Per measure() call, after warmup */
+    };
+
+    Benchmark(const std::string& name, const Options& options) : name_(name), options_(options) { }
+
+    static bool add(const std::string& name, Function function);
+    /* Runs benchmarks whose names contain filter, returns the JSON document of their results */
+    static std::string runAll(const std::string& filter, const Options& options);
+
+    const Options& getOptions() const { return options_; }
+
+    /* Calls iteration until at least nIterations were timed and options.minimumSeconds passed,
+       after a few untimed warmup calls. Durations of all timed calls are kept for percentiles. */
+    void measure(size_t nIterations, const std::function<void()>& iteration);
+    /* Work done by one iteration, reported as the processed amount per second (e.g. samples, frames) */
+    void setItemsPerIteration(double nItems, const std::string& itemName) { nItemsPerIteration_ = nItems; itemName_ = itemName; }
+    /* Durations measured by the benchmark itself (e.g. latency to an event on another thread) */
+    void addSample(std::chrono::nanoseconds duration) { samples_.push_back(duration.count() / 1000.0); }
+    void setParameter(const std::string& key, const std::string& value) { parameters_[key] = value; }
+    void skip(const std::string& reason) { skipReason_ = reason; }
+
+    /* Mono 16-bit WAV with a speech-like modulated tone, created in the temporary directory on first use */
+    std::string getWavFile(double seconds, unsigned int sampleRate) const;
+
+private:
+    std::string toJson() const;
+
+    std::string name_;
+    const Options& options_;
+    std::vector<double> samples_;       /* microseconds */
+    double nItemsPerIteration_ = 0.0;
+    std::string itemName_;
+    std::map<std::string, std::string> parameters_;
+    std::string skipReason_;
+};
+
+}
+
+#define PDB_BENCHMARK_CONCAT_(a, b) a##b
+#define PDB_BENCHMARK_CONCAT(a, b) PDB_BENCHMARK_CONCAT_(a, b)
+#define PDB_BENCHMARK(name, function) \
+    static const bool PDB_BENCHMARK_CONCAT(benchmarkRegistered, __LINE__) = Pdb::Benchmark::add(name, function)
@@ -0,0 +1,52 @@
+#include "Benchmark.h"
+#include "systems/audio/Mp3Reader.h"
+#include "systems/audio/WavFileReader.h"
+
+#include <boost/filesystem.hpp>
+
+#include <vector>
+
+namespace
+{
+
+/* Whole file read through a SampleReader into float samples, as the decoded stream and the analyzers do */
+void readWhole(Pdb::Benchmark& benchmark, Pdb::SampleReader& reader, const std::string& filePath)
+{
+    if (!reader.open(filePath))
+    {
+        benchmark.skip("could not open " + filePath);
+        return;
+    }
+    const double nSamples = (double)reader.getFrameCount() * reader.getChannelCount();
+    benchmark.setParameter("file", filePath);
+    benchmark.setParameter("sampleRate", std::to_string(reader.getSampleRate()));
+    benchmark.setItemsPerIteration(nSamples, "samples");
+    reader.close();
+
+    std::vector<float> samples(4096);
+    benchmark.measure(5, [&]
+    {
+        reader.open(filePath);
+        while (reader.read(samples.data(), samples.size()) > 0) { }
+        reader.close();
+    });
+}
+
+void mp3Decoding(Pdb::Benchmark& benchmark)
+{
+    const std::string& promptPath = benchmark.getOptions().promptPath;
+    if (!boost::filesystem::exists(promptPath)) return benchmark.skip(promptPath + " not found");
+    Pdb::Mp3Reader reader;
+    readWhole(benchmark, reader, promptPath);
+}
+
+void wavLoading(Pdb::Benchmark& benchmark)
+{
+    Pdb::WavFileReader reader;
+    readWhole(benchmark, reader, benchmark.getWavFile(60.0, 22050));
+}
+
+}
+
+PDB_BENCHMARK("decode_mp3", mp3Decoding);
+PDB_BENCHMARK("load_wav", wavLoading);
@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+#include "Config.h"
+#include "systems/audio/dsp/DspKernels.h"
+#include "systems/audio/dsp/EffectChain.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+/* One device buffer of a mono 22050 Hz stream (AudioStream bufferFrames_), many per timed iteration so that
+   reading the clock does not dominate */
+const size_t blockSamples = 256;
+const int blocksPerIteration = 64;
+
+std::vector<int16_t> testSamples()
+{
+    std::vector<int16_t> samples(blockSamples);
+    for (size_t i = 0; i < samples.size(); ++i) samples[i] = (int16_t)(12000.0 * std::sin(0.05 * i));
+    return samples;
+}
+
+void int16ToFloat(Pdb::Benchmark& benchmark)
+{
+    const std::vector<int16_t> samples = testSamples();
+    std::vector<float> floatSamples(samples.size());
+    benchmark.setItemsPerIteration(samples.size() * blocksPerIteration, "samples");
+    benchmark.measure(2000, [&]
+    {
+        for (int i = 0; i < blocksPerIteration; ++i) Pdb::DspKernels::int16ToFloat(samples.data(), floatSamples.data(), samples.size());
+    });
+}
+
+void floatToInt16(Pdb::Benchmark& benchmark)
+{
+    const std::vector<int16_t> samples = testSamples();
+    std::vector<float> floatSamples(samples.size());
+    Pdb::DspKernels::int16ToFloat(samples.data(), floatSamples.data(), samples.size());
+    std::vector<int16_t> convertedSamples(samples.size());
+    benchmark.setItemsPerIteration(samples.size() * blocksPerIteration, "samples");
+    benchmark.measure(2000, [&]
+    {
+        for (int i = 0; i < blocksPerIteration; ++i) Pdb::DspKernels::floatToInt16(floatSamples.data(), convertedSamples.data(), samples.size());
+    });
+}
+
+/* Per-sample gain ramp, as applied by ducking and fades. Ramps down and back up, so samples stay in range. */
+void gain(Pdb::Benchmark& benchmark)
+{
+    std::vector<float> samples(blockSamples, 0.5f), downGains(blockSamples), upGains(blockSamples);
+    for (size_t i = 0; i < blockSamples; ++i)
+    {
+        downGains[i] = 1.0f - 0.5f * i / blockSamples;
+        upGains[i] = 1.0f / downGains[i];
+    }
+    benchmark.setItemsPerIteration(samples.size() * blocksPerIteration, "samples");
+    benchmark.measure(2000, [&]
+    {
+        for (int i = 0; i < blocksPerIteration; ++i)
+            Pdb::DspKernels::multiply(samples.data(), (i % 2) ? upGains.data() : downGains.data(), samples.size());
+    });
+}
+
+void peakAndPower(Pdb::Benchmark& benchmark)
+{
+    std::vector<float> samples(blockSamples);
+    for (size_t i = 0; i < samples.size(); ++i) samples[i] = std::sin(0.05f * i);
+    volatile double result = 0.0;
+    benchmark.setItemsPerIteration(samples.size() * blocksPerIteration, "samples");
+    benchmark.measure(2000, [&]
+    {
+        for (int i = 0; i < blocksPerIteration; ++i)
+            result = Pdb::DspKernels::peak(samples.data(), samples.size()) + Pdb::DspKernels::sumOfSquares(samples.data(), samples.size());
+    });
+}
+
+/* Full per-stream chain (voice effects for prompts, then master effects) configured in config.ini */
+void effectChain(Pdb::Benchmark& benchmark)
+{
+    const Pdb::Config& config = Pdb::Config::getInstance();
+    std::unique_ptr<Pdb::EffectChain> chain = Pdb::EffectChain::create(config.voiceEffects, config.masterEffects, 22050, 1);
+    if (!chain) return benchmark.skip("no effects configured");
+    const std::vector<int16_t> input = testSamples();
+    std::vector<int16_t> samples(input.size());
+    benchmark.setItemsPerIteration(samples.size() * blocksPerIteration, "samples");
+    benchmark.measure(500, [&]
+    {
+        for (int i = 0; i < blocksPerIteration; ++i)
+        {
+            samples = input;
+            chain->process(samples.data(), samples.size());
+        }
+    });
+}
+
+}
+
+PDB_BENCHMARK("dsp_int16_to_float", int16ToFloat);
+PDB_BENCHMARK("dsp_float_to_int16", floatToInt16);
+PDB_BENCHMARK("dsp_gain", gain);
+PDB_BENCHMARK("dsp_peak_and_power", peakAndPower);
+PDB_BENCHMARK("dsp_effect_chain", effectChain);
@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+#include "systems/voice/VoiceManager.h"
+
+#include <string>
+#include <utility>
+
+namespace
+{
+
+/* Registers the prompts the apps synthesize (ClockApp: every minute of the day, weekdays, days of months,
+   years; AudiobookApp: one per audiobook) - the files do not need to exist for lookups */
+void addPrompts(Pdb::VoiceManager& voiceManager)
+{
+    auto& tracks = voiceManager.getSynthesizedVoiceAudioTracks();
+    auto add = [&](const std::string& name)
+    {
+        tracks.insert(std::make_pair(name, Pdb::AudioTrack("/nonexistent/" + name + ".mp3", Pdb::AudioTrack::Type::VOICE_MESSAGE)));
+    };
+    for (int hour = 0; hour < 24; ++hour)
+        for (int minute = 0; minute < 60; ++minute) add("time_" + std::to_string(hour) + "_" + std::to_string(minute));
+    for (int weekday = 1; weekday <= 7; ++weekday) add("weekday_" + std::to_string(weekday));
+    for (int month = 1; month <= 12; ++month)
+        for (int day = 1; day <= 31; ++day) add("day_" + std::to_string(day) + "_month_" + std::to_string(month));
+    for (int year = 2000; year < 2100; ++year) add("year_" + std::to_string(year));
+    for (int audiobook = 0; audiobook < 200; ++audiobook) add("audiobook_" + std::to_string(audiobook));
+    for (const char* name : { "choosing_audiobooks", "playing_audiobook", "stopping_audiobook", "unpausing_audiobook" }) add(name);
+}
+
+/* Lookups done by ClockApp to announce the date - names built from numbers, then found in the map */
+void promptLookup(Pdb::Benchmark& benchmark)
+{
+    Pdb::VoiceManager voiceManager;
+    addPrompts(voiceManager);
+    auto& tracks = voiceManager.getSynthesizedVoiceAudioTracks();
+    benchmark.setParameter("prompts", std::to_string(tracks.size()));
+
+    int counter = 0;
+    volatile size_t checksum = 0;
+    benchmark.setItemsPerIteration(100 * 4, "lookups");
+    benchmark.measure(2000, [&]
+    {
+        for (int i = 0; i < 100; ++i, ++counter)
+        {
+            checksum = checksum + tracks.at("weekday_" + std::to_string(counter % 7 + 1)).getTrackName().size()
+                + tracks.at("day_" + std::to_string(counter % 31 + 1) + "_month_" + std::to_string(counter % 12 + 1)).getTrackName().size()
+                + tracks.at("year_" + std::to_string(2000 + counter % 100)).getTrackName().size()
+                + tracks.at("time_" + std::to_string(counter % 24) + "_" + std::to_string(counter % 60)).getTrackName().size();
+        }
+    });
+}
+
+}
+
+PDB_BENCHMARK("prompt_lookup", promptLookup);
@@ -0,0 +1,81 @@
+/* pdbBench - audio engine benchmark suite. Prints (or writes to a file) a JSON document with the results of
+   all benchmarks, so they can be compared between commits and devices.
+   Usage: pdbBench [--filter=<name part>] [--output=<results.json>] [--prompt=<prompt.mp3>] [--min-time=<seconds>] */
+
+#include "Benchmark.h"
+#include "Config.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+bool parseOption(const std::string& argument, const std::string& name, std::string& value)
+{
+    if (argument.compare(0, name.size() + 3, "--" + name + "=") != 0) return false;
+    value = argument.substr(name.size() + 3);
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter, outputPath, minimumSeconds = "0.5";
+    Pdb::Benchmark::Options options;
+    options.promptPath = "../data/synthesized_sounds/apps/audiobook/messages/pl/2x.mp3";
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (!parseOption(argument, "filter", filter) && !parseOption(argument, "output", outputPath)
+            && !parseOption(argument, "prompt", options.promptPath) && !parseOption(argument, "min-time", minimumSeconds))
+        {
+            std::cerr << "Unknown argument: " << argument << std::endl;
+            return 1;
+        }
+    }
+    options.minimumSeconds = std::stod(minimumSeconds);
+    options.temporaryDirectory = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pdbBench-%%%%%%")).string();
+    boost::filesystem::create_directories(options.temporaryDirectory);
+
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::warning);
+    Pdb::Config config = Pdb::Config::getInstance();
+    config.audioBackend = Pdb::AudioBackend::NULL_OUTPUT;
+    config.skipSilence = false;
+    config.loudnessNormalization = false;
+    Pdb::Config::publish(config);
+
+    const std::string results = Pdb::Benchmark::runAll(filter, options);
+    boost::filesystem::remove_all(options.temporaryDirectory);
+
+    char timestamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    const std::string document = std::string("{\n  \"suite\": \"pdbBench\",\n  \"timestamp\": \"") + timestamp
+        + "\",\n  \"instructionSet\": \"" + Pdb::DspKernels::getInstructionSetName()
+        + "\",\n  \"hardwareThreads\": " + std::to_string(std::thread::hardware_concurrency())
+        + ",\n  \"results\": " + results + "\n}\n";
+
+    if (outputPath.empty()) std::cout << document;
+    else
+    {
+        std::ofstream output(outputPath);
+        output << document;
+        if (!output)
+        {
+            std::cerr << "Could not write " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
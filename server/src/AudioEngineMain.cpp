@@ -0,0 +1,77 @@
+/* pdbAudioEngine - out-of-process audio engine (AudioEngine.backend = remote), started and supervised by pdbServer.
+   Usage: pdbAudioEngine [--backend=rtaudio|null] [--memory=/pdb_audio_engine] */
+
+#include "Config.h"
+#include "systems/audio/engine/AudioEngine.h"
+
+#include "boost/log/trivial.hpp"
+#include "boost/log/utility/setup.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <sched.h>
+#include <sys/mman.h>
+
+int main(int argc, char* argv[])
+{
+    Pdb::Config config = Pdb::Config::getInstance();
+    std::string memoryName = "/pdb_audio_engine";
+    config.audioBackend = config.remoteEngineBackend;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        try
+        {
+            if (argument.compare(0, 10, "--backend=") == 0) config.audioBackend = Pdb::Config::parseAudioBackend(argument.substr(10));
+            else if (argument.compare(0, 9, "--memory=") == 0) memoryName = argument.substr(9);
+        }
+        catch (std::exception& e)
+        {
+            BOOST_LOG_TRIVIAL(error) << e.what();
+            return 1;
+        }
+    }
+    if (config.audioBackend == Pdb::AudioBackend::REMOTE)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Audio engine cannot use the remote backend itself.";
+        return 1;
+    }
+    Pdb::Config::publish(config);
+
+    boost::log::register_simple_formatter_factory<boost::log::trivial::severity_level, char>("Severity");
+    boost::log::add_console_log(
+        std::cout,
+        boost::log::keywords::format = "[%TimeStamp%][%Severity%][engine] %Message%",
+        boost::log::keywords::auto_flush = true
+    );
+    boost::log::add_common_attributes();
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+
+    /* Device callback threads inherit the scheduling of the thread creating them, page faults must not stall them */
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        BOOST_LOG_TRIVIAL(warning) << "Could not lock audio engine memory: " << std::strerror(errno);
+    sched_param parameters {};
+    parameters.sched_priority = config.remoteEnginePriority;
+    if (sched_setscheduler(0, SCHED_FIFO, &parameters) != 0)
+        BOOST_LOG_TRIVIAL(warning) << "Could not switch audio engine to real-time scheduling: " << std::strerror(errno);
+
+    std::unique_ptr<Pdb::SharedAudioMemory> memory;
+    for (int attempt = 0; attempt < 100 && !memory; ++attempt)
+    {
+        memory = Pdb::SharedAudioMemory::attach(memoryName);
+        if (!memory) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (!memory)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not attach shared memory " << memoryName << ".";
+        return 1;
+    }
+
+    BOOST_LOG_TRIVIAL(info) << "Audio engine running, backend: " << Pdb::Config::getAudioBackendName(config.audioBackend);
+    Pdb::AudioEngine engine(std::move(memory));
+    engine.run();
+    return 0;
+}
@@ -1,26 +1,245 @@
 #include "Config.h"
 #include <boost/log/trivial.hpp>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <boost/algorithm/string.hpp>
 
 namespace Pdb
 {
 
-Config::Config()
+namespace
+{
+	struct Subscription
+	{
+		Config::SubscriptionId id;
+		Executor* executor;
+		Config::ReloadHandler handler;
+	};
+
+	/* Snapshots published so far (never freed) and subscribers to new ones */
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<const Config>> snapshots;
+		std::vector<Subscription> subscriptions;
+		Config::SubscriptionId nextSubscriptionId = 0;
+	};
+
+	Registry& registry()
+	{
+		static Registry* instance = new Registry();
+		return *instance;
+	}
+
+	const std::vector<std::pair<std::string, AudioBackend>> audioBackends {
+		{ "rtaudio", AudioBackend::RTAUDIO }, { "null", AudioBackend::NULL_OUTPUT }, { "remote", AudioBackend::REMOTE } };
+	const std::vector<std::pair<std::string, AudioSchedulingRule>> schedulingRules {
+		{ "preempt", AudioSchedulingRule::PREEMPT }, { "queue", AudioSchedulingRule::QUEUE }, { "drop", AudioSchedulingRule::DROP } };
+}
+
+const Config& Config::loadFirst()
+{
+	static std::once_flag loaded;
+	std::call_once(loaded, []
+	{
+		try
+		{
+			publish(Config("../config.ini"));
+		}
+		catch (std::exception& e)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Config: " << e.what();
+			exit(0);
+		}
+	});
+	return *current_.load(std::memory_order_acquire);
+}
+
+bool Config::reload(const std::string& filePath)
 {
 	try
 	{
-		boost::property_tree::read_ini("../config.ini", pt_);
+		publish(Config(filePath));
 	}
-	catch (std::exception &e)
+	catch (std::exception& e)
 	{
-		BOOST_LOG_TRIVIAL(error) << e.what();
+		BOOST_LOG_TRIVIAL(error) << "Config: " << e.what() << " - keeping the current config.";
+		return false;
 	}
-	
-	loggingLevel = pt_.get<std::string>("General.loggingLevel");
-	inputMode = pt_.get<std::string>("General.inputMode");
+	BOOST_LOG_TRIVIAL(info) << "Reloaded config from " << filePath << ".";
+	return true;
+}
+
+void Config::publish(const Config& config)
+{
+	Registry& registry = Pdb::registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	const Config* previous = current_.load(std::memory_order_relaxed);
+	registry.snapshots.push_back(std::make_unique<const Config>(config));
+	const Config* current = registry.snapshots.back().get();
+	current_.store(current, std::memory_order_release);
+
+	if (!previous) return;
+	for (Subscription& subscription : registry.subscriptions)
+	{
+		ReloadHandler handler = subscription.handler;
+		subscription.executor->post([handler, previous, current] { handler(*previous, *current); });
+	}
+}
+
+Config::SubscriptionId Config::subscribe(Executor& executor, ReloadHandler handler)
+{
+	Registry& registry = Pdb::registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.subscriptions.push_back(Subscription { registry.nextSubscriptionId, &executor, std::move(handler) });
+	return registry.nextSubscriptionId++;
+}
+
+void Config::unsubscribe(SubscriptionId subscriptionId)
+{
+	Registry& registry = Pdb::registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.subscriptions.erase(std::remove_if(registry.subscriptions.begin(), registry.subscriptions.end(),
+		[subscriptionId](const Subscription& subscription) { return subscription.id == subscriptionId; }), registry.subscriptions.end());
+}
+
+const char* Config::getAudioBackendName(AudioBackend backend)
+{
+	for (const auto& value : audioBackends)
+		if (value.second == backend) return value.first.c_str();
+	return "unknown";
+}
+
+AudioBackend Config::parseAudioBackend(const std::string& name)
+{
+	for (const auto& value : audioBackends)
+		if (value.first == name) return value.second;
+	throw std::invalid_argument(name + " is a wrong audio backend (expected rtaudio, null or remote).");
+}
+
+template <typename Enum>
+Enum Config::readEnum(const std::string& key, const std::string& defaultValue, const std::vector<std::pair<std::string, Enum>>& values)
+{
+	const std::string name = pt_.get<std::string>(key, defaultValue);
+	std::string expected;
+	for (const auto& value : values)
+	{
+		if (value.first == name) return value.second;
+		expected += (expected.empty() ? "" : ", ") + value.first;
+	}
+	throw std::invalid_argument(name + " is a wrong " + key + " value (expected " + expected + ").");
+}
+
+Config::Config(const std::string& filePath)
+{
+	boost::property_tree::read_ini(filePath, pt_);
+
+	loggingLevel = readEnum<boost::log::trivial::severity_level>("General.loggingLevel", "", {
+		{ "info", boost::log::trivial::info }, { "debug", boost::log::trivial::debug }, { "trace", boost::log::trivial::trace } });
+	inputMode = readEnum<InputMode>("General.inputMode", "", { { "debug", InputMode::DEBUG }, { "prod", InputMode::PROD } });
+	inputBackend = readEnum<InputBackendType>("General.inputBackend", "evdev", {
+		{ "evdev", InputBackendType::EVDEV }, { "gainput", InputBackendType::GAINPUT } });
+	inputPollMilliseconds = pt_.get<int>("General.inputPollMilliseconds", 10);
+	timerResolutionMilliseconds = pt_.get<int>("General.timerResolutionMilliseconds", 10);
+	inputCoalescingMilliseconds = pt_.get<int>("General.inputCoalescingMilliseconds", 250);
+	startupThreads = pt_.get<int>("General.startupThreads", 3);
 	volumeForAwsSynthesized = pt_.get<float>("SynthesizedAudio.volume");
 	volumeForAudiobooks = pt_.get<float>("AudiobookAudio.volume");
+	duckingGain = pt_.get<float>("AudiobookAudio.duckingGain", 0.35f);
+	duckingRampMilliseconds = pt_.get<int>("AudiobookAudio.duckingRampMilliseconds", 80);
+	promptOverlay = pt_.get<bool>("AudiobookAudio.promptOverlay", true);
+	pausedTimeoutMinutes = pt_.get<int>("AudiobookAudio.pausedTimeoutMinutes", 30);
+	scrubPreviewMilliseconds = pt_.get<int>("AudiobookAudio.scrubPreviewMilliseconds", 400);
+	scrubPreviewIntervalMilliseconds = pt_.get<int>("AudiobookAudio.scrubPreviewIntervalMilliseconds", 1500);
 	masterVolume = pt_.get<float>("MasterVolume.masterVolume");
+	audioBackend = readEnum("AudioEngine.backend", "rtaudio", audioBackends);
+	nullAudioBackendRealtime = pt_.get<bool>("AudioEngine.nullBackendRealtime", true);
+	audioSequencerThreads = pt_.get<int>("AudioEngine.sequencerThreads", 2);
+	alertSchedulingRule = readEnum("AudioScheduler.alert", "preempt", schedulingRules);
+	navigationSchedulingRule = readEnum("AudioScheduler.navigation", "preempt", schedulingRules);
+	contentSchedulingRule = readEnum("AudioScheduler.content", "preempt", schedulingRules);
+	voiceEffects = readEffectChainConfig("VoiceEffects");
+	audiobookEffects = readEffectChainConfig("AudiobookEffects");
+	masterEffects = readEffectChainConfig("MasterEffects");
+	dspBudgetPercent = pt_.get<float>("AudioEngine.dspBudgetPercent", 25.0f);
+	remoteEngineBackend = readEnum("AudioEngine.remoteEngineBackend", "rtaudio", audioBackends);
+	remoteEnginePath = pt_.get<std::string>("AudioEngine.remoteEnginePath", "./pdbAudioEngine");
+	remoteEngineSpawn = pt_.get<bool>("AudioEngine.remoteEngineSpawn", true);
+	remoteEnginePriority = pt_.get<int>("AudioEngine.remoteEnginePriority", 70);
+	remoteRingMilliseconds = pt_.get<int>("AudioEngine.remoteRingMilliseconds", 200);
+	loudnessNormalization = pt_.get<bool>("Loudness.normalization", true);
+	targetLoudness = pt_.get<float>("Loudness.targetLoudness", -18.0f);
+	maxNormalizationGainDb = pt_.get<float>("Loudness.maxGainDb", 12.0f);
+	silenceThresholdDb = pt_.get<float>("Silence.thresholdDb", -45.0f);
+	skipSilence = pt_.get<bool>("Silence.skipSilence", false);
+	skipSilenceMinMilliseconds = pt_.get<int>("Silence.skipSilenceMinMilliseconds", 700);
+	skipSilenceKeepMilliseconds = pt_.get<int>("Silence.skipSilenceKeepMilliseconds", 300);
+	snapSeekToSpeech = pt_.get<bool>("Silence.snapSeekToSpeech", true);
+	snapSeekWindowMilliseconds = pt_.get<int>("Silence.snapSeekWindowMilliseconds", 2000);
+	transcodingEnabled = pt_.get<bool>("Transcoding.enabled", false);
+	transcodingSampleRate = pt_.get<int>("Transcoding.sampleRate", 22050);
+	keepOriginals = pt_.get<bool>("Transcoding.keepOriginals", true);
+	audioThreadRole = readThreadRoleConfig("audio", "other");
+	decodeThreadRole = readThreadRoleConfig("decode", "other");
+	appThreadRole = readThreadRoleConfig("app", "other");
+	backgroundThreadRole = readThreadRoleConfig("background", "idle");
+
+	builtInApps = readList("Apps.builtIn", "network,audiobook,clock");
+	for (const std::string& plugin : readList("Apps.plugins", "")) appPlugins.push_back(readAppPluginConfig(plugin));
+	appPluginIdleMinutes = pt_.get<int>("Apps.pluginIdleMinutes", 10);
+}
+
+EffectChainConfig Config::readEffectChainConfig(const std::string& section)
+{
+	EffectChainConfig config;
+	std::string effects = pt_.get<std::string>(section + ".effects", "");
+	boost::algorithm::split(config.effects, effects, boost::algorithm::is_any_of(","));
+	for (std::string& effect : config.effects) boost::algorithm::trim(effect);
+	config.effects.erase(std::remove(config.effects.begin(), config.effects.end(), ""), config.effects.end());
+
+	config.highPassFrequency = pt_.get<float>(section + ".highPassFrequency", 100.0f);
+	config.eqFrequency = pt_.get<float>(section + ".eqFrequency", 3000.0f);
+	config.eqGainDb = pt_.get<float>(section + ".eqGainDb", 0.0f);
+	config.eqQ = pt_.get<float>(section + ".eqQ", 1.0f);
+	config.compressorThresholdDb = pt_.get<float>(section + ".compressorThresholdDb", -20.0f);
+	config.compressorRatio = pt_.get<float>(section + ".compressorRatio", 3.0f);
+	config.compressorAttackMilliseconds = pt_.get<float>(section + ".compressorAttackMilliseconds", 5.0f);
+	config.compressorReleaseMilliseconds = pt_.get<float>(section + ".compressorReleaseMilliseconds", 100.0f);
+	config.compressorMakeupGainDb = pt_.get<float>(section + ".compressorMakeupGainDb", 0.0f);
+	config.limiterThresholdDb = pt_.get<float>(section + ".limiterThresholdDb", -1.0f);
+	config.limiterReleaseMilliseconds = pt_.get<float>(section + ".limiterReleaseMilliseconds", 50.0f);
+	return config;
+}
+
+ThreadRoleConfig Config::readThreadRoleConfig(const std::string& role, const std::string& defaultScheduling)
+{
+	ThreadRoleConfig config;
+	config.cpus = pt_.get<std::string>("Threads." + role + "Cpus", "");
+	config.scheduling = pt_.get<std::string>("Threads." + role + "Scheduling", defaultScheduling);
+	config.priority = pt_.get<int>("Threads." + role + "Priority", 0);
+	return config;
+}
+
+AppPluginConfig Config::readAppPluginConfig(const std::string& name)
+{
+	AppPluginConfig config;
+	config.name = name;
+	config.path = pt_.get<std::string>("Apps." + name + "Path", "./plugins/libpdb_" + name + ".so");
+	config.wakeButtons = readList("Apps." + name + "WakeButtons", "");
+	return config;
+}
+
+std::vector<std::string> Config::readList(const std::string& key, const std::string& defaultValue)
+{
+	std::vector<std::string> list;
+	std::string value = pt_.get<std::string>(key, defaultValue);
+	boost::algorithm::split(list, value, boost::algorithm::is_any_of(","));
+	for (std::string& element : list) boost::algorithm::trim(element);
+	list.erase(std::remove(list.begin(), list.end(), ""), list.end());
+	return list;
 }
 
 
@@ -1,35 +1,159 @@
 #pragma once
+#include "systems/executor/Executor.h"
+
+#include <boost/log/trivial.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace Pdb
 {
 
 using boost::property_tree::ptree;
 
+/* Effects applied in the listed order, e.g. "highpass, eq, compressor, limiter" - empty means bypass */
+struct EffectChainConfig
+{
+    std::vector<std::string> effects;
+    float highPassFrequency;
+    float eqFrequency;
+    float eqGainDb;
+    float eqQ;
+    float compressorThresholdDb;
+    float compressorRatio;
+    float compressorAttackMilliseconds;
+    float compressorReleaseMilliseconds;
+    float compressorMakeupGainDb;
+    float limiterThresholdDb;
+    float limiterReleaseMilliseconds;
+};
+
+/* CPU affinity and scheduling of the threads of one role (see ThreadRole) */
+struct ThreadRoleConfig
+{
+    std::string cpus;           /* e.g. "3" or "0-1,3", empty for all */
+    std::string scheduling;     /* other, batch, idle, fifo or rr */
+    int priority;               /* 1-99 for fifo and rr, nice value otherwise */
+};
+
+enum class InputMode { DEBUG, PROD };
+enum class InputBackendType { EVDEV, GAINPUT };
+enum class AudioBackend { RTAUDIO, NULL_OUTPUT, REMOTE };
+/* What a sound of a priority does to the one playing (see AudioScheduler) */
+enum class AudioSchedulingRule { PREEMPT, QUEUE, DROP };
+
+/* App loaded from a shared object when one of its wake buttons is pressed (any button when none are listed) */
+struct AppPluginConfig
+{
+    std::string name;
+    std::string path;                       /* e.g. ./plugins/libpdbClockApp.so */
+    std::vector<std::string> wakeButtons;   /* InputManager::Button names, e.g. BUTTON_R */
+};
+
+/* Immutable snapshot of config.ini, parsed into typed values. The current snapshot is published through an atomic
+   pointer, so reading it costs one atomic load - hot paths may call getInstance() every time. Snapshots are never
+   freed (there is one per reload), references to them stay valid. */
 class Config
 {
 public:
-    static Config& getInstance()
+    using SubscriptionId = unsigned int;
+    /* previous and current snapshots, e.g. to act only on what changed */
+    using ReloadHandler = std::function<void(const Config& previous, const Config& current)>;
+
+    /* Current snapshot, ../config.ini is parsed on the first call (exits when it is invalid) */
+    static const Config& getInstance()
     {
-        static Config* instance = new Config();
-        return *instance;
+        const Config* config = current_.load(std::memory_order_acquire);
+        return config ? *config : loadFirst();
     }
+    /* Parses filePath into a new snapshot and publishes it. An invalid file is logged and the current snapshot kept. */
+    static bool reload(const std::string& filePath = "../config.ini");
+    /* Publishes a modified copy of a snapshot (e.g. overrides of command line arguments and benchmarks) */
+    static void publish(const Config& config);
+
+    /* Handler runs on executor after each published snapshot */
+    static SubscriptionId subscribe(Executor& executor, ReloadHandler handler);
+    static void unsubscribe(SubscriptionId subscriptionId);
+
+    static const char* getAudioBackendName(AudioBackend backend);
+    /* Throws std::invalid_argument for unknown names */
+    static AudioBackend parseAudioBackend(const std::string& name);
+
+    Config(const Config& config) = default;
 
 private:
-    Config();
+    /* Throws on an unreadable file and on wrong values */
+    explicit Config(const std::string& filePath);
+    static const Config& loadFirst();
+
+    template <typename Enum>
+    Enum readEnum(const std::string& key, const std::string& defaultValue, const std::vector<std::pair<std::string, Enum>>& values);
+
+    EffectChainConfig readEffectChainConfig(const std::string& section);
+    ThreadRoleConfig readThreadRoleConfig(const std::string& role, const std::string& defaultScheduling);
+    AppPluginConfig readAppPluginConfig(const std::string& name);
+    std::vector<std::string> readList(const std::string& key, const std::string& defaultValue);
 
 public:
-    std::string loggingLevel;
-    std::string inputMode;
+    boost::log::trivial::severity_level loggingLevel;
+    InputMode inputMode;
+    InputBackendType inputBackend;
+    int inputPollMilliseconds;
+    int timerResolutionMilliseconds;
+    int inputCoalescingMilliseconds;
+    int startupThreads;
     float volumeForAwsSynthesized;
     float volumeForAudiobooks;
+    float duckingGain;
+    int duckingRampMilliseconds;
+    bool promptOverlay;
+    int pausedTimeoutMinutes;
+    int scrubPreviewMilliseconds;
+    int scrubPreviewIntervalMilliseconds;
     float masterVolume;
+    AudioBackend audioBackend;
+    bool nullAudioBackendRealtime;
+    int audioSequencerThreads;
+    AudioSchedulingRule alertSchedulingRule;
+    AudioSchedulingRule navigationSchedulingRule;
+    AudioSchedulingRule contentSchedulingRule;
+    EffectChainConfig voiceEffects;
+    EffectChainConfig audiobookEffects;
+    EffectChainConfig masterEffects;
+    float dspBudgetPercent;
+    AudioBackend remoteEngineBackend;
+    std::string remoteEnginePath;
+    bool remoteEngineSpawn;
+    int remoteEnginePriority;
+    int remoteRingMilliseconds;
+    bool loudnessNormalization;
+    float targetLoudness;
+    float maxNormalizationGainDb;
+    float silenceThresholdDb;
+    bool skipSilence;
+    int skipSilenceMinMilliseconds;
+    int skipSilenceKeepMilliseconds;
+    bool snapSeekToSpeech;
+    int snapSeekWindowMilliseconds;
+    bool transcodingEnabled;
+    int transcodingSampleRate;
+    bool keepOriginals;
+    ThreadRoleConfig audioThreadRole;
+    ThreadRoleConfig decodeThreadRole;
+    ThreadRoleConfig appThreadRole;
+    ThreadRoleConfig backgroundThreadRole;
+    std::vector<std::string> builtInApps;       /* Apps compiled into the server and created at startup */
+    std::vector<AppPluginConfig> appPlugins;
+    int appPluginIdleMinutes;                   /* Unloading plugins not used for that long, 0 keeps them loaded */
 
 private:
     ptree pt_;
+
+    inline static std::atomic<const Config*> current_ { nullptr };
 };
 
 }
\ No newline at end of file
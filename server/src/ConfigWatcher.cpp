@@ -0,0 +1,67 @@
+#include "ConfigWatcher.h"
+#include "Config.h"
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace Pdb
+{
+
+namespace
+{
+    const auto reloadDelay = std::chrono::milliseconds(200);
+}
+
+ConfigWatcher::ConfigWatcher(EventLoop& eventLoop, TimerWheel& timerWheel, const std::string& filePath)
+    : eventLoop_(eventLoop), timerWheel_(timerWheel), filePath_(filePath), sourceId_(0), reloadTimerId_(0)
+{
+    const boost::filesystem::path path(filePath);
+    fileName_ = path.filename().string();
+    const std::string directory = path.has_parent_path() ? path.parent_path().string() : ".";
+
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0 || inotify_add_watch(inotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Could not watch " << filePath << " (" << std::strerror(errno) << "), the config will not be reloaded.";
+        return;
+    }
+    sourceId_ = eventLoop_.addFileDescriptor(inotifyFd_, EPOLLIN, [this](uint32_t) { onEvents(); });
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+    if (reloadTimerId_) timerWheel_.cancel(reloadTimerId_);
+    if (sourceId_) eventLoop_.remove(sourceId_);
+    if (inotifyFd_ >= 0) close(inotifyFd_);
+}
+
+void ConfigWatcher::onEvents()
+{
+    alignas(inotify_event) char buffer[4096];
+    bool isConfigChanged = false;
+    ssize_t nRead;
+    while ((nRead = read(inotifyFd_, buffer, sizeof(buffer))) > 0)
+    {
+        for (char* event = buffer; event < buffer + nRead; )
+        {
+            const inotify_event* inotifyEvent = reinterpret_cast<const inotify_event*>(event);
+            if (inotifyEvent->len > 0 && fileName_ == inotifyEvent->name) isConfigChanged = true;
+            event += sizeof(inotify_event) + inotifyEvent->len;
+        }
+    }
+    if (!isConfigChanged) return;
+
+    if (reloadTimerId_) timerWheel_.cancel(reloadTimerId_);
+    reloadTimerId_ = timerWheel_.schedule(reloadDelay, std::chrono::milliseconds(0), eventLoop_, [this]
+    {
+        reloadTimerId_ = 0;
+        Config::reload(filePath_);
+    });
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "systems/executor/EventLoop.h"
+#include "systems/executor/TimerWheel.h"
+
+#include <string>
+
+namespace Pdb
+{
+
+/* Reloads the config (Config::reload) when its file is written, renamed over or created - editors save in any of
+   these ways, so the directory is watched (inotify) rather than the file. Saves in quick succession are reloaded
+   once, after a short quiet time. Runs on the event loop thread. */
+class ConfigWatcher
+{
+public:
+    ConfigWatcher(EventLoop& eventLoop, TimerWheel& timerWheel, const std::string& filePath = "../config.ini");
+    ~ConfigWatcher();
+
+private:
+    void onEvents();
+
+    EventLoop& eventLoop_;
+    TimerWheel& timerWheel_;
+    std::string filePath_;
+    std::string fileName_;
+    int inotifyFd_;
+    EventLoop::SourceId sourceId_;
+    TimerWheel::TimerId reloadTimerId_;
+};
+
+}
@@ -1,23 +1,117 @@
 #include "Server.h"
-#include <thread>
-#include <chrono>
+#include "Config.h"
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
 
 namespace Pdb
 {
 
-void Server::registerApp(const std::string& name, std::unique_ptr<App> app)
+namespace
+{
+
+sigset_t terminationSignals()
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    return signals;
+}
+
+}
+
+void Server::blockTerminationSignals()
+{
+    const sigset_t signals = terminationSignals();
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+}
+
+Server::Server() : timerWheel_(eventLoop_, std::chrono::milliseconds(Config::getInstance().timerResolutionMilliseconds)),
+    inputService_(eventLoop_), configWatcher_(eventLoop_, timerWheel_)
+{
+    configSubscriptionId_ = Config::subscribe(eventLoop_, [this](const Config& previous, const Config& current) { onConfigReloaded(previous, current); });
+    const sigset_t signals = terminationSignals();
+    signalFd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd_ < 0) BOOST_LOG_TRIVIAL(error) << "Could not create signalfd, SIGINT and SIGTERM will not shut down gracefully.";
+    else eventLoop_.addFileDescriptor(signalFd_, EPOLLIN, [this](uint32_t) { onSignal(); });
+}
+
+Server::~Server()
+{
+    Config::unsubscribe(configSubscriptionId_);
+    if (signalFd_ >= 0) close(signalFd_);
+}
+
+void Server::registerApp(const std::string& name, std::unique_ptr<App> app, const std::vector<std::string>& dependencies)
 {
     app->setName(name);
+    appStarter_.add(*app, dependencies);
     apps_.insert(std::make_pair(name, std::move(app)));
 }
 
+void Server::registerAppPlugin(const AppPluginConfig& config)
+{
+    appPlugins_.push_back(std::make_unique<AppPlugin>(config, voiceManager_, audioScheduler_, eventLoop_, timerWheel_, inputService_));
+}
+
 void Server::run()
 {
-    /* Firstly we start all registered applications (threads) */
-    for (auto& app : apps_) app.second->start();
+    /* Firstly we start all registered applications, in parallel on startup threads - input is handled by each app
+       as soon as it is ready, while the event loop already runs */
+    appStarter_.start(Config::getInstance().startupThreads);
+    for (auto& appPlugin : appPlugins_) appPlugin->start();
+
+    /* And then the main thread sleeps until an event (signal, timer, registered descriptor) arrives */
+    BOOST_LOG_TRIVIAL(info) << "Server running.";
+    eventLoop_.run();
+
+    shutdown();
+}
+
+void Server::onSignal()
+{
+    signalfd_siginfo signalInfo;
+    while (read(signalFd_, &signalInfo, sizeof(signalInfo)) == sizeof(signalInfo))
+    {
+        BOOST_LOG_TRIVIAL(info) << "Received " << (signalInfo.ssi_signo == SIGINT ? "SIGINT" : "SIGTERM") << ", shutting down.";
+        eventLoop_.stop();
+    }
+}
+
+void Server::onConfigReloaded(const Config& previous, const Config& current)
+{
+    if (current.loggingLevel != previous.loggingLevel)
+        boost::log::core::get()->set_filter(boost::log::trivial::severity >= current.loggingLevel);
+}
+
+void Server::shutdown()
+{
+    /* Apps still initializing finish first, the ones never started are skipped by stop() */
+    appStarter_.cancel();
+    BOOST_LOG_TRIVIAL(info) << appStarter_.getReadyCount() << " of " << apps_.size() << " apps were started, "
+        << appStarter_.getInitializedCount() << " fully initialized.";
 
-    /* And then, for now, main loops infinitely waits here */
-    while(true);
+    /* Apps end their loops, save their state (e.g. audiobook positions) and stop their audio */
+    for (auto& app : apps_)
+    {
+        BOOST_LOG_TRIVIAL(info) << "Stopping app: " << app.first;
+        app.second->stop();
+    }
+    for (auto& appPlugin : appPlugins_)
+    {
+        BOOST_LOG_TRIVIAL(info) << "Stopping app plugin: " << appPlugin->getName() << " (loaded " << appPlugin->getLoadCount() << " times)";
+        appPlugin->stop();
+    }
+    audioScheduler_.printStats();
+    inputService_.printStats();
+    BOOST_LOG_TRIVIAL(info) << "Server stopped.";
+    boost::log::core::get()->flush();
 }
 
-}
\ No newline at end of file
+}
@@ -2,11 +2,18 @@
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "ConfigWatcher.h"
 #include "apps/App.h"
-#include "systems/input/InputManager.h"
+#include "apps/AppPlugin.h"
+#include "apps/AppStarter.h"
+#include "systems/input/InputService.h"
 #include "systems/audio/AudioManager.h"
 #include "systems/voice/VoiceManager.h"
+#include "systems/audio/AudioScheduler.h"
+#include "systems/executor/EventLoop.h"
+#include "systems/executor/TimerWheel.h"
 
 namespace Pdb
 {
@@ -14,15 +21,50 @@ namespace Pdb
 class Server
 {
 public:
-    void registerApp(const std::string& name, std::unique_ptr<App> app);
+    /* To be called first in main, before any thread is started - threads inherit the signal mask,
+       so SIGINT and SIGTERM are then received only by the server's event loop (signalfd) */
+    static void blockTerminationSignals();
+
+    Server();
+    ~Server();
+
+    /* The app is started once the apps it depends on (their names) are ready */
+    void registerApp(const std::string& name, std::unique_ptr<App> app, const std::vector<std::string>& dependencies = {});
+    /* App loaded from a shared object on first use, see AppPlugin */
+    void registerAppPlugin(const AppPluginConfig& config);
+    /* Starts the apps in parallel and runs the event loop until SIGINT, SIGTERM or stop(), then shuts everything down */
     void run();
+    void stop() { eventLoop_.stop(); }
 
     VoiceManager& getVoiceManager() { return voiceManager_; }
+    AudioScheduler& getAudioScheduler() { return audioScheduler_; }
+    /* Timers and file descriptors of apps and subsystems, handlers run on the server thread */
+    EventLoop& getEventLoop() { return eventLoop_; }
+    /* One-shot and periodic timers of apps, no feature needs its own sleeping thread */
+    TimerWheel& getTimerWheel() { return timerWheel_; }
+    InputService& getInputService() { return inputService_; }
 
 private:
-    std::unordered_map< std::string, std::unique_ptr<App> > apps_;
+    void onSignal();
+    void shutdown();
+    /* Log severity of a reloaded config */
+    void onConfigReloaded(const Config& previous, const Config& current);
 
+    EventLoop eventLoop_;
+    int signalFd_;
+
+    /* Declared before the apps, which use them until destroyed */
+    TimerWheel timerWheel_;
+    InputService inputService_;
     VoiceManager voiceManager_;
+    AudioScheduler audioScheduler_;
+    ConfigWatcher configWatcher_;
+    Config::SubscriptionId configSubscriptionId_;
+
+    std::unordered_map< std::string, std::unique_ptr<App> > apps_;
+    /* Declared after the apps, destroyed before them - its startup jobs use them */
+    AppStarter appStarter_;
+    std::vector< std::unique_ptr<AppPlugin> > appPlugins_;
 };
 
-}
\ No newline at end of file
+}
@@ -1,10 +1,14 @@
 #include "App.h"
+#include "systems/executor/ThreadRole.h"
+#include <boost/log/trivial.hpp>
 
 namespace Pdb
 {
 
-App::App(VoiceManager& voiceManager)
-    : voiceManager_(voiceManager)
+App::App(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService)
+    : running_(false), state_(State::CREATED), initCancelled_(false), inputSubscriptionId_(0), configSubscriptionId_(0),
+    audioManager_(audioScheduler.getPlayingOverlayCount()), inputService_(inputService), voiceManager_(voiceManager),
+    audioScheduler_(audioScheduler), eventLoop_(eventLoop), timerWheel_(timerWheel)
 {
 
 }
@@ -17,7 +21,51 @@ App::~App()
 void App::start()
 {
     init();
-    thread_ = std::thread(&App::appLoopFunction, this);
+    running_ = true;
+    inputSubscriptionId_ = inputService_.subscribe(executor_, [this](InputManager::Button button) { onButtonPressed(button); });
+    configSubscriptionId_ = Config::subscribe(executor_, [this](const Config& previous, const Config& current)
+    {
+        if (current.masterVolume != previous.masterVolume) audioManager_.setMasterVolume(current.masterVolume);
+        onConfigReloaded(previous, current);
+    });
+    thread_ = std::thread([this]
+    {
+        setUpCurrentThread(ThreadRole::APP, "app-" + name_);
+        appLoopFunction();
+    });
+    state_ = State::READY;
+}
+
+void App::completeInit()
+{
+    lateInit();
+    state_ = State::INITIALIZED;
+}
+
+void App::stop()
+{
+    if (state_ == State::CREATED) return;
+    inputService_.unsubscribe(inputSubscriptionId_);
+    Config::unsubscribe(configSubscriptionId_);
+    running_ = false;
+    executor_.post([] { });     /* Wakes the loop up */
+    if (thread_.joinable()) thread_.join();
+    deinit();
+    for (auto priority : { AudioScheduler::Priority::ALERT, AudioScheduler::Priority::NAVIGATION, AudioScheduler::Priority::CONTENT })
+        audioScheduler_.stop(audioManager_, priority);
+}
+
+bool App::isPlaying() const
+{
+    return audioManager_.getFreeMp3AudioStreamCount() < (int)audioManager_.getMp3AudioStreamCount()
+        || audioManager_.getFreeDecodedAudioStreamCount() < (int)audioManager_.getDecodedAudioStreamCount();
+}
+
+void App::appLoopFunction()
+{
+    BOOST_LOG_TRIVIAL(info) << "Starting " << name_ << " app loop.";
+    while (isRunning()) executor_.waitAndRunPending(std::chrono::seconds(1));
+    BOOST_LOG_TRIVIAL(info) << "Ending " << name_ << " app loop.";
 }
 
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #pragma once
 
+#include "Config.h"
 #include "systems/audio/AudioManager.h"
-#include "systems/input/InputManager.h"
+#include "systems/audio/AudioScheduler.h"
+#include "systems/input/InputService.h"
 #include "systems/voice/VoiceManager.h"
+#include "systems/executor/RunLoopExecutor.h"
+#include "systems/executor/EventLoop.h"
+#include "systems/executor/TimerWheel.h"
+#include <atomic>
 #include <thread>
 #include <string>
 
@@ -12,22 +18,63 @@ namespace Pdb
 class App
 {
 public:
-    App(VoiceManager& voiceManager);
+    App(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService);
     virtual ~App();
+
+    /* CREATED -> READY (usable: the app loop runs and input is handled) -> INITIALIZED (late resources too) */
+    enum class State { CREATED, READY, INITIALIZED };
+
+    /* Runs init() on the calling thread, then starts the app loop and subscribes the app to input */
     void start();
+    /* Runs lateInit() on the calling thread, the app is already running */
+    void completeInit();
+    /* Asks a lateInit() still in progress to give up, the server is shutting down */
+    void cancelInit() { initCancelled_ = true; }
+    /* Ends the app loop and waits for it, then lets the app save its state and stops its audio.
+       Does nothing when the app was never started. */
+    void stop();
     void setName(const std::string & name) { name_ = name; }
+    const std::string& getName() const { return name_; }
+    State getState() const { return state_; }
+    /* Whether any audio of the app is playing, from any thread */
+    bool isPlaying() const;
     
 private:
+    /* Minimal resources the app needs to be usable */
     virtual void init() = 0;
-    virtual void appLoopFunction() = 0;
+    /* Resources the app can work without for a while (e.g. readings synthesized ahead). Runs concurrently with
+       the app loop, so it may only touch what is synchronized on its own (e.g. VoiceManager). */
+    virtual void lateInit() { }
+    /* Called by stop() once the app loop ended */
+    virtual void deinit() { }
+    /* Called on the app loop thread after the config was reloaded, the master volume already follows it */
+    virtual void onConfigReloaded(const Config& previous, const Config& current) { }
 
     std::thread thread_;
     std::string name_;
+    std::atomic<bool> running_;
+    std::atomic<State> state_;
+    std::atomic<bool> initCancelled_;
+    InputService::SubscriptionId inputSubscriptionId_;
+    Config::SubscriptionId configSubscriptionId_;
     
 protected:
+    /* Sleeps until jobs are posted to executor_ (input, audio task continuations) and runs them, until stopped */
+    virtual void appLoopFunction();
+    /* Called on the app loop thread for every button pressed */
+    virtual void onButtonPressed(InputManager::Button button) { }
+    /* App loops run while this is true */
+    bool isRunning() const { return running_; }
+    /* Checked by long lateInit() loops */
+    bool isInitCancelled() const { return initCancelled_; }
+
+    RunLoopExecutor executor_;      /* Jobs run on the app loop thread (e.g. audio task continuations, input) */
     AudioManager audioManager_;
-    InputManager inputManager_;
+    InputService& inputService_;        /* Shared by all apps, button presses are posted to executor_ */
     VoiceManager& voiceManager_;
+    AudioScheduler& audioScheduler_;    /* Shared by all apps, all audio is played through it */
+    EventLoop& eventLoop_;              /* Server thread's timers and file descriptors, shared by all apps */
+    TimerWheel& timerWheel_;            /* App timers (handlers posted to executor_), shared by all apps */
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "AppPlugin.h"
+#include "apps/AppStarter.h"
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <unordered_map>
+
+namespace Pdb
+{
+
+namespace
+{
+    /* Names as in InputManager::Button */
+    bool parseButton(const std::string& name, InputManager::Button& button)
+    {
+        static const std::unordered_map<std::string, InputManager::Button> buttons {
+            { "BUTTON_Q", InputManager::Button::BUTTON_Q }, { "BUTTON_W", InputManager::Button::BUTTON_W },
+            { "BUTTON_E", InputManager::Button::BUTTON_E }, { "BUTTON_S", InputManager::Button::BUTTON_S },
+            { "BUTTON_A", InputManager::Button::BUTTON_A }, { "BUTTON_R", InputManager::Button::BUTTON_R },
+            { "BUTTON_X", InputManager::Button::BUTTON_X }, { "BUTTON_UP", InputManager::Button::BUTTON_UP },
+            { "BUTTON_DOWN", InputManager::Button::BUTTON_DOWN }, { "BUTTON_F", InputManager::Button::BUTTON_F },
+            { "BUTTON_T", InputManager::Button::BUTTON_T }, { "BUTTON_D", InputManager::Button::BUTTON_D },
+            { "KeyKpEqual", InputManager::Button::KeyKpEqual }, { "KeyKpDivide", InputManager::Button::KeyKpDivide },
+            { "KeyKpMultiply", InputManager::Button::KeyKpMultiply }, { "KeyKpSubtract", InputManager::Button::KeyKpSubtract },
+            { "KeyKpAdd", InputManager::Button::KeyKpAdd }, { "KeyKpEnter", InputManager::Button::KeyKpEnter },
+            { "KeyKpDelete", InputManager::Button::KeyKpDelete }, { "KeyKpInsert", InputManager::Button::KeyKpInsert },
+            { "KeyKpEnd", InputManager::Button::KeyKpEnd }, { "KeyKpDown", InputManager::Button::KeyKpDown },
+            { "KeyKpPageDown", InputManager::Button::KeyKpPageDown }, { "KeyKpLeft", InputManager::Button::KeyKpLeft },
+            { "KeyKpBegin", InputManager::Button::KeyKpBegin }, { "KeyKpRight", InputManager::Button::KeyKpRight },
+            { "KeyKpHome", InputManager::Button::KeyKpHome }, { "KeyKpUp", InputManager::Button::KeyKpUp },
+            { "KeyKpPageUp", InputManager::Button::KeyKpPageUp }
+        };
+        auto found = buttons.find(name);
+        if (found == buttons.end()) return false;
+        button = found->second;
+        return true;
+    }
+}
+
+AppPlugin::AppPlugin(const AppPluginConfig& config, VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop,
+    TimerWheel& timerWheel, InputService& inputService)
+    : config_(config), voiceManager_(voiceManager), audioScheduler_(audioScheduler), eventLoop_(eventLoop), timerWheel_(timerWheel),
+    inputService_(inputService), handle_(nullptr), isLoaded_(false), nLoads_(0), isStarted_(false), inputSubscriptionId_(0), idleTimerId_(0),
+    actor_("plugin-" + config.name)
+{
+
+}
+
+AppPlugin::~AppPlugin()
+{
+    stop();
+}
+
+void AppPlugin::start()
+{
+    for (const std::string& name : config_.wakeButtons)
+    {
+        InputManager::Button button;
+        if (!parseButton(name, button))
+        {
+            BOOST_LOG_TRIVIAL(error) << "Config: " << name << " is a wrong Apps." << config_.name << "WakeButtons value.";
+            exit(0);
+        }
+        wakeButtons_.push_back(button);
+    }
+
+    isStarted_ = true;
+    actor_.start();
+    inputSubscriptionId_ = inputService_.subscribe(actor_.channel("button"), [this](InputManager::Button button) { onButtonPressed(button); });
+    const int idleMinutes = Config::getInstance().appPluginIdleMinutes;
+    if (idleMinutes > 0)
+    {
+        /* Checked a few times per idle time, unloading at most a quarter of it late */
+        const auto checkInterval = std::max(std::chrono::milliseconds(std::chrono::minutes(idleMinutes)) / 4, std::chrono::milliseconds(1000));
+        idleTimerId_ = timerWheel_.schedule(checkInterval, checkInterval, actor_.channel("idle check"), [this] { checkIdle(); });
+    }
+    BOOST_LOG_TRIVIAL(info) << "App plugin " << config_.name << " (" << config_.path << ") waits for its wake buttons.";
+}
+
+void AppPlugin::stop()
+{
+    if (!isStarted_) return;
+    isStarted_ = false;
+    if (idleTimerId_) timerWheel_.cancel(idleTimerId_);
+    inputService_.unsubscribe(inputSubscriptionId_);
+    actor_.send("unload", [this] { unload(); });
+    actor_.stop();
+}
+
+void AppPlugin::onButtonPressed(InputManager::Button button)
+{
+    lastUseTime_ = std::chrono::steady_clock::now();
+    if (app_) return;   /* Subscribed on its own */
+    if (!wakeButtons_.empty() && std::find(wakeButtons_.begin(), wakeButtons_.end(), button) == wakeButtons_.end()) return;
+    load();
+}
+
+void AppPlugin::load()
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    handle_ = dlopen(config_.path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle_)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not load app plugin " << config_.name << ": " << dlerror();
+        return;
+    }
+    auto createApp = reinterpret_cast<CreateAppFunction>(dlsym(handle_, "pdbCreateApp"));
+    if (!createApp)
+    {
+        BOOST_LOG_TRIVIAL(error) << "App plugin " << config_.path << " has no pdbCreateApp (PDB_APP_PLUGIN).";
+        dlclose(handle_);
+        handle_ = nullptr;
+        return;
+    }
+
+    lastAudioTime_ = std::chrono::steady_clock::now();
+    app_.reset(createApp(voiceManager_, audioScheduler_, eventLoop_, timerWheel_, inputService_));
+    app_->setName(config_.name);
+    app_->start();
+    app_->completeInit();
+    isLoaded_ = true;
+    ++nLoads_;
+    BOOST_LOG_TRIVIAL(info) << "Loaded app plugin " << config_.name << " in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count()
+        << " ms, resident memory " << AppStarter::getResidentKilobytes() << " kB.";
+}
+
+void AppPlugin::unload()
+{
+    if (!app_) return;
+    /* Stopped apps leave no callback behind (input, config and audio continuations, timers, transcoder results),
+       the app's code is in the shared object, it is destroyed before closing it */
+    app_->stop();
+    app_.reset();
+    dlclose(handle_);
+    handle_ = nullptr;
+    isLoaded_ = false;
+    BOOST_LOG_TRIVIAL(info) << "Unloaded app plugin " << config_.name << ", resident memory " << AppStarter::getResidentKilobytes() << " kB.";
+}
+
+void AppPlugin::checkIdle()
+{
+    if (!app_) return;
+    const auto now = std::chrono::steady_clock::now();
+    if (app_->isPlaying())
+    {
+        lastAudioTime_ = now;
+        return;
+    }
+    /* Idle only once both the last press and the last audio are older than the idle time - a long audiobook
+       played to its end without a press must not count as idle since that press */
+    const auto idleTime = std::chrono::minutes(Config::getInstance().appPluginIdleMinutes);
+    if (now - lastUseTime_ < idleTime || now - lastAudioTime_ < idleTime) return;
+    BOOST_LOG_TRIVIAL(info) << "App plugin " << config_.name << " is idle.";
+    unload();
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Config.h"
+#include "apps/App.h"
+#include "systems/executor/ActorExecutor.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Defines the entry point of an app plugin, in a source file of its own built only into the plugin's shared object:
+   PDB_APP_PLUGIN(Pdb::ClockApp) */
+#define PDB_APP_PLUGIN(AppClass) \
+    extern "C" Pdb::App* pdbCreateApp(Pdb::VoiceManager& voiceManager, Pdb::AudioScheduler& audioScheduler, Pdb::EventLoop& eventLoop, \
+        Pdb::TimerWheel& timerWheel, Pdb::InputService& inputService) \
+    { \
+        return new AppClass(voiceManager, audioScheduler, eventLoop, timerWheel, inputService); \
+    }
+
+namespace Pdb
+{
+
+/* App built as a shared object (dlopen) instead of being compiled into the server, so that units not using it pay
+   nothing for it - no AudioManager, no input handling, no voice messages synthesized. It is loaded and started on
+   the first press of one of its wake buttons, and stopped and unloaded after being idle (no button pressed and
+   none of its audio playing) for the configured time. The press waking it only loads it. Loading and unloading
+   run on an actor of the plugin, never on the event loop. */
+class AppPlugin
+{
+public:
+    using CreateAppFunction = App* (*)(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop,
+        TimerWheel& timerWheel, InputService& inputService);
+
+    AppPlugin(const AppPluginConfig& config, VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop,
+        TimerWheel& timerWheel, InputService& inputService);
+    ~AppPlugin();
+
+    /* Starts waiting for the wake buttons, exits on unknown button names like on other config errors */
+    void start();
+    /* Stops and unloads the app when loaded */
+    void stop();
+
+    const std::string& getName() const { return config_.name; }
+    bool isLoaded() const { return isLoaded_; }
+    unsigned getLoadCount() const { return nLoads_; }
+
+private:
+    void onButtonPressed(InputManager::Button button);
+    void load();
+    void unload();
+    void checkIdle();
+
+    AppPluginConfig config_;
+    VoiceManager& voiceManager_;
+    AudioScheduler& audioScheduler_;
+    EventLoop& eventLoop_;
+    TimerWheel& timerWheel_;
+    InputService& inputService_;
+
+    std::vector<InputManager::Button> wakeButtons_;
+    void* handle_;
+    std::unique_ptr<App> app_;
+    std::atomic<bool> isLoaded_;
+    std::atomic<unsigned> nLoads_;
+    std::chrono::steady_clock::time_point lastUseTime_;     /* Last button press */
+    std::chrono::steady_clock::time_point lastAudioTime_;   /* Last idle check that found the app playing */
+
+    bool isStarted_;
+    InputService::SubscriptionId inputSubscriptionId_;
+    TimerWheel::TimerId idleTimerId_;
+    /* Declared last, stopped first - its commands use the members above */
+    ActorExecutor actor_;
+};
+
+}
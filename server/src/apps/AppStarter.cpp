@@ -0,0 +1,157 @@
+#include "AppStarter.h"
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace Pdb
+{
+
+AppStarter::AppStarter() : cancelled_(false), nReady_(0), nInitialized_(0)
+{
+
+}
+
+AppStarter::~AppStarter()
+{
+    cancel();
+}
+
+void AppStarter::add(App& app, const std::vector<std::string>& dependencies)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    apps_[app.getName()] = Entry { &app, dependencies, false };
+}
+
+void AppStarter::start(size_t nThreads)
+{
+    checkDependencies();
+    startTime_ = std::chrono::steady_clock::now();
+    executor_ = std::make_unique<ThreadPoolExecutor>(std::max<size_t>(nThreads, 1), ThreadRole::APP, "startup");
+    std::lock_guard<std::mutex> lock(mutex_);
+    postStartableApps();
+}
+
+void AppStarter::cancel()
+{
+    cancelled_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : apps_) entry.second.app->cancelInit();
+    }
+    executor_.reset();      /* Queued jobs see cancelled_ and return */
+}
+
+void AppStarter::checkDependencies() const
+{
+    std::unordered_map<std::string, std::vector<std::string>> dependencies;
+    for (const auto& entry : apps_) dependencies[entry.first] = entry.second.dependencies;
+    std::vector<std::string> startOrder;
+    std::string error;
+    if (!resolveStartOrder(dependencies, startOrder, error))
+    {
+        BOOST_LOG_TRIVIAL(error) << error;
+        exit(0);
+    }
+}
+
+bool AppStarter::resolveStartOrder(const std::unordered_map<std::string, std::vector<std::string>>& dependencies,
+    std::vector<std::string>& startOrder, std::string& error)
+{
+    for (const auto& entry : dependencies)
+        for (const std::string& dependency : entry.second)
+            if (dependencies.find(dependency) == dependencies.end())
+            {
+                error = "App " + entry.first + " depends on " + dependency + ", which is not registered.";
+                return false;
+            }
+
+    /* Resolving the apps the way they will be started, whatever cannot be resolved is in a cycle */
+    std::unordered_set<std::string> resolved;
+    startOrder.clear();
+    bool isProgressing = true;
+    while (isProgressing)
+    {
+        isProgressing = false;
+        for (const auto& entry : dependencies)
+        {
+            if (resolved.count(entry.first)) continue;
+            bool isResolvable = true;
+            for (const std::string& dependency : entry.second)
+                if (!resolved.count(dependency)) isResolvable = false;
+            if (isResolvable)
+            {
+                resolved.insert(entry.first);
+                startOrder.push_back(entry.first);
+                isProgressing = true;
+            }
+        }
+    }
+    for (const auto& entry : dependencies)
+        if (!resolved.count(entry.first))
+        {
+            error = "App " + entry.first + " has cyclic dependencies.";
+            return false;
+        }
+    return true;
+}
+
+void AppStarter::postStartableApps()
+{
+    for (auto& entry : apps_)
+    {
+        if (entry.second.isPosted) continue;
+        bool isStartable = true;
+        for (const std::string& dependency : entry.second.dependencies)
+            if (apps_.at(dependency).app->getState() == App::State::CREATED) isStartable = false;
+        if (!isStartable) continue;
+
+        entry.second.isPosted = true;
+        App* app = entry.second.app;
+        executor_->post([this, app] { startApp(*app); });
+    }
+}
+
+void AppStarter::startApp(App& app)
+{
+    if (cancelled_) return;
+    BOOST_LOG_TRIVIAL(info) << "Starting app: " << app.getName();
+    app.start();
+    onReady(app);
+
+    app.completeInit();
+    const size_t nInitialized = ++nInitialized_;
+    BOOST_LOG_TRIVIAL(info) << "App " << app.getName() << " initialized after " << millisecondsSinceStart() << " ms.";
+    if (nInitialized == apps_.size())
+        BOOST_LOG_TRIVIAL(info) << "All " << nInitialized << " apps initialized after " << millisecondsSinceStart() << " ms, resident memory "
+            << getResidentKilobytes() << " kB.";
+}
+
+void AppStarter::onReady(App& app)
+{
+    const size_t nReady = ++nReady_;
+    if (nReady == 1)
+        BOOST_LOG_TRIVIAL(info) << "First usable app: " << app.getName() << ", after " << millisecondsSinceStart() << " ms.";
+    BOOST_LOG_TRIVIAL(info) << "App " << app.getName() << " ready after " << millisecondsSinceStart() << " ms.";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!cancelled_) postStartableApps();
+}
+
+long long AppStarter::getResidentKilobytes()
+{
+    /* Second field of statm, in pages */
+    std::ifstream statm("/proc/self/statm");
+    long long nPages = 0, nResidentPages = 0;
+    if (!(statm >> nPages >> nResidentPages)) return 0;
+    return nResidentPages * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+long long AppStarter::millisecondsSinceStart() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime_).count();
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "apps/App.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Starts the apps in parallel on a pool of startup threads, each app as soon as all the apps it depends on are ready
+   (usable), so that one app synthesizing thousands of messages does not hold the others back. Logs when each app
+   gets ready and fully initialized, and the time to the first usable app. */
+class AppStarter
+{
+public:
+    AppStarter();
+    ~AppStarter();
+
+    /* Dependencies are names of other added apps */
+    void add(App& app, const std::vector<std::string>& dependencies);
+    /* Checks the dependencies (exits on unknown or cyclic ones, like on config errors) and posts the apps without
+       any, returns right away */
+    void start(size_t nThreads);
+    /* Cancels late initialization and waits for the startup jobs in progress, apps not started yet never are */
+    void cancel();
+
+    /* Orders app names (keys of dependencies, mapped to the names they depend on) so that each comes after all
+       of its dependencies. False when a dependency is not registered or cyclic, error then tells which. */
+    static bool resolveStartOrder(const std::unordered_map<std::string, std::vector<std::string>>& dependencies,
+        std::vector<std::string>& startOrder, std::string& error);
+
+    /* Resident memory of the whole server, reported with startup times and by plugins */
+    static long long getResidentKilobytes();
+
+    size_t getReadyCount() const { return nReady_; }
+    size_t getInitializedCount() const { return nInitialized_; }
+
+private:
+    struct Entry
+    {
+        App* app;
+        std::vector<std::string> dependencies;
+        bool isPosted;
+    };
+
+    void checkDependencies() const;
+    /* Called with mutex_ locked */
+    void postStartableApps();
+    void startApp(App& app);
+    void onReady(App& app);
+    long long millisecondsSinceStart() const;
+
+    std::unordered_map<std::string, Entry> apps_;
+    std::mutex mutex_;
+    std::atomic<bool> cancelled_;
+    std::atomic<size_t> nReady_;
+    std::atomic<size_t> nInitialized_;
+    std::chrono::steady_clock::time_point startTime_;
+
+    /* Declared last, destroyed first - its jobs use the members above */
+    std::unique_ptr<ThreadPoolExecutor> executor_;
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "systems/input/InputManager.h"
+
+#include <array>
+#include <cstddef>
+
+namespace Pdb
+{
+
+/* Action of each state and button of an app, in a dense table filled once when the app is created - a button press
+   finds its action by indexing, without hashing, scanning nor std::function calls. Actions are plain function
+   pointers (captureless lambdas convert to them) taking the app and the dispatched arguments. States must be
+   a contiguous enum starting at 0, apps without states use a single one. */
+template <typename Owner, typename State, size_t nStates, typename... Args>
+class DispatchTable
+{
+public:
+    using Action = void (*)(Owner& owner, Args... args);
+
+    DispatchTable()
+    {
+        clear();
+    }
+
+    /* Before filling the table again, e.g. for another input mode */
+    void clear()
+    {
+        for (auto& stateActions : actions_) stateActions.fill(nullptr);
+    }
+
+    void set(State state, InputManager::Button button, Action action)
+    {
+        actions_[static_cast<size_t>(state)][button] = action;
+    }
+
+    /* Same action of the button in all states */
+    void setAll(InputManager::Button button, Action action)
+    {
+        for (auto& stateActions : actions_) stateActions[button] = action;
+    }
+
+    /* Returns false when the button does nothing in the state */
+    bool dispatch(Owner& owner, State state, InputManager::Button button, Args... args) const
+    {
+        if (button < 0 || button >= InputManager::Button::BUTTON_COUNT) return false;
+        const Action action = actions_[static_cast<size_t>(state)][button];
+        if (!action) return false;
+        action(owner, args...);
+        return true;
+    }
+
+private:
+    std::array<std::array<Action, InputManager::Button::BUTTON_COUNT>, nStates> actions_;
+};
+
+}
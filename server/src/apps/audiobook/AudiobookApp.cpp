@@ -4,8 +4,8 @@
 namespace Pdb
 {
 
-AudiobookApp::AudiobookApp(VoiceManager& voiceManager)
-    : Pdb::App(voiceManager), audiobookPlayer_(audioManager_, voiceManager)
+AudiobookApp::AudiobookApp(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService)
+    : Pdb::App(voiceManager, audioScheduler, eventLoop, timerWheel, inputService), audiobookPlayer_(audioManager_, voiceManager, audioScheduler, timerWheel)
 {
     BOOST_LOG_TRIVIAL(info) << "Creating AudiobookApp.";
 }
@@ -13,14 +13,24 @@ AudiobookApp::AudiobookApp(VoiceManager& voiceManager)
 void AudiobookApp::init()
 {
     synthesizeVoiceMessages();
-    AudioTask* initialAudioTask = audioManager_.play({
-        voiceManager_.getSynthesizedVoiceAudioTracks().at("choosing_audiobooks"),
-        voiceManager_.getSynthesizedVoiceAudioTracks().at(audiobookPlayer_.getCurrentTrack().getTrackName())
+    audioScheduler_.play(audioManager_, AudioScheduler::Priority::NAVIGATION, {
+        voiceManager_.getVoiceMessage("choosing_audiobooks"),
+        voiceManager_.getVoiceMessage(audiobookPlayer_.getCurrentTrack().getTrackName())
     });
-    audiobookPlayer_.setCurrentAudioTask(initialAudioTask);
+    audiobookPlayer_.start();
     BOOST_LOG_TRIVIAL(info) << "Initialized AudiobookApp.";
 }
 
+void AudiobookApp::deinit()
+{
+    audiobookPlayer_.shutdown();
+}
+
+void AudiobookApp::onConfigReloaded(const Config& previous, const Config& current)
+{
+    audiobookPlayer_.onConfigReloaded(previous, current);
+}
+
 void AudiobookApp::synthesizeVoiceMessages()
 {
     /* Synthesizing lodaded audio track titles e.g. "harry potter" for "harry_potter.mp3" */
@@ -42,6 +52,8 @@ void AudiobookApp::synthesizeVoiceMessages()
     voiceManager_.synthesizeVoiceMessage("<speak>Zakończono odtwarzanie: </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "stopping_audiobook");
     voiceManager_.synthesizeVoiceMessage("<speak>Przewijanie do przodu. </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "fast_forwarding");
     voiceManager_.synthesizeVoiceMessage("<speak>Przewijanie do tyłu. </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "rewinding");
+    voiceManager_.synthesizeVoiceMessage("<speak>Głośniej. </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "volume_up");
+    voiceManager_.synthesizeVoiceMessage("<speak>Ciszej. </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "volume_down");
     voiceManager_.synthesizeVoiceMessage("<speak>2-krotne </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "2x");
     voiceManager_.synthesizeVoiceMessage("<speak>4-krotne </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "4x");
     voiceManager_.synthesizeVoiceMessage("<speak>8-krotne </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "8x");
@@ -51,28 +63,16 @@ void AudiobookApp::synthesizeVoiceMessages()
     voiceManager_.synthesizeVoiceMessage("<speak>128-krotne </speak>", "../data/synthesized_sounds/apps/audiobook/messages/pl", "128x");
 }
 
-void AudiobookApp::appLoopFunction()
+void AudiobookApp::onButtonPressed(InputManager::Button button)
 {
-    BOOST_LOG_TRIVIAL(info) << "Starting AudiobookApp loop function.";
-        
-    while(true)
-    {
-        inputManager_.update();
-        auto& availableActions = audiobookPlayer_.getAvailableActions();
-        for (auto& action : availableActions) 
-        {
-            if (inputManager_.isButtonPressed(action.first))
-                action.second();
-        }
+    audiobookPlayer_.onButtonPressed(button);
 
-        if (inputManager_.isButtonPressed(InputManager::Button::BUTTON_X))
-        {
-            audiobookPlayer_.printState();
-            audioManager_.printAllStreamsInfo();
-        }
+    if (button == InputManager::Button::BUTTON_X)
+    {
+        audioManager_.printAllStreamsInfo();
+        audioScheduler_.printStats();
+        inputService_.printStats();
     }
-
-    BOOST_LOG_TRIVIAL(info) << "Ending AudiobookApp loop function.";
 }
 
 }
\ No newline at end of file
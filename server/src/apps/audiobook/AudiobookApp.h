@@ -11,11 +11,13 @@ namespace Pdb
 class AudiobookApp : public App
 {
 public:
-    AudiobookApp(VoiceManager& voiceManager);
+    AudiobookApp(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService);
     void init() override;
-    void appLoopFunction() override;
+    void onButtonPressed(InputManager::Button button) override;
 
 private:
+    void deinit() override;
+    void onConfigReloaded(const Config& previous, const Config& current) override;
     void synthesizeVoiceMessages();
     
     AudiobookPlayer audiobookPlayer_;
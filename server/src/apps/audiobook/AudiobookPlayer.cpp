@@ -1,5 +1,10 @@
 #include "AudiobookPlayer.h"
+#include "systems/audio/analysis/LoudnessAnalyzer.h"
+#include "systems/audio/analysis/SilenceScanner.h"
+#include "systems/audio/transcoding/Transcoder.h"
+#include "systems/audio/MultiPartReader.h"
 #include <boost/log/trivial.hpp>
+#include <algorithm>
 #include <future>
 #include <memory>
 #include <iterator>
@@ -12,9 +17,13 @@ namespace filesystem = boost::filesystem;
 namespace Pdb
 {
 
-AudiobookPlayer::AudiobookPlayer(AudioManager& audioManager, VoiceManager& voiceManager) 
-    : audioManager_(audioManager), voiceManager_(voiceManager), fastForwardingSpeed_(0), currentAudioTask_(nullptr), pausedAudioTask_(nullptr),
-    trackInfoPattern_(std::string("^(.+)([[:space:]])([0-9]|[1-9][0-9]*)$"))
+AudiobookPlayer::AudiobookPlayer(AudioManager& audioManager, VoiceManager& voiceManager, AudioScheduler& audioScheduler, TimerWheel& timerWheel) 
+    : audioManager_(audioManager), voiceManager_(voiceManager), audioScheduler_(audioScheduler), timerWheel_(timerWheel),
+    currentAudioTask_(nullptr), pausedAudioTask_(nullptr), audiobookId_(0), fastForwardingSpeed_(0), scrubBasePosition_(0), scrubDuration_(0), scrubId_(0),
+    previewPlaying_(false), pausedTimeoutTimerId_(0),
+    trackInfoPattern_(std::string("^(.+)([[:space:]])([0-9]|[1-9][0-9]*)$")), mailbox_("audiobook player"),
+    inputCommands_(mailbox_.channel("input")), timerCommands_(mailbox_.channel("timer")), audioCommands_(mailbox_.channel("audio")),
+    transcoderCommands_(mailbox_.channel("transcoder"))
 {
     this->loadTracks();
     this->loadTracksInfo();
@@ -22,10 +31,22 @@ AudiobookPlayer::AudiobookPlayer(AudioManager& audioManager, VoiceManager& voice
     currentTrackIndex_ = 0;
     currentState_ = State::CHOOSING;
 
+    mapButtons(Config::getInstance().inputMode);
+}
+
+void AudiobookPlayer::onConfigReloaded(const Config& previous, const Config& current)
+{
+    if (current.inputMode == previous.inputMode && current.inputCoalescingMilliseconds == previous.inputCoalescingMilliseconds) return;
+    const InputMode inputMode = current.inputMode;
+    mailbox_.send("config", [this, inputMode] { mapButtons(inputMode); });
+}
+
+void AudiobookPlayer::mapButtons(InputMode inputMode)
+{
     InputManager::Button playButton, pauseButton, rewindButton, fastForwardButton, increaseVolumeButton, decreaseVolumeButton,
         exitButton, switchToNextButton, switchToPreviousButton;
 
-    if (Config::getInstance().inputMode == "debug")
+    if (inputMode == InputMode::DEBUG)
     {
         playButton = InputManager::Button::BUTTON_S;
         pauseButton = InputManager::Button::BUTTON_S;
@@ -37,7 +58,7 @@ AudiobookPlayer::AudiobookPlayer(AudioManager& audioManager, VoiceManager& voice
         switchToNextButton = InputManager::Button::BUTTON_D;
         switchToPreviousButton = InputManager::Button::BUTTON_A;
     }
-    else if (Config::getInstance().inputMode == "prod")
+    else if (inputMode == InputMode::PROD)
     {
         playButton = InputManager::Button::KeyKpBegin;
         pauseButton = InputManager::Button::KeyKpBegin;
@@ -50,116 +71,226 @@ AudiobookPlayer::AudiobookPlayer(AudioManager& audioManager, VoiceManager& voice
         switchToPreviousButton = InputManager::Button::KeyKpLeft;
     }
 
+    actions_.clear();
+    auto playChosen = [](AudiobookPlayer& player, int) { player.playChosenAudiobook(); };
+    auto pauseToggle = [](AudiobookPlayer& player, int) { player.pauseToggle(); };
+    auto stop = [](AudiobookPlayer& player, int) { player.stopAudiobook(); };
+    auto rewind = [](AudiobookPlayer& player, int nPresses) { player.rewind(nPresses); };
+    auto fastForward = [](AudiobookPlayer& player, int nPresses) { player.fastForward(nPresses); };
+    auto increaseVolume = [](AudiobookPlayer& player, int nPresses) { player.increaseVolume(nPresses); };
+    auto decreaseVolume = [](AudiobookPlayer& player, int nPresses) { player.decreaseVolume(nPresses); };
+
+    /* In all states */
+    actions_.setAll(increaseVolumeButton, increaseVolume);
+    actions_.setAll(decreaseVolumeButton, decreaseVolume);
+
     // CHOOSING STATE
-    std::vector< std::pair<InputManager::Button, std::function<void()> > > choosingStateActions;
-    choosingStateActions.push_back(std::make_pair(switchToPreviousButton, std::bind(&AudiobookPlayer::switchToPreviousAudiobook, this)));
-    choosingStateActions.push_back(std::make_pair(playButton, std::bind(&AudiobookPlayer::playChosenAudiobook, this)));
-    choosingStateActions.push_back(std::make_pair(switchToNextButton, std::bind(&AudiobookPlayer::switchToNextAudiobook, this)));
-    choosingStateActions.push_back(std::make_pair(increaseVolumeButton, std::bind(&AudioManager::increaseMasterVolume, &audioManager_)));
-    choosingStateActions.push_back(std::make_pair(decreaseVolumeButton, std::bind(&AudioManager::decreaseMasterVolume, &audioManager_)));
-    availableActions_.insert(std::make_pair(State::CHOOSING, std::move(choosingStateActions)));
+    actions_.set(State::CHOOSING, switchToPreviousButton, [](AudiobookPlayer& player, int nPresses) { player.switchToPreviousAudiobook(nPresses); });
+    actions_.set(State::CHOOSING, playButton, playChosen);
+    actions_.set(State::CHOOSING, switchToNextButton, [](AudiobookPlayer& player, int nPresses) { player.switchToNextAudiobook(nPresses); });
 
     // PLAYING STATE
-    std::vector< std::pair<InputManager::Button, std::function<void()> > > playingStateActions;
-    playingStateActions.push_back(std::make_pair(rewindButton, std::bind(&AudiobookPlayer::rewind, this)));
-    playingStateActions.push_back(std::make_pair(fastForwardButton, std::bind(&AudiobookPlayer::fastForward, this)));
-    playingStateActions.push_back(std::make_pair(pauseButton, std::bind(&AudiobookPlayer::pauseToggle, this)));
-    playingStateActions.push_back(std::make_pair(increaseVolumeButton, std::bind(&AudioManager::increaseMasterVolume, &audioManager_)));
-    playingStateActions.push_back(std::make_pair(decreaseVolumeButton, std::bind(&AudioManager::decreaseMasterVolume, &audioManager_)));
-    playingStateActions.push_back(std::make_pair(exitButton, std::bind(&AudiobookPlayer::stopAudiobook, this)));
-    availableActions_.insert(std::make_pair(State::PLAYING, std::move(playingStateActions)));
+    actions_.set(State::PLAYING, rewindButton, rewind);
+    actions_.set(State::PLAYING, fastForwardButton, fastForward);
+    actions_.set(State::PLAYING, pauseButton, pauseToggle);
+    actions_.set(State::PLAYING, exitButton, stop);
 
     // REWINDING STATE
-    std::vector< std::pair<InputManager::Button, std::function<void()> > > rewindingStateActions;
-    rewindingStateActions.push_back(std::make_pair(rewindButton, std::bind(&AudiobookPlayer::rewind, this)));
-    rewindingStateActions.push_back(std::make_pair(fastForwardButton, std::bind(&AudiobookPlayer::fastForward, this)));
-    rewindingStateActions.push_back(std::make_pair(pauseButton, std::bind(&AudiobookPlayer::pauseToggle, this)));
-    rewindingStateActions.push_back(std::make_pair(increaseVolumeButton, std::bind(&AudioManager::increaseMasterVolume, &audioManager_)));
-    rewindingStateActions.push_back(std::make_pair(decreaseVolumeButton, std::bind(&AudioManager::decreaseMasterVolume, &audioManager_)));
-    availableActions_.insert(std::make_pair(State::REWINDING, std::move(rewindingStateActions)));
+    actions_.set(State::REWINDING, rewindButton, rewind);
+    actions_.set(State::REWINDING, fastForwardButton, fastForward);
+    actions_.set(State::REWINDING, pauseButton, pauseToggle);
 
     // FAST_FORWARDING STATE
-    std::vector< std::pair<InputManager::Button, std::function<void()> > > fastForwardingStateActions;
-    fastForwardingStateActions.push_back(std::make_pair(rewindButton, std::bind(&AudiobookPlayer::rewind, this)));
-    fastForwardingStateActions.push_back(std::make_pair(fastForwardButton, std::bind(&AudiobookPlayer::fastForward, this)));
-    fastForwardingStateActions.push_back(std::make_pair(pauseButton, std::bind(&AudiobookPlayer::pauseToggle, this)));
-    fastForwardingStateActions.push_back(std::make_pair(increaseVolumeButton, std::bind(&AudioManager::increaseMasterVolume, &audioManager_)));
-    fastForwardingStateActions.push_back(std::make_pair(decreaseVolumeButton, std::bind(&AudioManager::decreaseMasterVolume, &audioManager_)));
-    availableActions_.insert(std::make_pair(State::FAST_FORWARDING, std::move(fastForwardingStateActions)));
+    actions_.set(State::FAST_FORWARDING, rewindButton, rewind);
+    actions_.set(State::FAST_FORWARDING, fastForwardButton, fastForward);
+    actions_.set(State::FAST_FORWARDING, pauseButton, pauseToggle);
 
     // PAUSED STATE
-    std::vector< std::pair<InputManager::Button, std::function<void()> > > pausedStateActions;
-    pausedStateActions.push_back(std::make_pair(rewindButton, std::bind(&AudiobookPlayer::rewind, this)));
-    pausedStateActions.push_back(std::make_pair(fastForwardButton, std::bind(&AudiobookPlayer::fastForward, this)));
-    pausedStateActions.push_back(std::make_pair(playButton, std::bind(&AudiobookPlayer::pauseToggle, this)));
-    pausedStateActions.push_back(std::make_pair(increaseVolumeButton, std::bind(&AudioManager::increaseMasterVolume, &audioManager_)));
-    pausedStateActions.push_back(std::make_pair(decreaseVolumeButton, std::bind(&AudioManager::decreaseMasterVolume, &audioManager_)));
-    pausedStateActions.push_back(std::make_pair(exitButton, std::bind(&AudiobookPlayer::stopAudiobook, this)));
-    availableActions_.insert(std::make_pair(State::PAUSED, std::move(pausedStateActions)));
+    actions_.set(State::PAUSED, rewindButton, rewind);
+    actions_.set(State::PAUSED, fastForwardButton, fastForward);
+    actions_.set(State::PAUSED, playButton, pauseToggle);
+    actions_.set(State::PAUSED, exitButton, stop);
+
+    /* Pausing and stopping are not repeatable, a burst of them is not one command */
+    std::vector<InputManager::Button> repeatableButtons { rewindButton, fastForwardButton, switchToNextButton, switchToPreviousButton,
+        increaseVolumeButton, decreaseVolumeButton };
+    if (inputCoalescer_) inputCoalescer_->flush();
+    inputCoalescer_ = std::make_unique<InputCoalescer>(timerWheel_, timerCommands_,
+        std::chrono::milliseconds(Config::getInstance().inputCoalescingMilliseconds), std::move(repeatableButtons),
+        [this](InputManager::Button button, int nPresses) { handleButton(button, nPresses); });
 }
 
-void AudiobookPlayer::play(std::list<AudioTask::Element> audioTaskElements, std::function<void()> callbackFunction)
+void AudiobookPlayer::playPrompt(std::list<AudioTask::Element> audioTaskElements)
 {
-    currentAudioTask_ = audioManager_.play(audioTaskElements, callbackFunction);
+    audioScheduler_.play(audioManager_, AudioScheduler::Priority::NAVIGATION, std::move(audioTaskElements));
 }
 
 void AudiobookPlayer::playChosenAudiobook()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
     changeStateTo(State::PLAYING);
     AudioTrack& currentAudioTrack = audioTracks_[currentTrackIndex_];
 
     BOOST_LOG_TRIVIAL(info) << "Playing audiotrack: " << currentAudioTrack.getTrackName() << " (" << currentAudioTrack.getFilePath() << ")";
 
-    if (currentAudioTask_) currentAudioTask_->stop();
+    /* Audiobook title being read is not needed anymore */
+    audioScheduler_.stop(audioManager_, AudioScheduler::Priority::NAVIGATION);
     
-    auto audiobookFinishCallback = [this]()
+    /* Runs on the actor thread, not on the audio task thread. Registered with the request (under the scheduler
+       lock) - attached to the returned task afterwards it could already belong to another playback. Also runs
+       when the audiobook is stopped or preempted, so it only acts on the audiobook still being played */
+    const unsigned int audiobookId = ++audiobookId_;
+    auto audiobookFinishContinuation = [this, audiobookId]()
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (currentState_ == State::PLAYING)
-        {
-            audioTracks_[currentTrackIndex_].setLastPlayedMillisecond(0);
-            saveTracksInfo();
-            changeStateTo(State::CHOOSING);
-            BOOST_LOG_TRIVIAL(info) << "Finished playing audiotrack.";
-            play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("stopping_audiobook") });
-        }
+        if (audiobookId != audiobookId_ || currentState_ != State::PLAYING || !currentAudioTask_) return;
+        audioTracks_[currentTrackIndex_].setLastPlayedMillisecond(0);
+        saveTracksInfo();
+        changeStateTo(State::CHOOSING);
+        currentAudioTask_ = nullptr;
+        BOOST_LOG_TRIVIAL(info) << "Finished playing audiotrack.";
+        playPrompt({ voiceManager_.getVoiceMessage("stopping_audiobook") });
     };
-    play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("playing_audiobook"), currentAudioTrack }, audiobookFinishCallback);
+    currentAudioTask_ = audioScheduler_.play(audioManager_, AudioScheduler::Priority::CONTENT,
+        { voiceManager_.getVoiceMessage("playing_audiobook"), currentAudioTrack }, audioCommands_, audiobookFinishContinuation);
 }
 
-void AudiobookPlayer::fastForwardingTimerFunction()
+void AudiobookPlayer::startScrubbing(AudioTask* audioTask, int speed)
 {
-    fastForwardedSeconds_ = 0;
-    //TODO: TO WCZYTUJE INFO z "REWINDING" a nie z AUDIO TRACK, wiec ZMIEN TOOOO
-    //JAK JEST REWINDING I INNE GOWNA TO MUSI SIE NADPISYWAC AUDIO_TRACK INFO KONIECZNIE!
-    // Z TEGO TEZ BIERZEMY TO INFO I DAJEMY TU NA DOLE (lastPlayedSecond)
-    int lastPlayedSecond = audioTracks_[currentTrackIndex_].getLastPlayedMillisecond() / 1000;
-    // TO BYLO WCZESNIEJ: int lastPlayedSecond = currentAudioTask_->getCurrentTaskElementMilliseconds() / 1000;
+    scrubBasePosition_ = std::max(0, audioTask->getCurrentTaskElementMilliseconds());
+    scrubDuration_ = audioTask->getCurrentTaskElementDurationMilliseconds();
+    scrubBaseTime_ = std::chrono::steady_clock::now();
+    fastForwardingSpeed_ = speed;
+    ++scrubId_;
+    BOOST_LOG_TRIVIAL(info) << "Scrubbing from " << scrubBasePosition_ << " ms of " << scrubDuration_ << " ms.";
+}
 
+void AudiobookPlayer::setScrubbingSpeed(int speed)
+{
+    const auto now = std::chrono::steady_clock::now();
+    scrubBasePosition_ = projectedPosition(now);
+    scrubBaseTime_ = now;
+    fastForwardingSpeed_ = speed;
+    BOOST_LOG_TRIVIAL(info) << "Scrubbing from " << scrubBasePosition_ << " ms.";
+}
 
-    while (fastForwardingSpeed_ != 0)
+int AudiobookPlayer::projectedPosition(std::chrono::steady_clock::time_point time) const
+{
+    const long long elapsedMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(time - scrubBaseTime_).count();
+    long long position = scrubBasePosition_ + fastForwardingSpeed_ * elapsedMilliseconds;
+    if (scrubDuration_ > 0) position = std::min<long long>(position, scrubDuration_);
+    return (int)std::max(0LL, position);
+}
+
+int AudiobookPlayer::stopScrubbing()
+{
+    ++scrubId_;
+    endPreview();
+    if (fastForwardingSpeed_ == 0) return -1;
+    const int position = projectedPosition(std::chrono::steady_clock::now());
+    fastForwardingSpeed_ = 0;
+    BOOST_LOG_TRIVIAL(info) << "Scrubbed to " << position << " ms.";
+    return position;
+}
+
+Coroutine AudiobookPlayer::scrub(unsigned int scrubId, std::list<AudioTask::Element> announcement)
+{
+    /* Previews would talk over it */
+    co_await audioScheduler_.playAndWait(audioManager_, AudioScheduler::Priority::NAVIGATION, std::move(announcement), audioCommands_);
+
+    const Config& config = Config::getInstance();
+    if (config.scrubPreviewMilliseconds <= 0) co_return;
+    const std::chrono::milliseconds previewLength(config.scrubPreviewMilliseconds);
+    const std::chrono::milliseconds interval(std::max(config.scrubPreviewIntervalMilliseconds, config.scrubPreviewMilliseconds));
+
+    while (scrubId == scrubId_)
     {
-        //TODO: Czy tu moze byc problem? zobacz funkcje np. rewind
-        auto sleepToTime = std::chrono::steady_clock::now() + std::chrono::seconds(1);
-        fastForwardedSeconds_ += fastForwardingSpeed_;
-        std::this_thread::sleep_until(sleepToTime);
-                
-        std::unique_lock<std::mutex> lock(mutex_);
-        BOOST_LOG_TRIVIAL(info) << "Fast-forwarded seconds: " << fastForwardedSeconds_ 
-            << ", last played second: " << lastPlayedSecond << ", difference " << (lastPlayedSecond + fastForwardedSeconds_);
-        //TODO: Skrajny przypadek gdy przewiniemy z 2xd o 0x ale tez bedzie koniec -> wtedy 2x razy sie wykona np. pauseToggle()
-        // if ((lastPlayedSecond + fastForwardedSeconds_) < 0)
-        // {
-        //     fastForwardingSpeed_ = 0;
-        //     changeStateTo(State::PLAYING);
-        //     currentAudioTask_->pauseToggle();
-        //     currentAudioTask_->seek(fastForwardedSeconds_ * 1000);
-        //     break;
-        // }
+        co_await timerWheel_.sleepFor(interval - previewLength, timerCommands_);
+        if (scrubId != scrubId_ || !pausedAudioTask_ || !pausedAudioTask_->isPaused()) co_return;
+
+        pausedAudioTask_->seekTo(projectedPosition(std::chrono::steady_clock::now()));
+        pausedAudioTask_->pauseToggle();
+        previewPlaying_ = true;
+        co_await timerWheel_.sleepFor(previewLength, timerCommands_);
+        /* Otherwise stopScrubbing() has already ended the preview */
+        if (scrubId == scrubId_) endPreview();
     }
 }
 
+void AudiobookPlayer::endPreview()
+{
+    if (!previewPlaying_) return;
+    previewPlaying_ = false;
+    if (pausedAudioTask_ && !pausedAudioTask_->isPaused()) pausedAudioTask_->pauseToggle();
+}
+
+void AudiobookPlayer::startPausedTimeout()
+{
+    const int timeoutMinutes = Config::getInstance().pausedTimeoutMinutes;
+    if (timeoutMinutes <= 0) return;
+    pausedTimeoutTimerId_ = timerWheel_.schedule(std::chrono::minutes(timeoutMinutes), std::chrono::milliseconds(0), timerCommands_,
+        [this] { onPausedTimeout(); });
+}
+
+void AudiobookPlayer::onPausedTimeout()
+{
+    pausedTimeoutTimerId_ = 0;
+    if (currentState_ != State::PAUSED || !pausedAudioTask_) return;
+
+    /* Frees the audio stream, playing the chosen audiobook again resumes from the saved position */
+    BOOST_LOG_TRIVIAL(info) << "Audiobook paused for " << Config::getInstance().pausedTimeoutMinutes << " minutes, stopping it.";
+    updateCurrentTrackInfo(pausedAudioTask_);
+    audioScheduler_.stop(audioManager_, AudioScheduler::Priority::CONTENT);
+    pausedAudioTask_ = nullptr;
+    changeStateTo(State::CHOOSING);
+}
+
+void AudiobookPlayer::cancelPausedTimeout()
+{
+    if (pausedTimeoutTimerId_) timerWheel_.cancel(pausedTimeoutTimerId_);
+    pausedTimeoutTimerId_ = 0;
+}
+
+void AudiobookPlayer::resumePausedAudiobook()
+{
+    if (!pausedAudioTask_) return;
+    pausedAudioTask_->pauseToggle();
+    currentAudioTask_ = pausedAudioTask_;
+    pausedAudioTask_ = nullptr;
+}
+
+int AudiobookPlayer::snapSeekPosition(int positionInMilliseconds)
+{
+    if (!Config::getInstance().snapSeekToSpeech) return positionInMilliseconds;
+    auto silenceIndex = SilenceScanner::getInstance().getIndex(audioTracks_[currentTrackIndex_].getFilePath());
+    if (!silenceIndex) return positionInMilliseconds;
+
+    const int snappedPosition = silenceIndex->snapToSpeechStart(positionInMilliseconds, Config::getInstance().snapSeekWindowMilliseconds);
+    BOOST_LOG_TRIVIAL(info) << "Seek target " << positionInMilliseconds << " ms snapped to " << snappedPosition << " ms.";
+    return snappedPosition;
+}
+
+Coroutine AudiobookPlayer::resumeFromPause(std::chrono::steady_clock::time_point toggleStartTime)
+{
+    AudioTrack& unpausingPrompt = voiceManager_.getVoiceMessage("unpausing_audiobook");
+    if (Config::getInstance().promptOverlay)
+    {
+        /* Audiobook is resumed right away, the prompt is played on top of it (ducked) */
+        resumePausedAudiobook();
+        playPrompt({ unpausingPrompt });
+    }
+    else
+    {
+        /* Prompt first - the actor keeps handling input meanwhile. Resumed also when the prompt is preempted
+           or could not be played, the audiobook may have been paused again or stopped by then. */
+        AudioTask* pausedAudioTask = pausedAudioTask_;
+        std::list<AudioTask::Element> prompt { unpausingPrompt };
+        co_await audioScheduler_.playAndWait(audioManager_, AudioScheduler::Priority::NAVIGATION, std::move(prompt), audioCommands_);
+        if (currentState_ != State::PLAYING || pausedAudioTask_ != pausedAudioTask) co_return;
+        resumePausedAudiobook();
+    }
+    BOOST_LOG_TRIVIAL(info) << "Audiobook resumed after " << std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - toggleStartTime).count() << " ms (prompt overlay: " << Config::getInstance().promptOverlay << ").";
+}
+
 void AudiobookPlayer::pauseToggle()
 {
     if (currentState_ == State::PAUSED || currentState_ == State::FAST_FORWARDING || currentState_ == State::REWINDING)
@@ -175,37 +306,32 @@ void AudiobookPlayer::pauseToggle()
             return;
         }
         BOOST_LOG_TRIVIAL(info) << "Toggling audiotrack pause: " << audioTracks_[currentTrackIndex_].getTrackName();
-        fastForwardingSpeed_ = 0;
-        if (fastForwardingTimerThread_.joinable()) fastForwardingTimerThread_.join();
+        auto toggleStartTime = std::chrono::steady_clock::now();
+        const int scrubbedPosition = stopScrubbing();
+        cancelPausedTimeout();
         changeStateTo(State::PLAYING);
-        pausedAudioTask_->seek(fastForwardedSeconds_ * 1000);
+        if (scrubbedPosition >= 0) pausedAudioTask_->seekTo(snapSeekPosition(scrubbedPosition));
         updateCurrentTrackInfo(pausedAudioTask_);
-        fastForwardedSeconds_ = 0;
-        play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("unpausing_audiobook") });
-        currentAudioTask_->waitForEnd();
-        if (pausedAudioTask_)
-        {
-            pausedAudioTask_->pauseToggle();
-            currentAudioTask_ = pausedAudioTask_;
-        }
-        pausedAudioTask_ = nullptr;
+        resumeFromPause(toggleStartTime);
     }
     else
     {
         if (!currentAudioTask_) return;
         if (!currentAudioTask_->isPausable()) return;
+        /* Audiobook just finished, its continuation is on the way */
+        const int position = currentAudioTask_->getCurrentTaskElementMilliseconds();
+        if (position < 0) return;
         BOOST_LOG_TRIVIAL(info) << "Toggling audiotrack pause: " << audioTracks_[currentTrackIndex_].getTrackName();
-        audioTracks_[currentTrackIndex_].setLastPlayedMillisecond(currentAudioTask_->getCurrentTaskElementMilliseconds());
+        audioTracks_[currentTrackIndex_].setLastPlayedMillisecond(position);
         saveTracksInfo();
-        fastForwardingSpeed_ = 0;
-        if (fastForwardingTimerThread_.joinable()) fastForwardingTimerThread_.join();
+        stopScrubbing();
         changeStateTo(State::PAUSED);
-        currentAudioTask_->seek(fastForwardedSeconds_ * 1000);
         updateCurrentTrackInfo(currentAudioTask_);
-        fastForwardedSeconds_ = 0;
-        if (currentAudioTask_) currentAudioTask_->pauseToggle();
+        currentAudioTask_->pauseToggle();
         pausedAudioTask_ = currentAudioTask_;
-        play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("pausing_audiobook") });
+        currentAudioTask_ = nullptr;
+        startPausedTimeout();
+        playPrompt({ voiceManager_.getVoiceMessage("pausing_audiobook") });
     }
 }
 
@@ -225,21 +351,58 @@ void AudiobookPlayer::loadTracks()
         filesystem::directory_iterator endIter;
         for (filesystem::directory_iterator dirItr(path); dirItr != endIter; ++dirItr)
         {
-            if (filesystem::is_regular_file(dirItr->status()))
+            if (filesystem::is_directory(dirItr->status()))
             {
+                /* Directory of numbered parts - one audiobook */
                 std::string trackName(dirItr->path().filename().c_str());
-                fileExtension = (trackName.length() > 4) ? trackName.substr(trackName.length() - 3, 3) : "";
+                if (MultiPartReader::listParts(dirItr->path().string()).empty()) continue;
+                audioTracks_.push_back(AudioTrack("../data/audiobooks/" + trackName, AudioTrack::Type::STANDARD));
+                BOOST_LOG_TRIVIAL(info) << trackName << " loaded (multi-part).";
+            }
+            else if (filesystem::is_regular_file(dirItr->status()))
+            {
+                std::string trackName(dirItr->path().filename().c_str());
+                fileExtension = dirItr->path().extension().string();
 
-                if (fileExtension == "mp3" || fileExtension == "wav")
+                if (fileExtension == ".mp3" || fileExtension == ".wav" || fileExtension == ".flac" || fileExtension == ".ogg"
+                    || fileExtension == ".oga" || fileExtension == ".opus")
                 {
-                    AudioTrack audioTrack("../data/audiobooks/" + trackName, Config::getInstance().volumeForAudiobooks, AudioTrack::Type::STANDARD);
-                    audioTracks_.push_back(audioTrack);
+                    AudioTrack audioTrack("../data/audiobooks/" + trackName, AudioTrack::Type::STANDARD);
+                    if (!audioTrack.isPlayable())
+                    {
+                        BOOST_LOG_TRIVIAL(error) << trackName << " skipped, " << AudioTrack::getFormatName(audioTrack.getFormat())
+                            << " is not supported by this build.";
+                        continue;
+                    }
+                    /* Both the original and its transcoded version exist while transcoding is being finished - wav wins */
+                    auto loadedTrack = std::find_if(audioTracks_.begin(), audioTracks_.end(),
+                        [&](const AudioTrack& loaded) { return loaded.getTrackName() == audioTrack.getTrackName(); });
+                    if (loadedTrack == audioTracks_.end()) audioTracks_.push_back(audioTrack);
+                    else if (audioTrack.isWav()) *loadedTrack = audioTrack;
                     BOOST_LOG_TRIVIAL(info) << trackName << " loaded.";
                 }
             }
         }
     }
     BOOST_LOG_TRIVIAL(info) << audioTracks_.size() << " audio tracks successfully loaded.";
+
+    std::vector<std::string> filePaths;
+    for (const AudioTrack& audioTrack : audioTracks_) filePaths.push_back(audioTrack.getFilePath());
+    LoudnessAnalyzer::getInstance().analyze(filePaths);
+    SilenceScanner::getInstance().scan(filePaths);
+    Transcoder::getInstance().transcode(filePaths, transcoderCommands_,
+        [this](const std::string& sourceFilePath, const std::string& transcodedFilePath) { onTrackTranscoded(sourceFilePath, transcodedFilePath); });
+}
+
+void AudiobookPlayer::onTrackTranscoded(const std::string& sourceFilePath, const std::string& transcodedFilePath)
+{
+    for (AudioTrack& audioTrack : audioTracks_)
+    {
+        /* Already playing tasks keep their open file, the transcoded one is used from the next play on */
+        if (audioTrack.getFilePath() == sourceFilePath) audioTrack.setFilePath(transcodedFilePath);
+    }
+    LoudnessAnalyzer::getInstance().analyze({ transcodedFilePath });
+    SilenceScanner::getInstance().scan({ transcodedFilePath });
 }
 
 void AudiobookPlayer::loadTracksInfo()
@@ -304,47 +467,54 @@ void AudiobookPlayer::synchronizeTracksInfo()
 
 void AudiobookPlayer::updateCurrentTrackInfo(AudioTask* audioTask)
 {
-    audioTracks_[currentTrackIndex_].setLastPlayedMillisecond(audioTask->getCurrentTaskElementMilliseconds());
+    /* Finished - the audiobook finished continuation rewinds the track */
+    const int position = audioTask->getCurrentTaskElementMilliseconds();
+    if (position < 0) return;
+    audioTracks_[currentTrackIndex_].setLastPlayedMillisecond(position);
     saveTracksInfo();
 }
 
-void AudiobookPlayer::switchToNextAudiobook()
+void AudiobookPlayer::switchToNextAudiobook(int nPresses)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (currentTrackIndex_ == audioTracks_.size() - 1)
-        currentTrackIndex_ = 0;
-    else
-        ++currentTrackIndex_;
-
-    if (currentAudioTask_) currentAudioTask_->stop();
-    play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("chosen_next"), 
-        voiceManager_.getSynthesizedVoiceAudioTracks().at(getCurrentTrack().getTrackName()) 
+    const int nTracks = (int)audioTracks_.size();
+    if (nTracks == 0) return;   /* Empty library, or no track could be loaded */
+    currentTrackIndex_ = (currentTrackIndex_ + nPresses) % nTracks;
+
+    /* Title announced by a previous switch is superseded, even if the navigation rule queues prompts */
+    audioScheduler_.stop(audioManager_, AudioScheduler::Priority::NAVIGATION);
+    playPrompt({ voiceManager_.getVoiceMessage("chosen_next"), 
+        voiceManager_.getVoiceMessage(getCurrentTrack().getTrackName()) 
         });
 }
 
-void AudiobookPlayer::switchToPreviousAudiobook()
+void AudiobookPlayer::switchToPreviousAudiobook(int nPresses)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (currentTrackIndex_ == 0)
-        currentTrackIndex_ = audioTracks_.size() - 1;  
-    else
-        --currentTrackIndex_;
+    const int nTracks = (int)audioTracks_.size();
+    if (nTracks == 0) return;
+    currentTrackIndex_ = ((currentTrackIndex_ - nPresses) % nTracks + nTracks) % nTracks;
 
-    if (currentAudioTask_) currentAudioTask_->stop();
-    play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("chosen_previous"), 
-        voiceManager_.getSynthesizedVoiceAudioTracks().at(getCurrentTrack().getTrackName()) 
+    audioScheduler_.stop(audioManager_, AudioScheduler::Priority::NAVIGATION);
+    playPrompt({ voiceManager_.getVoiceMessage("chosen_previous"), 
+        voiceManager_.getVoiceMessage(getCurrentTrack().getTrackName()) 
         });
 }
 
-std::vector< std::pair<InputManager::Button, std::function<void()> > > & AudiobookPlayer::getAvailableActions()
+void AudiobookPlayer::rewind(int nPresses)
 {
-    return availableActions_.at(currentState_);
+    const unsigned int scrubId = scrubId_;
+    for (int i = 0; i < nPresses; ++i) scrubStep(-1);
+    announceScrubbing(scrubId);
 }
 
-void AudiobookPlayer::rewind()
+void AudiobookPlayer::fastForward(int nPresses)
 {
-    std::unique_lock<std::mutex> lock(mutex_);
+    const unsigned int scrubId = scrubId_;
+    for (int i = 0; i < nPresses; ++i) scrubStep(1);
+    announceScrubbing(scrubId);
+}
 
+void AudiobookPlayer::scrubStep(int direction)
+{
     if (fastForwardingSpeed_ == 0)
     {
         AudioTask* checkedAudioTask = nullptr;
@@ -353,126 +523,110 @@ void AudiobookPlayer::rewind()
 
         if (!checkedAudioTask) return;
         if (!checkedAudioTask->isPausable()) return;
+        if (checkedAudioTask->getCurrentTaskElementMilliseconds() < 0) return;   /* Just finished */
         if (!checkedAudioTask->isPaused())
         {
             pausedAudioTask_ = currentAudioTask_;
+            currentAudioTask_ = nullptr;
             checkedAudioTask->pauseToggle();
             updateCurrentTrackInfo(checkedAudioTask);
         }
-        fastForwardingSpeed_ = -2;
-        changeStateTo(State::REWINDING);
-        lock.unlock();
-        if (fastForwardingTimerThread_.joinable())
-            fastForwardingTimerThread_.join();
-        lock.lock();
-        fastForwardingTimerThread_ = std::thread(&AudiobookPlayer::fastForwardingTimerFunction, this);
+        changeStateTo(direction > 0 ? State::FAST_FORWARDING : State::REWINDING);
+        cancelPausedTimeout();
+        startScrubbing(checkedAudioTask, 2 * direction);
     }
-    else if (fastForwardingSpeed_ == 2)
+    else if (fastForwardingSpeed_ == -2 * direction)
     {
-        fastForwardingSpeed_ = 0;
-        lock.unlock();
-        if (fastForwardingTimerThread_.joinable())
-            fastForwardingTimerThread_.join();
-        lock.lock();
-        currentAudioTask_ = pausedAudioTask_;
-        currentAudioTask_->seek(fastForwardedSeconds_ * 1000);
-        currentAudioTask_->pauseToggle();
-        updateCurrentTrackInfo(currentAudioTask_);
+        pausedAudioTask_->seekTo(snapSeekPosition(stopScrubbing()));
+        updateCurrentTrackInfo(pausedAudioTask_);
+        resumePausedAudiobook();
         changeStateTo(State::PLAYING);
     }
-    else if (fastForwardingSpeed_ < 0) fastForwardingSpeed_ *= 2;
-    else if (fastForwardingSpeed_ > 0) fastForwardingSpeed_ *= 0.5f;
+    /* Up to 128x either way */
+    else if ((fastForwardingSpeed_ > 0) == (direction > 0)) setScrubbingSpeed(std::max(-128, std::min(128, fastForwardingSpeed_ * 2)));
+    else setScrubbingSpeed(fastForwardingSpeed_ / 2);
 
-    /* lower value */
-    if (fastForwardingSpeed_ < -128) fastForwardingSpeed_ = -128;
+    BOOST_LOG_TRIVIAL(info) << "Set fast-forwarding speed to " << fastForwardingSpeed_;
+}
 
-    /* Playing appropriate voice messages */
-    if (fastForwardingSpeed_ == -2)
-    {
-        play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("rewinding"),
-            voiceManager_.getSynthesizedVoiceAudioTracks().at("2x") });
-    }
-    else if (fastForwardingSpeed_ != 0)
+void AudiobookPlayer::announceScrubbing(unsigned int scrubIdBefore)
+{
+    if (fastForwardingSpeed_ == 0) return;
+    AudioTrack& speedPrompt = voiceManager_.getVoiceMessage(std::to_string(std::abs(fastForwardingSpeed_)) + "x");
+    if (scrubId_ == scrubIdBefore)
     {
-        if (currentAudioTask_) currentAudioTask_->stop();
-        play({ voiceManager_.getSynthesizedVoiceAudioTracks().at(std::to_string(std::abs(fastForwardingSpeed_)) + "x") });
+        playPrompt({ speedPrompt });
+        return;
     }
+    /* Scrubbing (re)started - announced by the flow of the new scrub */
+    scrub(scrubId_, { voiceManager_.getVoiceMessage(fastForwardingSpeed_ > 0 ? "fast_forwarding" : "rewinding"),
+        speedPrompt });
+}
 
-    BOOST_LOG_TRIVIAL(info) << "Set fast-forwarding speed to " << fastForwardingSpeed_;
+void AudiobookPlayer::stopAudiobook()
+{
+    cancelPausedTimeout();
+    AudioTask* audiobookTask = currentAudioTask_ ? currentAudioTask_ : pausedAudioTask_;
+    if (audiobookTask) updateCurrentTrackInfo(audiobookTask);
+    audioScheduler_.stop(audioManager_, AudioScheduler::Priority::CONTENT);
+    currentAudioTask_ = nullptr;
+    pausedAudioTask_ = nullptr;
+    playPrompt( {voiceManager_.getVoiceMessage("stopping_audiobook")} );
+    BOOST_LOG_TRIVIAL(info) << "Audiobook stopped.";
+    currentState_ = State::CHOOSING;
 }
 
-void AudiobookPlayer::fastForward()
+void AudiobookPlayer::start()
 {
-    std::unique_lock<std::mutex> lock(mutex_);
+    mailbox_.start();
+}
 
-    if (fastForwardingSpeed_ == 0)
-    {
-        AudioTask* checkedAudioTask = nullptr;
-        if (currentState_ == State::PLAYING) checkedAudioTask = currentAudioTask_;
-        else if (currentState_ == State::PAUSED) checkedAudioTask = pausedAudioTask_;
+void AudiobookPlayer::onButtonPressed(InputManager::Button button)
+{
+    inputCommands_.post([this, button] { inputCoalescer_->press(button); });
+}
 
-        if (!checkedAudioTask) return;
-        if (!checkedAudioTask->isPausable()) return;
-        if (!checkedAudioTask->isPaused())
-        {
-            pausedAudioTask_ = currentAudioTask_;
-            checkedAudioTask->pauseToggle();
-            updateCurrentTrackInfo(checkedAudioTask);
-        }
-        fastForwardingSpeed_ = 2;
-        changeStateTo(State::FAST_FORWARDING);
-        lock.unlock();
-        if (fastForwardingTimerThread_.joinable())
-            fastForwardingTimerThread_.join();
-        lock.lock();
-        fastForwardingTimerThread_ = std::thread(&AudiobookPlayer::fastForwardingTimerFunction, this);
-    }
-    else if (fastForwardingSpeed_ == -2)
+void AudiobookPlayer::handleButton(InputManager::Button button, int nPresses)
+{
+    actions_.dispatch(*this, currentState_, button, nPresses);
+    if (button == InputManager::Button::BUTTON_X)
     {
-        fastForwardingSpeed_ = 0;
-        lock.unlock();
-        if (fastForwardingTimerThread_.joinable())
-            fastForwardingTimerThread_.join();
-        lock.lock();
-        currentAudioTask_ = pausedAudioTask_;
-        pausedAudioTask_->seek(fastForwardedSeconds_ * 1000);
-        currentAudioTask_->pauseToggle();
-        updateCurrentTrackInfo(currentAudioTask_);
-        changeStateTo(State::PLAYING);
+        printState();
+        mailbox_.printStats();
+        inputCoalescer_->printStats();
     }
-    else if (fastForwardingSpeed_ < 0) fastForwardingSpeed_ *= 0.5f;
-    else if (fastForwardingSpeed_ > 0) fastForwardingSpeed_ *= 2;
+}
 
-    /* Upper value */
-    if (fastForwardingSpeed_ > 128) fastForwardingSpeed_ = 128;
+void AudiobookPlayer::shutdown()
+{
+    /* Nothing may reach the player once it is destroyed, nor its code once an app plugin is unloaded. Loudness
+       and silence jobs only keep file paths, transcoder results and timers are the only callbacks. */
+    Transcoder::getInstance().cancel(transcoderCommands_);
+    mailbox_.send("shutdown", [this] { saveState(); });
+    mailbox_.stop();
+    timerWheel_.cancelAll(timerCommands_);
+}
 
-    /* Playing appropriate voice messages */
-    if (fastForwardingSpeed_ == 2)
-    {
-        play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("fast_forwarding"),
-            voiceManager_.getSynthesizedVoiceAudioTracks().at("2x") });
-    }
-    else if (fastForwardingSpeed_ != 0)
-    {
-        if (currentAudioTask_) currentAudioTask_->stop();
-        play({ voiceManager_.getSynthesizedVoiceAudioTracks().at(std::to_string(std::abs(fastForwardingSpeed_)) + "x") });
-    }
+void AudiobookPlayer::saveState()
+{
+    stopScrubbing();
+    cancelPausedTimeout();
+    AudioTask* audiobookTask = currentAudioTask_ ? currentAudioTask_ : pausedAudioTask_;
+    if (audiobookTask) updateCurrentTrackInfo(audiobookTask);
+    else saveTracksInfo();
+    BOOST_LOG_TRIVIAL(info) << "Audiobook player state saved.";
+}
 
-    BOOST_LOG_TRIVIAL(info) << "Set fast-forwarding speed to " << fastForwardingSpeed_;
+void AudiobookPlayer::increaseVolume(int nPresses)
+{
+    for (int i = 0; i < nPresses; ++i) audioManager_.increaseMasterVolume();
+    playPrompt({ voiceManager_.getVoiceMessage("volume_up") });
 }
 
-void AudiobookPlayer::stopAudiobook()
+void AudiobookPlayer::decreaseVolume(int nPresses)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (currentAudioTask_)
-    {
-        updateCurrentTrackInfo(currentAudioTask_);
-        currentAudioTask_->stop();
-    }
-    play( {voiceManager_.getSynthesizedVoiceAudioTracks().at("stopping_audiobook")} );
-    BOOST_LOG_TRIVIAL(info) << "Audiobook stopped.";
-    currentState_ = State::CHOOSING;
+    for (int i = 0; i < nPresses; ++i) audioManager_.decreaseMasterVolume();
+    playPrompt({ voiceManager_.getVoiceMessage("volume_down") });
 }
 
 void AudiobookPlayer::printState()
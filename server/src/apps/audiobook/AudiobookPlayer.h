@@ -1,71 +1,136 @@
 #pragma once
+#include "apps/DispatchTable.h"
 #include "systems/audio/AudioTrack.h"
 #include "systems/audio/AudioManager.h"
+#include "systems/audio/AudioScheduler.h"
 #include "systems/voice/VoiceManager.h"
+#include "systems/input/InputCoalescer.h"
 #include "systems/input/InputManager.h"
-#include <atomic>
-#include <thread>
-#include <mutex>
+#include "systems/executor/ActorExecutor.h"
+#include "systems/executor/Coroutine.h"
+#include "systems/executor/Executor.h"
+#include "systems/executor/TimerWheel.h"
+#include <chrono>
 #include <regex>
 
 namespace Pdb
 {
 
+/* Actor - everything but the constructor runs on its own thread, as commands taken from its mailbox: button presses,
+   timers, audio task completions and transcoder results. Its state is never touched by two threads, so it has no locks. */
 class AudiobookPlayer
 {
 public:
     enum class State {CHOOSING, PLAYING, REWINDING, FAST_FORWARDING, PAUSED};
+    static const size_t nStates = 5;
     
-    AudiobookPlayer(AudioManager& audioManager, VoiceManager& voiceManager);
+    AudiobookPlayer(AudioManager& audioManager, VoiceManager& voiceManager, AudioScheduler& audioScheduler, TimerWheel& timerWheel);
+
+    /* Commands sent before (e.g. transcoder results) wait for it */
+    void start();
+    /* May be called from any thread, the action available for the button in the current state runs on the actor thread */
+    void onButtonPressed(InputManager::Button button);
+    /* Saves the position of the played or paused audiobook and ends the actor thread, the app is being stopped.
+       Its timers and transcoder callbacks are cancelled once this returns. */
+    void shutdown();
+    /* May be called from any thread, buttons are mapped again on the actor thread when the input mode changed */
+    void onConfigReloaded(const Config& previous, const Config& current);
+
+    /* Only before start() */
+    AudioTrack& getCurrentTrack()                        { return audioTracks_[currentTrackIndex_]; }
+    std::vector<AudioTrack> & getAudioTracks()          { return audioTracks_; }
 
-    void switchToNextAudiobook();
-    void switchToPreviousAudiobook();
+private:
+    /* Runs the action of the button in the current state. Repeatable actions take the number of presses
+       of a burst (coalesced), announcing only where they ended up. */
+    void handleButton(InputManager::Button button, int nPresses);
+    /* Fills actions_ and creates inputCoalescer_ (its repeatable buttons) for the input mode */
+    void mapButtons(InputMode inputMode);
+    void switchToNextAudiobook(int nPresses);
+    void switchToPreviousAudiobook(int nPresses);
     void playChosenAudiobook();
     void pauseToggle();
-    void rewind();
-    void fastForward();
+    void rewind(int nPresses);
+    void fastForward(int nPresses);
     void stopAudiobook();
+    void increaseVolume(int nPresses);
+    void decreaseVolume(int nPresses);
+    void saveState();
 
-    void setCurrentAudioTask(AudioTask* audioTask) { currentAudioTask_ = audioTask; }
     void printState();
 
-    std::vector< std::pair<InputManager::Button, std::function<void()> > > & getAvailableActions();
-
-    AudioTrack& getCurrentTrack()                        { return audioTracks_[currentTrackIndex_]; }
-    std::vector<AudioTrack> & getAudioTracks()          { return audioTracks_; }
-
-private:
     void loadTracks();
+    /* Transcoder callback - the track keeps its name and resume position, only its file changes */
+    void onTrackTranscoded(const std::string& sourceFilePath, const std::string& transcodedFilePath);
     void loadTracksInfo();
     void saveTracksInfo();
     void synchronizeTracksInfo();
     void updateCurrentTrackInfo(AudioTask* audioTask);
-    void play(std::list<AudioTask::Element> audioTaskElements, std::function<void()> callbackFunction = {});
-
-    void fastForwardingTimerFunction();
+    /* Prompts go through the scheduler as navigation requests - a new prompt preempts the previous one */
+    void playPrompt(std::list<AudioTask::Element> audioTaskElements);
+
+    /* Rewinding and fast-forwarding (scrubbing) - the position is not advanced by any timer, it is projected
+       on demand as the position scrubbing started from plus speed times the time elapsed since */
+    void startScrubbing(AudioTask* audioTask, int speed);
+    /* One rewind (-1) or fast-forward (1) press: starts scrubbing, speeds it up or down, or stops it */
+    void scrubStep(int direction);
+    void announceScrubbing(unsigned int scrubIdBefore);
+    void setScrubbingSpeed(int speed);
+    int projectedPosition(std::chrono::steady_clock::time_point time) const;
+    /* Returns the position scrubbed to, -1 when not scrubbing */
+    int stopScrubbing();
+    /* Flow of one scrub: the announcement, then short snippets of the audiobook (previews) played at the projected
+       position until scrubbing stops - which any other scrubId_ than its own means */
+    Coroutine scrub(unsigned int scrubId, std::list<AudioTask::Element> announcement);
+    void endPreview();
+    /* Paused audiobook is stopped after AudiobookAudio.pausedTimeoutMinutes, its position is kept */
+    void startPausedTimeout();
+    void onPausedTimeout();
+    void cancelPausedTimeout();
+    void resumePausedAudiobook();
+    /* Flow of unpausing - with AudiobookAudio.promptOverlay off the prompt is awaited first */
+    Coroutine resumeFromPause(std::chrono::steady_clock::time_point toggleStartTime);
+    /* Seek position adjusted so that playback resumes where speech starts, after a pause (silence index) */
+    int snapSeekPosition(int positionInMilliseconds);
 
     void changeStateTo(State destinationState)          { currentState_ = destinationState; }
 
     AudioManager& audioManager_;
     VoiceManager& voiceManager_;
+    AudioScheduler& audioScheduler_;
+    TimerWheel& timerWheel_;
 
     int currentTrackIndex_;
     std::vector<AudioTrack> audioTracks_;
     std::vector<AudioTrack> audioTracksInfo_;
-    AudioTask* currentAudioTask_;
-    AudioTask* pausedAudioTask_;
+    AudioTask* currentAudioTask_;   /* Audiobook being played, nullptr when paused or choosing */
+    AudioTask* pausedAudioTask_;    /* Audiobook paused, rewound or fast-forwarded */
+    unsigned int audiobookId_;      /* Changes whenever an audiobook is started - tasks are pooled, pointers get reused */
 
-    int fastForwardingSpeed_;
-    std::atomic<int> fastForwardedSeconds_;
-    std::thread fastForwardingTimerThread_;
+    int fastForwardingSpeed_;       /* Negative when rewinding, 0 when not scrubbing */
+    int scrubBasePosition_;         /* Projected position (ms) at scrubBaseTime_, rebased on every speed change */
+    std::chrono::steady_clock::time_point scrubBaseTime_;
+    int scrubDuration_;             /* Of the scrubbed track, 0 when not known */
+    unsigned int scrubId_;          /* Changes whenever scrubbing starts or stops */
+    bool previewPlaying_;
+    TimerWheel::TimerId pausedTimeoutTimerId_;  /* 0 when not running */
 
-    std::unordered_map<State, std::vector< std::pair<InputManager::Button, std::function<void()> > > > availableActions_;
+    /* Filled in the constructor, by the input mode */
+    DispatchTable<AudiobookPlayer, State, nStates, int> actions_;
 
     State currentState_;
     std::vector<std::string> stateNames_ = {"choosing", "playing", "rewinding", "fast_forwarding", "paused"};
 
-    std::mutex mutex_;
     std::regex trackInfoPattern_;
+
+    std::unique_ptr<InputCoalescer> inputCoalescer_;    /* Its window timers are commands of the mailbox */
+
+    /* Last - destroyed first, so that no command runs on destroyed members */
+    ActorExecutor mailbox_;
+    Executor& inputCommands_;
+    Executor& timerCommands_;
+    Executor& audioCommands_;
+    Executor& transcoderCommands_;
 };
 
 }
\ No newline at end of file
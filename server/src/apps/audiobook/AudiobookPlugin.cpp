@@ -0,0 +1,5 @@
+#include "apps/AppPlugin.h"
+#include "AudiobookApp.h"
+
+/* Built only into the audiobook plugin (APP_PLUGINS), the server is then built without AudiobookApp */
+PDB_APP_PLUGIN(Pdb::AudiobookApp)
@@ -7,49 +7,88 @@
 namespace Pdb
 {
 
-ClockApp::ClockApp(VoiceManager& voiceManager)
-    : Pdb::App(voiceManager), currentAudioTask_(nullptr)
+ClockApp::ClockApp(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService)
+    : Pdb::App(voiceManager, audioScheduler, eventLoop, timerWheel, inputService)
 {
+    mapButtons(Config::getInstance().inputMode);
+}
+
+void ClockApp::onConfigReloaded(const Config& previous, const Config& current)
+{
+    if (current.inputMode != previous.inputMode) mapButtons(current.inputMode);
+}
+
+void ClockApp::mapButtons(InputMode inputMode)
+{
+    actions_.clear();
+    auto increaseVolume = [](ClockApp& app) { app.audioManager_.increaseMasterVolume(); };
+    auto decreaseVolume = [](ClockApp& app) { app.audioManager_.decreaseMasterVolume(); };
+    auto playDate = [](ClockApp& app) { app.playCurrentDate(); };
+    auto playTime = [](ClockApp& app) { app.playCurrentTime(); };
+
+    if (inputMode == InputMode::DEBUG)
+    {
+        actions_.set(0, InputManager::Button::BUTTON_UP, increaseVolume);
+        actions_.set(0, InputManager::Button::BUTTON_DOWN, decreaseVolume);
+        actions_.set(0, InputManager::Button::BUTTON_R, playDate);
+        actions_.set(0, InputManager::Button::BUTTON_T, playTime);
+    }
+    else if (inputMode == InputMode::PROD)
+    {
+        actions_.set(0, InputManager::Button::KeyKpAdd, increaseVolume);
+        actions_.set(0, InputManager::Button::KeyKpSubtract, decreaseVolume);
+        actions_.set(0, InputManager::Button::KeyKpMultiply, playDate);
+        actions_.set(0, InputManager::Button::KeyKpDivide, playTime);
+    }
 }
 
 void ClockApp::init()
 {
-    this->synthesizeClockReadings();
+    /* Just what the next two hours need, readings of other times and dates follow in lateInit() */
+    time_t sec = time(NULL);
+    tm result;
+    tm * currentTime = localtime_r(&sec, &result);
+    synthesizeTimeReadings(currentTime->tm_hour, currentTime->tm_hour);
+    synthesizeTimeReadings((currentTime->tm_hour + 1) % 24, (currentTime->tm_hour + 1) % 24);
+    synthesizeWeekdayReadings();
     BOOST_LOG_TRIVIAL(info) << "Initialized Clock.";
 }
 
-void ClockApp::synthesizeClockReadings()
+void ClockApp::lateInit()
 {
-    /* Synthesizing time readings */
-    auto timeSynthesizingFunction = [&](int hourFrom, int hourTo)
-    {
-        if (hourFrom > hourTo)
-            return;
+    this->synthesizeClockReadings();
+    BOOST_LOG_TRIVIAL(info) << (isInitCancelled() ? "Clock readings synthesizing cancelled." : "Synthesized all Clock readings.");
+}
+
+void ClockApp::synthesizeTimeReadings(int hourFrom, int hourTo)
+{
+    if (hourFrom > hourTo)
+        return;
 
-        for (int hour = hourFrom; hour <= hourTo; ++hour)
+    for (int hour = hourFrom; hour <= hourTo; ++hour)
+    {
+        if (isInitCancelled()) return;
+        if (hour == 0)
         {
-            if (hour == 0)
-            {
-                voiceManager_.synthesizeVoiceMessage("<speak>północ. </speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_0_0");
-                for (int minute = 1; minute < 60; ++minute)
-                    voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(minute) + " po północy. </speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_0_" + std::to_string(minute));
-            }
-            else
+            voiceManager_.synthesizeVoiceMessage("<speak>północ. </speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_0_0");
+            for (int minute = 1; minute < 60; ++minute)
+                voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(minute) + " po północy. </speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_0_" + std::to_string(minute));
+        }
+        else
+        {
+            for (int minute = 0; minute < 60; ++minute)
             {
-                for (int minute = 0; minute < 60; ++minute)
-                {
-                    if (minute < 10)
-                        voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(hour) + ":0" + std::to_string(minute) + "</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_" + std::to_string(hour) + "_" + std::to_string(minute));
-                    else
-                        voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(hour) + ":" + std::to_string(minute) + "</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_" + std::to_string(hour) + "_" + std::to_string(minute));
-                }
+                if (minute < 10)
+                    voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(hour) + ":0" + std::to_string(minute) + "</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_" + std::to_string(hour) + "_" + std::to_string(minute));
+                else
+                    voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(hour) + ":" + std::to_string(minute) + "</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/time_readings", "time_" + std::to_string(hour) + "_" + std::to_string(minute));
             }
         }
-    };
-
-    timeSynthesizingFunction(0, 23);
+    }
+}
 
-    /* Synthesizing weekday readings */
+void ClockApp::synthesizeWeekdayReadings()
+{
     voiceManager_.synthesizeVoiceMessage("<speak>niedziela.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/weekdays", "weekday_1");
     voiceManager_.synthesizeVoiceMessage("<speak>poniedziałek.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/weekdays", "weekday_2");
     voiceManager_.synthesizeVoiceMessage("<speak>wtorek.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/weekdays", "weekday_3");    
@@ -57,6 +96,13 @@ void ClockApp::synthesizeClockReadings()
     voiceManager_.synthesizeVoiceMessage("<speak>czwartek.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/weekdays", "weekday_5");
     voiceManager_.synthesizeVoiceMessage("<speak>piątek.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/weekdays", "weekday_6");
     voiceManager_.synthesizeVoiceMessage("<speak>sobota.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/weekdays", "weekday_7");
+}
+
+void ClockApp::synthesizeClockReadings()
+{
+    /* Synthesizing time readings, weekdays are synthesized by init() */
+    synthesizeTimeReadings(0, 23);
+    if (isInitCancelled()) return;
 
     /* Synthesizing day with month readings */
 
@@ -64,6 +110,7 @@ void ClockApp::synthesizeClockReadings()
 
     for (int dayIndex = 1; dayIndex <= 31; ++dayIndex)
     {
+        if (isInitCancelled()) return;
         std::string dayReadingStr;
         if ((dayIndex % 10 == 2 || dayIndex % 10 == 3) && dayIndex != 12 && dayIndex != 13)
             dayReadingStr = "<speak>" + std::to_string(dayIndex) + "-i ";
@@ -89,6 +136,7 @@ void ClockApp::synthesizeClockReadings()
     /* Synthesizing year readings */
     for (int yearIndex = 0; yearIndex <= 100; ++yearIndex)
     {
+        if (isInitCancelled()) return;
         if ((2019 + yearIndex) % 10 == 2 || (2019 + yearIndex) % 10 == 3)
             voiceManager_.synthesizeVoiceMessage("<speak>" + std::to_string(2019 + yearIndex) + "-i.</speak>", "../data/synthesized_sounds/apps/clock/readings/pl/date_readings/years", "year_" + std::to_string(2019 + yearIndex));
         else if ((2019 + yearIndex) % 10 == 4)
@@ -98,27 +146,9 @@ void ClockApp::synthesizeClockReadings()
     }
 }
 
-void ClockApp::appLoopFunction()
+void ClockApp::onButtonPressed(InputManager::Button button)
 {
-    while (true)
-    {   
-        inputManager_.update();
-
-        if (Config::getInstance().inputMode == "debug")
-        {
-            if (inputManager_.isButtonPressed(InputManager::Button::BUTTON_UP)) audioManager_.increaseMasterVolume();
-            if (inputManager_.isButtonPressed(InputManager::Button::BUTTON_DOWN)) audioManager_.decreaseMasterVolume();
-            if (inputManager_.isButtonPressed(InputManager::Button::BUTTON_R)) playCurrentDate();
-            if (inputManager_.isButtonPressed(InputManager::Button::BUTTON_T)) playCurrentTime();
-        }
-        else if (Config::getInstance().inputMode == "prod")
-        {
-            if (inputManager_.isButtonPressed(InputManager::Button::KeyKpAdd)) audioManager_.increaseMasterVolume();
-            if (inputManager_.isButtonPressed(InputManager::Button::KeyKpSubtract)) audioManager_.decreaseMasterVolume();
-            if (inputManager_.isButtonPressed(InputManager::Button::KeyKpMultiply)) playCurrentDate();
-            if (inputManager_.isButtonPressed(InputManager::Button::KeyKpDivide)) playCurrentTime();
-        }
-    }
+    actions_.dispatch(*this, 0, button);
 }
 
 void ClockApp::playCurrentTime()
@@ -127,12 +157,14 @@ void ClockApp::playCurrentTime()
     tm result;
     tm * currentTime = localtime_r(&sec, &result);
     BOOST_LOG_TRIVIAL(info) << "time_" + std::to_string(currentTime->tm_hour) + "_" + std::to_string(currentTime->tm_min);
-    if (currentAudioTask_)
-        currentAudioTask_->stop();
-
-    currentAudioTask_ = audioManager_.play({
-        voiceManager_.getSynthesizedVoiceAudioTracks().at("time_" + std::to_string(currentTime->tm_hour) + "_" + std::to_string(currentTime->tm_min))
-    });
+    AudioTrack* timeReading = voiceManager_.findVoiceMessage("time_" + std::to_string(currentTime->tm_hour) + "_" + std::to_string(currentTime->tm_min));
+    /* The clock is usable before all readings are synthesized (lateInit()) */
+    if (!timeReading)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "The time reading is not synthesized yet.";
+        return;
+    }
+    audioScheduler_.play(audioManager_, AudioScheduler::Priority::ALERT, { *timeReading });
 }
 
 void ClockApp::playCurrentDate()
@@ -140,12 +172,15 @@ void ClockApp::playCurrentDate()
     time_t sec = time(NULL);
     tm result;
     tm * currentTime = localtime_r(&sec, &result);
-    if (currentAudioTask_)
-        currentAudioTask_->stop();
-
-    currentAudioTask_ = audioManager_.play({ voiceManager_.getSynthesizedVoiceAudioTracks().at("weekday_" + std::to_string(currentTime->tm_wday + 1)),
-        voiceManager_.getSynthesizedVoiceAudioTracks().at("day_" + std::to_string(currentTime->tm_mday) + "_month_" + std::to_string(currentTime->tm_mon + 1)),
-        voiceManager_.getSynthesizedVoiceAudioTracks().at("year_" + std::to_string(currentTime->tm_year + 1900)) });
+    AudioTrack* weekdayReading = voiceManager_.findVoiceMessage("weekday_" + std::to_string(currentTime->tm_wday + 1));
+    AudioTrack* dayReading = voiceManager_.findVoiceMessage("day_" + std::to_string(currentTime->tm_mday) + "_month_" + std::to_string(currentTime->tm_mon + 1));
+    AudioTrack* yearReading = voiceManager_.findVoiceMessage("year_" + std::to_string(currentTime->tm_year + 1900));
+    if (!weekdayReading || !dayReading || !yearReading)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "The date readings are not synthesized yet.";
+        return;
+    }
+    audioScheduler_.play(audioManager_, AudioScheduler::Priority::ALERT, { *weekdayReading, *dayReading, *yearReading });
 }
 
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "apps/App.h"
+#include "apps/DispatchTable.h"
 
 namespace Pdb
 {
@@ -7,17 +8,24 @@ namespace Pdb
 class ClockApp : public App
 {
 public:
-    ClockApp(VoiceManager& voiceManager);
+    ClockApp(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService);
     void init() override;    
-    void appLoopFunction() override;
+    void lateInit() override;
+    void onButtonPressed(InputManager::Button button) override;
 
     void playCurrentTime();
     void playCurrentDate();
 
 private:
+    void onConfigReloaded(const Config& previous, const Config& current) override;
+    /* Fills actions_ for the input mode, again when it is changed in a reloaded config */
+    void mapButtons(InputMode inputMode);
+    void synthesizeTimeReadings(int hourFrom, int hourTo);
+    void synthesizeWeekdayReadings();
     void synthesizeClockReadings();
 
-    AudioTask * currentAudioTask_;
+    /* No states, the one row is filled by the input mode */
+    DispatchTable<ClockApp, int, 1> actions_;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,5 @@
+#include "apps/AppPlugin.h"
+#include "ClockApp.h"
+
+/* Built only into the clock plugin (APP_PLUGINS), the server is then built without ClockApp */
+PDB_APP_PLUGIN(Pdb::ClockApp)
@@ -5,8 +5,8 @@
 namespace Pdb
 {
 
-NetworkApp::NetworkApp(VoiceManager& voiceManager)
-    : App(voiceManager)
+NetworkApp::NetworkApp(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService)
+    : App(voiceManager, audioScheduler, eventLoop, timerWheel, inputService)
 {
     BOOST_LOG_TRIVIAL(info) << "Creating NetworkApp.";
 }
@@ -38,6 +38,9 @@ void NetworkApp::appLoopFunction()
         BOOST_LOG_TRIVIAL(error) << e.what();
     }
 
+    /* Nothing is served yet, posted jobs (input) are still handled until the app is stopped */
+    App::appLoopFunction();
+
     BOOST_LOG_TRIVIAL(info) << "Ending NetworkApp loop function.";
 }
 
@@ -7,7 +7,7 @@ namespace Pdb
 class NetworkApp : public App
 {
 public:
-    NetworkApp(VoiceManager& voiceManager);
+    NetworkApp(VoiceManager& voiceManager, AudioScheduler& audioScheduler, EventLoop& eventLoop, TimerWheel& timerWheel, InputService& inputService);
 
     void init();
     void appLoopFunction();
@@ -0,0 +1,5 @@
+#include "apps/AppPlugin.h"
+#include "NetworkApp.h"
+
+/* Built only into the network plugin (APP_PLUGINS), the server is then built without NetworkApp */
+PDB_APP_PLUGIN(Pdb::NetworkApp)
@@ -1,19 +1,25 @@
 #include "Server.h"
 #include "Config.h"
+#include "systems/executor/ThreadRole.h"
 
+#ifndef PDB_APP_PLUGINS
 #include "apps/network/NetworkApp.h"
 #include "apps/audiobook/AudiobookApp.h"
 #include "apps/clock/ClockApp.h"
+#endif
 
 #include "boost/log/trivial.hpp"
 #include "boost/log/utility/setup.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <iomanip>
 #include <string>
 
 int main(int argc, char* argv[])
 {
+    Pdb::Server::blockTerminationSignals();
+
     /* Initializing config file variables */
     Pdb::Config::getInstance();
 
@@ -36,28 +42,46 @@ int main(int argc, char* argv[])
         boost::log::keywords::auto_flush = true
     );
     boost::log::add_common_attributes();
-    boost::log::trivial::severity_level severityLevel;
-    std::string configLoggingLevel = Pdb::Config::getInstance().loggingLevel;
-
-    if (configLoggingLevel == "info") severityLevel = boost::log::trivial::info;
-    else if (configLoggingLevel == "debug") severityLevel = boost::log::trivial::debug;
-    else if (configLoggingLevel == "trace") severityLevel = boost::log::trivial::trace;
-    else
-    {
-        BOOST_LOG_TRIVIAL(error) << "Config: " << configLoggingLevel << " is a wrong loggingLevel value.";
-		exit(0);
-    }
-
     boost::log::core::get()->set_filter(
-        boost::log::trivial::severity >= severityLevel
+        boost::log::trivial::severity >= Pdb::Config::getInstance().loggingLevel
     );
 
+    /* Runs the server event loop. Threads created later (the AWS SDK's too) inherit its settings until they set up their own. */
+    Pdb::setUpCurrentThread(Pdb::ThreadRole::APP, "");
+
     /* Starting app */
     Pdb::Server server;
 
-    server.registerApp("network", std::make_unique<Pdb::NetworkApp>(server.getVoiceManager()));
-    server.registerApp("audiobook", std::make_unique<Pdb::AudiobookApp>(server.getVoiceManager()));
-    server.registerApp("clock", std::make_unique<Pdb::ClockApp>(server.getVoiceManager()));
+    /* Only the apps enabled in the config are created, the others cost nothing but their code */
+    for (const std::string& appName : Pdb::Config::getInstance().builtInApps)
+    {
+#ifdef PDB_APP_PLUGINS
+        BOOST_LOG_TRIVIAL(error) << "Config: " << appName << " is in Apps.builtIn, but the server was built with APP_PLUGINS - apps are plugins only.";
+        exit(0);
+#else
+        if (appName == "network")
+            server.registerApp("network", std::make_unique<Pdb::NetworkApp>(server.getVoiceManager(), server.getAudioScheduler(), server.getEventLoop(), server.getTimerWheel(), server.getInputService()));
+        else if (appName == "audiobook")
+            server.registerApp("audiobook", std::make_unique<Pdb::AudiobookApp>(server.getVoiceManager(), server.getAudioScheduler(), server.getEventLoop(), server.getTimerWheel(), server.getInputService()));
+        else if (appName == "clock")
+            server.registerApp("clock", std::make_unique<Pdb::ClockApp>(server.getVoiceManager(), server.getAudioScheduler(), server.getEventLoop(), server.getTimerWheel(), server.getInputService()));
+        else
+        {
+            BOOST_LOG_TRIVIAL(error) << "Config: " << appName << " is a wrong Apps.builtIn value (expected network, audiobook or clock).";
+            exit(0);
+        }
+#endif
+    }
+    for (const Pdb::AppPluginConfig& appPluginConfig : Pdb::Config::getInstance().appPlugins)
+    {
+        const std::vector<std::string>& builtInApps = Pdb::Config::getInstance().builtInApps;
+        if (std::find(builtInApps.begin(), builtInApps.end(), appPluginConfig.name) != builtInApps.end())
+        {
+            BOOST_LOG_TRIVIAL(error) << "Config: " << appPluginConfig.name << " is both in Apps.builtIn and Apps.plugins.";
+            exit(0);
+        }
+        server.registerAppPlugin(appPluginConfig);
+    }
 
     server.run();
     
@@ -3,6 +3,9 @@
 #include <thread>
 
 #include "Config.h"
+#ifdef PDB_WITH_AUDIO_ENGINE
+#include "systems/audio/engine/AudioEngineClient.h"
+#endif
 
 #include <future>
 #include <memory>
@@ -10,16 +13,17 @@
 namespace Pdb
 {
 
-AudioManager::AudioManager(const size_t nMp3AudioStreams, const size_t nWavAudioStreams) : masterVolume_(Config::getInstance().masterVolume)
+AudioManager::AudioManager(std::atomic<int>& nPlayingOverlays, const size_t nMp3AudioStreams, const size_t nDecodedAudioStreams)
+    : masterVolume_(Config::getInstance().masterVolume), nPlayingOverlays_(nPlayingOverlays)
 {
     BOOST_LOG_TRIVIAL(info) << "Creating AudioManager app. Initializing " << nMp3AudioStreams << " mp3 audio streams and " << 
-        nWavAudioStreams << " wav audio streams.";
+        nDecodedAudioStreams << " decoded audio streams (wav, flac, ogg).";
     for (int i = 0; i < nMp3AudioStreams; ++i)
-        mp3AudioStreams_.push_back(std::make_unique<AudioStreamMp3>(masterVolume_));
-    for (int i = 0; i < nWavAudioStreams; ++i)
-        wavAudioStreams_.push_back(std::make_unique<AudioStreamWav>(masterVolume_));
+        mp3AudioStreams_.push_back(std::make_unique<AudioStreamMp3>(masterVolume_, nPlayingOverlays_));
+    for (int i = 0; i < nDecodedAudioStreams; ++i)
+        decodedAudioStreams_.push_back(std::make_unique<AudioStreamDecoded>(masterVolume_, nPlayingOverlays_));
 
-    for (int i = 0; i < nMp3AudioStreams + nWavAudioStreams; ++i)
+    for (int i = 0; i < nMp3AudioStreams + nDecodedAudioStreams; ++i)
         audioTaskPool_.push_back(std::make_unique<AudioTask>());
 }
 
@@ -61,9 +65,16 @@ AudioTask* AudioManager::play(std::list<AudioTask::Element> audioTaskElements, s
     }
 }
 
-int AudioManager::getFreeWavAudioStreamCount() const
+int AudioManager::getFreeAudioTaskCount() const
+{
+    return std::count_if(audioTaskPool_.begin(), audioTaskPool_.end(),
+        [](auto& audioTask){ return audioTask->isAvailable(); }
+    );
+}
+
+int AudioManager::getFreeDecodedAudioStreamCount() const
 { 
-    return std::count_if(wavAudioStreams_.begin(), wavAudioStreams_.end(), 
+    return std::count_if(decodedAudioStreams_.begin(), decodedAudioStreams_.end(), 
         [this](auto& stream){ return stream->isAvailable(); }
     );
 }
@@ -93,10 +104,13 @@ void AudioManager::printAllStreamsInfo() const
     {
         BOOST_LOG_TRIVIAL(info) << "mp3 stream isAvailable=" << stream->isAvailable() << " " << stream->getPlayedAudioTrackName();
     }
-    for (auto& stream : wavAudioStreams_)
+    for (auto& stream : decodedAudioStreams_)
     {
-        BOOST_LOG_TRIVIAL(info) << "wav stream isAvailable=" << stream->isAvailable();
+        BOOST_LOG_TRIVIAL(info) << "decoded stream isAvailable=" << stream->isAvailable();
     }
+#ifdef PDB_WITH_AUDIO_ENGINE
+    if (Config::getInstance().audioBackend == AudioBackend::REMOTE) AudioEngineClient::getInstance().printStats();
+#endif
 }
 
 
@@ -128,15 +142,16 @@ AudioStream* AudioManager::findFreeStream(const AudioTrack& audioTrack)
             if (stream->isAvailable()) 
                 { foundStream = stream.get(); break; }
     }
-    else if (audioTrack.isWav())
+    else if (audioTrack.isPlayable())
     {
-        for (auto& stream : wavAudioStreams_) 
+        for (auto& stream : decodedAudioStreams_) 
             if (stream->isAvailable())
                 { foundStream = stream.get(); break; }
     }
     else
     {
-        BOOST_LOG_TRIVIAL(error) << "Unknown audio track format. Aborting. Returning empty stream. " << audioTrack.getFilePath();
+        BOOST_LOG_TRIVIAL(error) << "Unsupported audio track format (" << AudioTrack::getFormatName(audioTrack.getFormat())
+            << "). Aborting. Returning empty stream. " << audioTrack.getFilePath();
         return foundStream;
     }
 
@@ -147,7 +162,7 @@ AudioStream* AudioManager::findFreeStream(const AudioTrack& audioTrack)
     else
     {
         BOOST_LOG_TRIVIAL(error) << "No free audio stream found. Current free mp3 audio stream count: " << getFreeMp3AudioStreamCount()
-            << ". Current free wav audio stream count: " << getFreeWavAudioStreamCount();
+            << ". Current free decoded audio stream count: " << getFreeDecodedAudioStreamCount();
     }
     return foundStream;
 }
@@ -10,7 +10,7 @@
 
 #include "systems/audio/AudioStream.h"
 #include "systems/audio/AudioStreamMp3.h"
-#include "systems/audio/AudioStreamWav.h"
+#include "systems/audio/AudioStreamDecoded.h"
 #include "systems/audio/AudioTrack.h"
 #include "systems/audio/AudioTask.h"
 
@@ -20,15 +20,24 @@ namespace Pdb
 class AudioManager
 {
 public:
-    AudioManager(const size_t nMp3AudioStreams = 7, const size_t nWavAudioStreams = 0);
+    /* nPlayingOverlays is shared by the audio managers of all apps (AudioScheduler::getPlayingOverlayCount()), so that
+       a prompt of any app ducks the content of every other */
+    explicit AudioManager(std::atomic<int>& nPlayingOverlays, const size_t nMp3AudioStreams = 7, const size_t nDecodedAudioStreams = 2);
 
 
     AudioTask* play(std::list<AudioTask::Element> audioTaskElements, std::function<void()> callbackFunction = {});
 
     size_t getMp3AudioStreamCount() const { return mp3AudioStreams_.size(); }
     int getFreeMp3AudioStreamCount() const;
-    int getFreeWavAudioStreamCount() const;
+    /* Streams of all the other formats (wav, flac, ogg vorbis, opus) */
+    size_t getDecodedAudioStreamCount() const { return decodedAudioStreams_.size(); }
+    int getFreeDecodedAudioStreamCount() const;
 
+    size_t getAudioTaskCount() const { return audioTaskPool_.size(); }
+    /* Tasks not playing anymore - all of them before the manager may be destroyed */
+    int getFreeAudioTaskCount() const;
+
+    void setMasterVolume(float masterVolume) { masterVolume_ = masterVolume; }
     void increaseMasterVolume();
     void decreaseMasterVolume();
 
@@ -40,9 +49,10 @@ private:
 
     std::vector<std::unique_ptr<AudioTask>> audioTaskPool_;
     std::vector< std::unique_ptr<AudioStreamMp3> > mp3AudioStreams_;
-    std::vector< std::unique_ptr<AudioStreamWav> > wavAudioStreams_;
+    std::vector< std::unique_ptr<AudioStreamDecoded> > decodedAudioStreams_;
 
     std::atomic<float> masterVolume_;
+    std::atomic<int>& nPlayingOverlays_;
     std::mutex mutex_;
 };
 
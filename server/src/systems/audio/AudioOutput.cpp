@@ -0,0 +1,27 @@
+#include "AudioOutput.h"
+#include "AudioOutputRtAudio.h"
+#include "AudioOutputNull.h"
+#ifdef PDB_WITH_AUDIO_ENGINE
+#include "AudioOutputRemote.h"
+#endif
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace Pdb
+{
+
+std::unique_ptr<AudioOutput> AudioOutput::create()
+{
+    const Config& config = Config::getInstance();
+    if (config.audioBackend == AudioBackend::RTAUDIO) return std::make_unique<AudioOutputRtAudio>();
+    if (config.audioBackend == AudioBackend::NULL_OUTPUT) return std::make_unique<AudioOutputNull>(config.nullAudioBackendRealtime);
+#ifdef PDB_WITH_AUDIO_ENGINE
+    if (config.audioBackend == AudioBackend::REMOTE) return std::make_unique<AudioOutputRemote>();
+#endif
+
+    BOOST_LOG_TRIVIAL(error) << "Config: AudioEngine.backend is remote, but the server was built without the audio engine.";
+    exit(0);
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "RtAudio.h"
+#include <memory>
+
+namespace Pdb
+{
+
+/* Destination of the PCM produced by an AudioStream. Mirrors the subset of RtAudio used by streams
+   so that streams do not care whether they play to a sound card or somewhere else. */
+class AudioOutput
+{
+public:
+    virtual ~AudioOutput() { };
+
+    virtual void open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+        RtAudioCallback callback, void* userData) = 0;
+    virtual void start() = 0;
+    virtual void abort() = 0;
+    virtual void close() = 0;
+
+    virtual bool isOpen() const = 0;
+    virtual bool isRunning() const = 0;
+
+    /* Creates output of the type selected in config (AudioEngine.backend) */
+    static std::unique_ptr<AudioOutput> create();
+};
+
+}
@@ -0,0 +1,97 @@
+#include "AudioOutputNull.h"
+#include "systems/executor/ThreadRole.h"
+#include <chrono>
+
+namespace Pdb
+{
+
+namespace
+{
+
+size_t bytesPerSample(RtAudioFormat format)
+{
+    if (format == RTAUDIO_SINT8) return 1;
+    if (format == RTAUDIO_SINT16) return 2;
+    if (format == RTAUDIO_SINT24) return 3;
+    if (format == RTAUDIO_FLOAT64) return 8;
+    return 4;   /* RTAUDIO_SINT32, RTAUDIO_FLOAT32 */
+}
+
+}
+
+std::atomic<unsigned long> AudioOutputNull::nStartedRuns_(0);
+
+AudioOutputNull::AudioOutputNull(bool realtime) : realtime_(realtime), nChannels_(0), sampleRate_(0), bufferFrames_(0),
+    callback_(nullptr), userData_(nullptr), open_(false), running_(false)
+{
+}
+
+AudioOutputNull::~AudioOutputNull()
+{
+    close();
+}
+
+void AudioOutputNull::open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+    RtAudioCallback callback, void* userData)
+{
+    nChannels_ = nChannels;
+    sampleRate_ = sampleRate;
+    bufferFrames_ = *bufferFrames;
+    callback_ = callback;
+    userData_ = userData;
+    buffer_.assign(bufferFrames_ * nChannels_ * bytesPerSample(format), 0);
+    open_ = true;
+}
+
+void AudioOutputNull::start()
+{
+    if (!open_) return;
+    /* Previous run might have just been ended by its callback and its thread not be finished yet */
+    running_ = false;
+    joinCallbackThread();
+    running_ = true;
+    callbackThread_ = std::thread(&AudioOutputNull::callbackThreadFunction, this);
+}
+
+void AudioOutputNull::abort()
+{
+    running_ = false;
+    joinCallbackThread();
+}
+
+void AudioOutputNull::close()
+{
+    abort();
+    open_ = false;
+}
+
+void AudioOutputNull::joinCallbackThread()
+{
+    if (!callbackThread_.joinable()) return;
+    if (callbackThread_.get_id() == std::this_thread::get_id()) callbackThread_.detach();   /* closed from its own callback */
+    else callbackThread_.join();
+}
+
+void AudioOutputNull::callbackThreadFunction()
+{
+    setUpCurrentThread(ThreadRole::AUDIO, "audio-null");
+    const auto bufferDuration = std::chrono::duration<double>((double)bufferFrames_ / sampleRate_);
+    auto nextCallbackTime = std::chrono::steady_clock::now();
+    double streamTime = 0.0;
+
+    while (running_)
+    {
+        int callbackResult = callback_(buffer_.data(), nullptr, bufferFrames_, streamTime, 0, userData_);
+        if (streamTime == 0.0) ++nStartedRuns_;
+        streamTime += bufferDuration.count();
+        if (callbackResult != 0) break;
+        if (realtime_)
+        {
+            nextCallbackTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(bufferDuration);
+            std::this_thread::sleep_until(nextCallbackTime);
+        }
+    }
+    running_ = false;
+}
+
+}
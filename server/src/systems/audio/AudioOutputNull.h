@@ -0,0 +1,52 @@
+#pragma once
+#include "systems/audio/AudioOutput.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Output without a device - a thread pulls PCM from the stream callback and discards it.
+   In realtime mode callbacks are paced like a sound card would pace them, otherwise
+   the stream is drained as fast as it can produce samples (benchmarks, headless units). */
+class AudioOutputNull : public AudioOutput
+{
+public:
+    AudioOutputNull(bool realtime);
+    ~AudioOutputNull();
+
+    void open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+        RtAudioCallback callback, void* userData) override;
+    void start() override;
+    void abort() override;
+    void close() override;
+
+    bool isOpen() const override { return open_; }
+    bool isRunning() const override { return running_; }
+
+    /* Number of runs, across all null outputs, whose first buffer was filled by the stream callback -
+       lets benchmarks measure how long a stream takes to start playing */
+    static unsigned long getStartedRunCount() { return nStartedRuns_; }
+
+private:
+    void callbackThreadFunction();
+    void joinCallbackThread();
+
+    bool realtime_;
+    unsigned int nChannels_;
+    unsigned int sampleRate_;
+    unsigned int bufferFrames_;
+    RtAudioCallback callback_;
+    void* userData_;
+    std::vector<char> buffer_;
+
+    std::atomic<bool> open_;
+    std::atomic<bool> running_;
+    std::thread callbackThread_;
+
+    static std::atomic<unsigned long> nStartedRuns_;
+};
+
+}
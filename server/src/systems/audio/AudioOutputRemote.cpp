@@ -0,0 +1,138 @@
+#include "AudioOutputRemote.h"
+#include "systems/audio/engine/AudioEngineClient.h"
+#include "Config.h"
+#include "systems/executor/ThreadRole.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Pdb
+{
+
+AudioOutputRemote::AudioOutputRemote() : channel_(nullptr), channelIndex_(0), bufferFrames_(0), callback_(nullptr), userData_(nullptr),
+    running_(false)
+{
+}
+
+AudioOutputRemote::~AudioOutputRemote()
+{
+    close();
+}
+
+void AudioOutputRemote::open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+    RtAudioCallback callback, void* userData)
+{
+    if (format != RTAUDIO_SINT16)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Remote audio output supports 16-bit samples only.";
+        return;
+    }
+    if (!channel_) channel_ = AudioEngineClient::getInstance().allocateChannel(channelIndex_);
+    if (!channel_) return;
+
+    bufferFrames_ = *bufferFrames;
+    callback_ = callback;
+    userData_ = userData;
+    buffer_.assign(bufferFrames_ * nChannels, 0);
+
+    const size_t ringFrames = (size_t)sampleRate * Config::getInstance().remoteRingMilliseconds / 1000;
+    channel_->sampleRate = sampleRate;
+    channel_->nChannels = nChannels;
+    channel_->bufferFrames = bufferFrames_;
+    channel_->capacityFrames = std::max<size_t>(2 * bufferFrames_, std::min(ringFrames, SharedAudio::maxChannelSamples / nChannels));
+    channel_->isDraining = false;
+    /* New track starts after everything written so far, the engine skips what is left of the previous one */
+    channel_->startFrame.store(channel_->writeFrame.load());
+    channel_->state.store(SharedAudio::ChannelState::OPEN, std::memory_order_release);
+    AudioEngineClient::getInstance().sendCommand(SharedAudio::CommandType::OPEN, channelIndex_);
+}
+
+void AudioOutputRemote::start()
+{
+    if (!channel_) return;
+    /* Previous run might have just been ended by its callback and its thread not be finished yet */
+    running_ = false;
+    joinProducerThread();
+    running_ = true;
+    channel_->isDraining = false;
+    channel_->state.store(SharedAudio::ChannelState::RUNNING, std::memory_order_release);
+    AudioEngineClient::getInstance().sendCommand(SharedAudio::CommandType::START, channelIndex_);
+    producerThread_ = std::thread(&AudioOutputRemote::producerThreadFunction, this);
+}
+
+void AudioOutputRemote::abort()
+{
+    running_ = false;
+    joinProducerThread();
+    if (channel_ && channel_->state == SharedAudio::ChannelState::RUNNING)
+    {
+        channel_->state.store(SharedAudio::ChannelState::OPEN, std::memory_order_release);
+        AudioEngineClient::getInstance().sendCommand(SharedAudio::CommandType::STOP, channelIndex_);
+    }
+}
+
+void AudioOutputRemote::close()
+{
+    abort();
+    if (!channel_) return;
+    channel_->state.store(SharedAudio::ChannelState::FREE, std::memory_order_release);
+    AudioEngineClient::getInstance().sendCommand(SharedAudio::CommandType::CLOSE, channelIndex_);
+    AudioEngineClient::getInstance().releaseChannel(channelIndex_);
+    channel_ = nullptr;
+}
+
+AudioOutputRemote::Stats AudioOutputRemote::getStats() const
+{
+    if (!channel_) return Stats {};
+    const uint64_t nCallbacks = channel_->nCallbacks;
+    return Stats { nCallbacks, channel_->nUnderruns,
+        nCallbacks ? (double)channel_->totalJitterMicroseconds / nCallbacks : 0.0, (double)channel_->maxJitterMicroseconds };
+}
+
+void AudioOutputRemote::joinProducerThread()
+{
+    if (!producerThread_.joinable()) return;
+    if (producerThread_.get_id() == std::this_thread::get_id()) producerThread_.detach();   /* closed from its own callback */
+    else producerThread_.join();
+}
+
+void AudioOutputRemote::producerThreadFunction()
+{
+    setUpCurrentThread(ThreadRole::AUDIO, "audio-producer");
+    const unsigned int nChannels = channel_->nChannels;
+    const uint64_t capacityFrames = channel_->capacityFrames;
+    const auto bufferDuration = std::chrono::duration<double>((double)bufferFrames_ / channel_->sampleRate);
+    double streamTime = 0.0;
+
+    while (running_)
+    {
+        const uint64_t writeFrame = channel_->writeFrame.load(std::memory_order_relaxed);
+        const uint64_t readFrame = std::max(channel_->readFrame.load(std::memory_order_acquire), channel_->startFrame.load());
+        if (writeFrame - readFrame + bufferFrames_ > capacityFrames)
+        {
+            std::this_thread::sleep_for(bufferDuration / 2);
+            continue;
+        }
+
+        const int callbackResult = callback_(buffer_.data(), nullptr, bufferFrames_, streamTime, 0, userData_);
+        streamTime += bufferDuration.count();
+
+        /* Ring holds whole frames, a buffer may wrap around its end */
+        const uint64_t ringFrame = writeFrame % capacityFrames;
+        const uint64_t nFirstFrames = std::min<uint64_t>(bufferFrames_, capacityFrames - ringFrame);
+        std::memcpy(channel_->samples + ringFrame * nChannels, buffer_.data(), nFirstFrames * nChannels * sizeof(int16_t));
+        std::memcpy(channel_->samples, buffer_.data() + nFirstFrames * nChannels, (bufferFrames_ - nFirstFrames) * nChannels * sizeof(int16_t));
+        channel_->writeFrame.store(writeFrame + bufferFrames_, std::memory_order_release);
+
+        if (callbackResult != 0)
+        {
+            channel_->isDraining = true;
+            break;
+        }
+    }
+    running_ = false;
+}
+
+}
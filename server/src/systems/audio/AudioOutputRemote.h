@@ -0,0 +1,56 @@
+#pragma once
+#include "systems/audio/AudioOutput.h"
+#include "systems/audio/engine/SharedAudioMemory.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Plays through the out-of-process audio engine. A producer thread calls the stream callback whenever the
+   shared memory ring has room for a buffer, so the ring (AudioEngine.remoteRingMilliseconds) absorbs stalls of
+   this process - the device is fed by the engine and only underruns once the ring runs dry. */
+class AudioOutputRemote : public AudioOutput
+{
+public:
+    struct Stats
+    {
+        uint64_t nCallbacks;
+        uint64_t nUnderruns;
+        double averageJitterMicroseconds;
+        double maxJitterMicroseconds;
+    };
+
+    AudioOutputRemote();
+    ~AudioOutputRemote();
+
+    void open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+        RtAudioCallback callback, void* userData) override;
+    void start() override;
+    void abort() override;
+    void close() override;
+
+    bool isOpen() const override { return channel_ != nullptr; }
+    bool isRunning() const override { return running_; }
+
+    /* Device side statistics, kept by the engine */
+    Stats getStats() const;
+
+private:
+    void producerThreadFunction();
+    void joinProducerThread();
+
+    SharedAudio::Channel* channel_;
+    uint32_t channelIndex_;
+    unsigned int bufferFrames_;
+    RtAudioCallback callback_;
+    void* userData_;
+    std::vector<int16_t> buffer_;
+
+    std::atomic<bool> running_;
+    std::thread producerThread_;
+};
+
+}
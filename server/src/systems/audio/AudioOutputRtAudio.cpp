@@ -0,0 +1,62 @@
+#include "AudioOutputRtAudio.h"
+#include "systems/executor/ThreadRole.h"
+#include <boost/log/trivial.hpp>
+
+namespace Pdb
+{
+
+AudioOutputRtAudio::AudioOutputRtAudio() : callback_(nullptr), userData_(nullptr)
+{
+    rtAudio_ = std::make_unique<RtAudio>();
+    int nDevices = rtAudio_->getDeviceCount();
+    if (nDevices < 1) {
+        BOOST_LOG_TRIVIAL(error) << "No audio devices found!";
+        exit(0);
+    }
+    parameters_.deviceId = rtAudio_->getDefaultOutputDevice();
+}
+
+void AudioOutputRtAudio::open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+    RtAudioCallback callback, void* userData)
+{
+    parameters_.nChannels = nChannels;
+    parameters_.firstChannel = 0;
+    callback_ = callback;
+    userData_ = userData;
+    rtAudio_->openStream(&parameters_, NULL, format, sampleRate, bufferFrames, &AudioOutputRtAudio::deviceCallback, this);
+}
+
+void AudioOutputRtAudio::start()
+{
+    rtAudio_->startStream();
+}
+
+void AudioOutputRtAudio::abort()
+{
+    rtAudio_->abortStream();
+}
+
+void AudioOutputRtAudio::close()
+{
+    rtAudio_->closeStream();
+}
+
+bool AudioOutputRtAudio::isOpen() const
+{
+    return rtAudio_->isStreamOpen();
+}
+
+bool AudioOutputRtAudio::isRunning() const
+{
+    return rtAudio_->isStreamRunning();
+}
+
+int AudioOutputRtAudio::deviceCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime,
+    RtAudioStreamStatus status, void* userData)
+{
+    setUpCurrentThreadOnce(ThreadRole::AUDIO, "audio-out");
+    AudioOutputRtAudio* output = static_cast<AudioOutputRtAudio*>(userData);
+    return output->callback_(outputBuffer, inputBuffer, nBufferFrames, streamTime, status, output->userData_);
+}
+
+}
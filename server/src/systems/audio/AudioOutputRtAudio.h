@@ -0,0 +1,33 @@
+#pragma once
+#include "systems/audio/AudioOutput.h"
+
+namespace Pdb
+{
+
+/* Plays to the default output device through RtAudio (every stream opens its own device stream) */
+class AudioOutputRtAudio : public AudioOutput
+{
+public:
+    AudioOutputRtAudio();
+
+    void open(unsigned int nChannels, unsigned int sampleRate, RtAudioFormat format, unsigned int* bufferFrames,
+        RtAudioCallback callback, void* userData) override;
+    void start() override;
+    void abort() override;
+    void close() override;
+
+    bool isOpen() const override;
+    bool isRunning() const override;
+
+private:
+    /* Sets the device thread created by RtAudio up (audio role) on its first call, then calls callback_ */
+    static int deviceCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime,
+        RtAudioStreamStatus status, void* userData);
+
+    std::unique_ptr<RtAudio> rtAudio_;
+    RtAudio::StreamParameters parameters_;
+    RtAudioCallback callback_;
+    void* userData_;
+};
+
+}
@@ -0,0 +1,219 @@
+#include "AudioScheduler.h"
+#include "Config.h"
+#include "systems/executor/Coroutine.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+
+namespace Pdb
+{
+
+AudioScheduler::AudioScheduler() : nextRequestId_(0), nPlayingOverlays_(0), dispatcher_(1, ThreadRole::APP, "scheduler")
+{
+    rules_[static_cast<size_t>(Priority::ALERT)] = Config::getInstance().alertSchedulingRule;
+    rules_[static_cast<size_t>(Priority::NAVIGATION)] = Config::getInstance().navigationSchedulingRule;
+    rules_[static_cast<size_t>(Priority::CONTENT)] = Config::getInstance().contentSchedulingRule;
+}
+
+AudioTask* AudioScheduler::play(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements)
+{
+    return play(audioManager, priority, std::move(audioTaskElements), nullptr, {});
+}
+
+AudioTask* AudioScheduler::play(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements,
+    Executor& executor, std::function<void()> continuation)
+{
+    return play(audioManager, priority, std::move(audioTaskElements), &executor, std::move(continuation));
+}
+
+AudioTask* AudioScheduler::play(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements,
+    Executor* executor, std::function<void()> continuation)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    Request request { nextRequestId_++, &audioManager, priority, std::move(audioTaskElements),
+        executor, std::move(continuation), std::chrono::steady_clock::now() };
+
+    Channel& channel = channelFor(priority);
+    refreshActive(channel);
+    /* The lock is released while a preempted task stops - another request may have become active meanwhile */
+    while (channel.activeTask)
+    {
+        switch (ruleFor(priority, channel.activeRequest.priority))
+        {
+            case Rule::PREEMPT:
+                BOOST_LOG_TRIVIAL(debug) << "Audio scheduler: " << priorityName(priority) << " request preempts "
+                    << priorityName(channel.activeRequest.priority) << " request.";
+                ++stats_[static_cast<size_t>(channel.activeRequest.priority)].nPreempted;
+                stopActive(channel, lock);
+                break;
+            case Rule::QUEUE:
+                enqueue(channel, std::move(request));
+                return nullptr;
+            case Rule::DROP:
+            default:
+                BOOST_LOG_TRIVIAL(debug) << "Audio scheduler: dropping " << priorityName(priority) << " request.";
+                ++stats_[static_cast<size_t>(priority)].nDropped;
+                complete(request);
+                return nullptr;
+        }
+    }
+    return start(channel, std::move(request));
+}
+
+void AudioScheduler::Playing::await_suspend(std::coroutine_handle<> handle)
+{
+    audioScheduler_.play(audioManager_, priority_, std::move(audioTaskElements_), executor_, Resumption(handle));
+}
+
+void AudioScheduler::stop(AudioManager& audioManager, Priority priority)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    Channel& channel = channelFor(priority);
+
+    auto matches = [&](const Request& request) { return request.audioManager == &audioManager && request.priority == priority; };
+    for (auto it = channel.queuedRequests.begin(); it != channel.queuedRequests.end(); )
+    {
+        if (matches(*it))
+        {
+            complete(*it);
+            it = channel.queuedRequests.erase(it);
+        }
+        else ++it;
+    }
+
+    if (channel.activeTask && matches(channel.activeRequest)) stopActive(channel, lock);
+    refreshActive(channel);
+}
+
+void AudioScheduler::printStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < nPriorities; ++i)
+    {
+        const Stats& stats = stats_[i];
+        const double averageDelayMilliseconds = stats.nStarted ? stats.totalQueueingDelay.count() / 1000.0 / stats.nStarted : 0.0;
+        BOOST_LOG_TRIVIAL(info) << "Audio scheduler " << priorityName(static_cast<Priority>(i))
+            << ": started " << stats.nStarted << ", queued " << stats.nQueued << ", dropped " << stats.nDropped
+            << ", preempted " << stats.nPreempted << ", queueing delay avg " << averageDelayMilliseconds
+            << " ms, max " << stats.maxQueueingDelay.count() / 1000.0 << " ms";
+    }
+}
+
+AudioScheduler::Rule AudioScheduler::ruleFor(Priority requested, Priority active) const
+{
+    if (requested < active) return Rule::PREEMPT;
+    const Rule rule = rules_[static_cast<size_t>(requested)];
+    if (requested == active) return rule;
+    return (rule == Rule::DROP) ? Rule::DROP : Rule::QUEUE;
+}
+
+const char* AudioScheduler::priorityName(Priority priority)
+{
+    switch (priority)
+    {
+        case Priority::ALERT: return "alert";
+        case Priority::NAVIGATION: return "navigation";
+        case Priority::CONTENT: return "content";
+    }
+    return "unknown";
+}
+
+AudioTask* AudioScheduler::start(Channel& channel, Request request)
+{
+    Stats& stats = stats_[static_cast<size_t>(request.priority)];
+    const auto queueingDelay = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - request.submitTime);
+    ++stats.nStarted;
+    stats.totalQueueingDelay += queueingDelay;
+    stats.maxQueueingDelay = std::max(stats.maxQueueingDelay, queueingDelay);
+
+    const unsigned long requestId = request.id;
+    AudioTask* task = request.audioManager->play(request.audioTaskElements,
+        [this, requestId] { dispatcher_.post([this, requestId] { onTaskFinished(requestId); }); });
+    if (!task)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Audio scheduler: could not start " << priorityName(request.priority) << " request, no free audio stream.";
+        complete(request);
+        return nullptr;
+    }
+
+    /* Tasks are pooled - the finished task of the other channel might have just been reused */
+    Channel& otherChannel = (&channel == &promptChannel_) ? contentChannel_ : promptChannel_;
+    if (otherChannel.activeTask == task)
+    {
+        otherChannel.activeTask = nullptr;
+        complete(otherChannel.activeRequest);
+        startQueued(otherChannel);
+    }
+
+    channel.activeTask = task;
+    channel.activeGeneration = task->getGeneration();
+    channel.activeRequest = std::move(request);
+    return task;
+}
+
+void AudioScheduler::startQueued(Channel& channel)
+{
+    while (!channel.activeTask && !channel.queuedRequests.empty())
+    {
+        Request request = std::move(channel.queuedRequests.front());
+        channel.queuedRequests.pop_front();
+        start(channel, std::move(request));
+    }
+}
+
+void AudioScheduler::enqueue(Channel& channel, Request request)
+{
+    ++stats_[static_cast<size_t>(request.priority)].nQueued;
+    auto position = std::find_if(channel.queuedRequests.begin(), channel.queuedRequests.end(),
+        [&](const Request& queued) { return queued.priority > request.priority; });
+    channel.queuedRequests.insert(position, std::move(request));
+}
+
+void AudioScheduler::stopActive(Channel& channel, std::unique_lock<std::mutex>& lock)
+{
+    if (!channel.activeTask) return;
+    AudioTask* task = channel.activeTask;
+    const unsigned int generation = channel.activeGeneration;
+    Request request = std::move(channel.activeRequest);
+    channel.activeTask = nullptr;
+
+    /* Stopping waits for the streams to stop their outputs - not under the lock all apps and the dispatcher need */
+    lock.unlock();
+    task->stop(generation);
+    lock.lock();
+    complete(request);
+}
+
+void AudioScheduler::complete(Request& request)
+{
+    if (request.executor && request.continuation) request.executor->post(std::move(request.continuation));
+    request.continuation = {};
+}
+
+void AudioScheduler::refreshActive(Channel& channel)
+{
+    /* Task may have finished before its completion was dispatched */
+    if (channel.activeTask && channel.activeTask->isAvailable())
+    {
+        channel.activeTask = nullptr;
+        complete(channel.activeRequest);
+    }
+    startQueued(channel);
+}
+
+void AudioScheduler::onTaskFinished(unsigned long requestId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Channel* channel : { &promptChannel_, &contentChannel_ })
+    {
+        if (channel->activeTask && channel->activeRequest.id == requestId)
+        {
+            channel->activeTask = nullptr;
+            complete(channel->activeRequest);
+            startQueued(*channel);
+        }
+    }
+}
+
+}
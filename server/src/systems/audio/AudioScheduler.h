@@ -0,0 +1,136 @@
+#pragma once
+#include "Config.h"
+#include "systems/audio/AudioManager.h"
+#include "systems/executor/Executor.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+
+namespace Pdb
+{
+
+/* Single entry point for playing audio, shared by all apps. Every request has a priority class:
+ *  - ALERT and NAVIGATION requests are prompts, only one prompt plays at a time. A prompt of a higher class
+ *    always preempts a lower one. Against the active prompt of the same class the rule configured for the
+ *    class applies (preempt, queue or drop). A lower class request is queued or dropped (preempt means queue).
+ *  - CONTENT requests (audiobooks) have a channel of their own, the content rule applies against the active
+ *    content. Prompts never stop content, they are played on top of it (ducking).
+ * Continuations passed with a request are posted to the given executor exactly once, when the request
+ * finishes, is preempted, stopped, dropped or fails to start - so they must check the state they act upon. */
+class AudioScheduler
+{
+public:
+    enum class Priority { ALERT, NAVIGATION, CONTENT };
+    using Rule = AudioSchedulingRule;
+
+    AudioScheduler();
+
+    /* Returns the started task or nullptr if the request was queued, dropped or could not be started */
+    AudioTask* play(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements);
+    AudioTask* play(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements,
+        Executor& executor, std::function<void()> continuation);
+
+    /* Awaitable of playAndWait() */
+    class Playing
+    {
+    public:
+        Playing(AudioScheduler& audioScheduler, AudioManager& audioManager, Priority priority,
+            std::list<AudioTask::Element> audioTaskElements, Executor& executor)
+            : audioScheduler_(audioScheduler), audioManager_(audioManager), priority_(priority),
+            audioTaskElements_(std::move(audioTaskElements)), executor_(executor) { }
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept { }
+
+    private:
+        AudioScheduler& audioScheduler_;
+        AudioManager& audioManager_;
+        Priority priority_;
+        std::list<AudioTask::Element> audioTaskElements_;
+        Executor& executor_;
+    };
+    /* co_await audioScheduler.playAndWait(...) - the coroutine is resumed on executor whenever the continuation
+       of the request would run, not only when it finished playing */
+    Playing playAndWait(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements, Executor& executor)
+    {
+        return Playing(*this, audioManager, priority, std::move(audioTaskElements), executor);
+    }
+
+    /* Stops active and queued requests of the given class played through audioManager */
+    void stop(AudioManager& audioManager, Priority priority);
+
+    /* Voice messages playing through any audio manager, content streams are ducked while it is above 0 */
+    std::atomic<int>& getPlayingOverlayCount() { return nPlayingOverlays_; }
+
+    void printStats() const;
+
+private:
+    static const size_t nPriorities = 3;
+
+    struct Request
+    {
+        unsigned long id;
+        AudioManager* audioManager;
+        Priority priority;
+        std::list<AudioTask::Element> audioTaskElements;
+        Executor* executor;
+        std::function<void()> continuation;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    struct Channel
+    {
+        AudioTask* activeTask = nullptr;
+        unsigned int activeGeneration = 0;      /* Run of activeTask started for activeRequest */
+        Request activeRequest;
+        std::deque<Request> queuedRequests;     /* Ordered by priority, then by submit time */
+    };
+
+    struct Stats
+    {
+        unsigned long nStarted = 0;
+        unsigned long nQueued = 0;
+        unsigned long nDropped = 0;
+        unsigned long nPreempted = 0;
+        std::chrono::microseconds totalQueueingDelay { 0 };
+        std::chrono::microseconds maxQueueingDelay { 0 };
+    };
+
+    Channel& channelFor(Priority priority) { return (priority == Priority::CONTENT) ? contentChannel_ : promptChannel_; }
+    Rule ruleFor(Priority requested, Priority active) const;
+    static const char* priorityName(Priority priority);
+
+    AudioTask* play(AudioManager& audioManager, Priority priority, std::list<AudioTask::Element> audioTaskElements,
+        Executor* executor, std::function<void()> continuation);
+    AudioTask* start(Channel& channel, Request request);
+    void startQueued(Channel& channel);
+    void enqueue(Channel& channel, Request request);
+    /* Detaches the active task and stops it with mutex_ (held by lock) released, the channel must be
+       re-checked afterwards */
+    void stopActive(Channel& channel, std::unique_lock<std::mutex>& lock);
+    void complete(Request& request);
+    void refreshActive(Channel& channel);
+    void onTaskFinished(unsigned long requestId);
+
+    std::array<Rule, nPriorities> rules_;
+    std::array<Stats, nPriorities> stats_;
+    Channel promptChannel_;
+    Channel contentChannel_;
+    unsigned long nextRequestId_;
+    std::atomic<int> nPlayingOverlays_;
+
+    mutable std::mutex mutex_;
+    /* Finished tasks are handled here, never on the audio sequencer thread that reports them (lock order) */
+    ThreadPoolExecutor dispatcher_;
+};
+
+}
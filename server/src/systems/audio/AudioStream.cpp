@@ -1,19 +1,20 @@
 #include "AudioStream.h"
 #include <boost/log/trivial.hpp>
 
+#include "Config.h"
+
 namespace Pdb
 {
 
-AudioStream::AudioStream(std::atomic<float>& masterVolume) : masterVolume_(masterVolume), state_(State::AVAILABLE),
-    playedAudioTrack_(nullptr)
+#ifdef PDB_BENCH_HOOKS
+std::atomic<unsigned long> AudioStream::nDuckedBuffers_(0);
+#endif
+
+AudioStream::AudioStream(std::atomic<float>& masterVolume, std::atomic<int>& nPlayingOverlays) : masterVolume_(masterVolume), state_(State::AVAILABLE),
+    playedAudioTrack_(nullptr), volumeTrack_(nullptr), volumeConfig_(nullptr), nPlayingOverlays_(nPlayingOverlays), isOverlay_(false),
+    duckingGain_(Config::getInstance().duckingGain), duckingStep_(1.0f), currentDuckingGain_(1.0f)
 {
-    rtAudio_ = std::make_unique<RtAudio>();
-    int nDevices = rtAudio_->getDeviceCount();
-    if (nDevices < 1) {
-        BOOST_LOG_TRIVIAL(error) << "No audio devices found!";
-        exit(0);
-    }
-    parameters_.deviceId = rtAudio_->getDefaultOutputDevice();
+    output_ = AudioOutput::create();
 }
 
 void AudioStream::waitForEnd()
@@ -23,6 +24,29 @@ void AudioStream::waitForEnd()
     BOOST_LOG_TRIVIAL(info) << "Finished waiting for AudioStream end.";
 }
 
+void AudioStream::setFinishedCallback(std::function<void()> finishedCallback)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    finishedCallback_ = std::move(finishedCallback);
+}
+
+void AudioStream::notifyFinished()
+{
+    if (effectChain_) effectChain_->printStats(getPlayedAudioTrackName());
+    finishedPlayingCondVar_.notify_all();
+    std::function<void()> finishedCallback;
+    finishedCallback.swap(finishedCallback_);
+    if (finishedCallback) finishedCallback();
+}
+
+void AudioStream::prepareEffectChain()
+{
+    const Config& config = Config::getInstance();
+    const bool isVoiceMessage = playedAudioTrack_ && playedAudioTrack_->isVoiceMessage();
+    effectChain_ = EffectChain::create(isVoiceMessage ? config.voiceEffects : config.audiobookEffects, config.masterEffects,
+        sampleRate_, nChannels_);
+}
+
 bool AudioStream::isPausable() const
 {
     if (playedAudioTrack_) return playedAudioTrack_->isStandard();
@@ -36,17 +60,34 @@ void AudioStream::pauseToggle()
     if(state_ == State::PAUSED)
     {
         BOOST_LOG_TRIVIAL(info) << "Resuming stream: " << playedAudioTrack_->getTrackName();
-        rtAudio_->startStream();
+        output_->start();
         state_ = State::PLAYING;
     }
     else
     {
         BOOST_LOG_TRIVIAL(info) << "Pausing stream: " << playedAudioTrack_->getTrackName();
         state_ = State::PAUSED;
-        rtAudio_->abortStream();
+        output_->abort();
     }
 }
 
+void AudioStream::beginOverlay()
+{
+    if (!isOverlay_.exchange(true)) ++nPlayingOverlays_;
+}
+
+void AudioStream::endOverlay()
+{
+    if (isOverlay_.exchange(false)) --nPlayingOverlays_;
+}
+
+void AudioStream::resetDucking(unsigned int sampleRate)
+{
+    int rampMilliseconds = Config::getInstance().duckingRampMilliseconds;
+    duckingStep_ = (rampMilliseconds > 0) ? 1000.0f / (rampMilliseconds * (float)sampleRate) : 1.0f;
+    currentDuckingGain_ = duckingTargetGain();
+}
+
 void AudioStream::reserve()
 {
     if (state_ == State::AVAILABLE) state_ = State::RESERVED;
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "RtAudio.h"
+#include "Config.h"
 #include "systems/audio/AudioTrack.h"
+#include "systems/audio/AudioOutput.h"
+#include "systems/audio/dsp/EffectChain.h"
 
 #include <boost/log/trivial.hpp>
 #include <future>
 #include <mutex>
 #include <condition_variable>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 
 namespace Pdb
 {
@@ -14,7 +20,7 @@ namespace Pdb
 class AudioStream
 {
 public:
-    AudioStream(std::atomic<float>& masterVolume);
+    AudioStream(std::atomic<float>& masterVolume, std::atomic<int>& nPlayingOverlays);
     virtual ~AudioStream() { };
 
     virtual void play() = 0;
@@ -23,14 +29,20 @@ public:
     virtual int playCallback(void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames, double streamTime, RtAudioStreamStatus status) = 0;
 
     virtual void seek(int offsetInSeconds) = 0;
+    /* Absolute, unlike seek() - exact however many seeks were requested before */
+    virtual void seekTo(int positionInMilliseconds) = 0;
 
     virtual int currentPositionInMilliseconds() = 0;
+    /* Of the played track, 0 when not known */
+    virtual int durationInMilliseconds() = 0;
 
     void setPlayedAudioTrack(AudioTrack* playedAudioTrack) { playedAudioTrack_ = playedAudioTrack; }
 
     std::string getPlayedAudioTrackName() const {  if(playedAudioTrack_) return playedAudioTrack_->getTrackName(); else return std::string(""); }
 
     void waitForEnd();
+    /* One-shot callback invoked (from the audio thread) when the stream finishes or is stopped. Must not block. */
+    void setFinishedCallback(std::function<void()> finishedCallback);
 
     void pauseToggle();
 
@@ -43,21 +55,80 @@ public:
     void setVolume(float value) { volume_ = value; }
     float getVolume() const { return volume_; }
 
+    bool isOverlay() const { return isOverlay_; }
+
+#ifdef PDB_BENCH_HOOKS
+    /* Number of buffers, across all streams, filled with a ducked target gain - lets benchmarks measure how
+       long a prompt takes to duck the content played (benchmark builds only) */
+    static unsigned long getDuckedBufferCount() { return nDuckedBuffers_; }
+#endif
+
 protected:
     enum class State { AVAILABLE, RESERVED, PLAYING, PAUSED };
 
     AudioTrack* playedAudioTrack_;
     
     std::condition_variable finishedPlayingCondVar_;
+    std::function<void()> finishedCallback_;
+    /* To be called with mutex_ held after the stream became available */
+    void notifyFinished();
 
-    std::unique_ptr<RtAudio> rtAudio_;
-    RtAudio::StreamParameters parameters_;
+    std::unique_ptr<AudioOutput> output_;
+    unsigned int nChannels_;
     unsigned int sampleRate_;
     unsigned int bufferFrames_;
 
+    /* To be called once sampleRate_ and nChannels_ of the played track are known, before the output is opened */
+    void prepareEffectChain();
+    std::unique_ptr<EffectChain> effectChain_;     /* nullptr when bypassed */
+
+    /* Voice messages played over a standard track are overlays - while any of them is playing, through any
+       audio manager, standard tracks are ducked (their gain is smoothly lowered to duckingGain_) */
+    void beginOverlay();
+    void endOverlay();
+    void resetDucking(unsigned int sampleRate);
+    float nextDuckingGain(float targetGain)
+    {
+        if (currentDuckingGain_ < targetGain) currentDuckingGain_ = std::min(targetGain, currentDuckingGain_ + duckingStep_);
+        else if (currentDuckingGain_ > targetGain) currentDuckingGain_ = std::max(targetGain, currentDuckingGain_ - duckingStep_);
+        return currentDuckingGain_;
+    }
+    float duckingTargetGain() const { return (isPausable() && nPlayingOverlays_ > 0) ? duckingGain_ : 1.0f; }
+    /* Once per buffer filled by a stream callback - a no-op unless built with PDB_BENCH_HOOKS */
+    static void countDuckedBuffer(float duckingTargetGain)
+    {
+#ifdef PDB_BENCH_HOOKS
+        if (duckingTargetGain < 1.0f) nDuckedBuffers_.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    /* Volume of the track played (see AudioTrack::getVolume), as of the current config snapshot */
+    void updateVolume(const AudioTrack& audioTrack)
+    {
+        volumeTrack_ = &audioTrack;
+        volumeConfig_ = &Config::getInstance();
+        volume_ = audioTrack.getVolume();
+    }
+    /* Once per buffer - one atomic load, the volume is recomputed only after the config was reloaded */
+    void followConfigVolume()
+    {
+        if (volumeTrack_ && &Config::getInstance() != volumeConfig_) updateVolume(*volumeTrack_);
+    }
+
     State state_;
     std::atomic<float>& masterVolume_;
     float volume_;
+    const AudioTrack* volumeTrack_;
+    const Config* volumeConfig_;
+
+    std::atomic<int>& nPlayingOverlays_;
+    std::atomic<bool> isOverlay_;
+    float duckingGain_;
+    float duckingStep_;
+    float currentDuckingGain_;
+#ifdef PDB_BENCH_HOOKS
+    static std::atomic<unsigned long> nDuckedBuffers_;
+#endif
     
     std::mutex mutex_;
 };
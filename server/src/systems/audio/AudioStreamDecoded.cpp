@@ -0,0 +1,186 @@
+#include "AudioStreamDecoded.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+namespace Pdb
+{
+
+namespace
+{
+    const long long noPendingSeek = -1;
+}
+
+AudioStreamDecoded::AudioStreamDecoded(std::atomic<float>& masterVolume, std::atomic<int>& nPlayingOverlays) : AudioStream(masterVolume, nPlayingOverlays),
+    format_(AudioTrack::Format::UNKNOWN), nPlayedFrames_(0), pendingSeekFrame_(noPendingSeek)
+{
+
+}
+
+bool AudioStreamDecoded::openFile(const AudioTrack& audioTrack)
+{
+    /* Readers are kept between tracks of the same format */
+    if (!reader_ || format_ != audioTrack.getFormat())
+    {
+        reader_ = SampleReader::create(audioTrack.getFormat());
+        format_ = audioTrack.getFormat();
+    }
+    if (!reader_ || !reader_->open(audioTrack.getFilePath()))
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not open " << AudioTrack::getFormatName(audioTrack.getFormat()) << " file: " << audioTrack.getFilePath();
+        return false;
+    }
+    nChannels_ = reader_->getChannelCount();
+    sampleRate_ = reader_->getSampleRate();
+    bufferFrames_ = 256;
+    nPlayedFrames_ = 0;
+    pendingSeekFrame_ = noPendingSeek;
+    return true;
+}
+
+void AudioStreamDecoded::play()
+{
+    state_ = State::PLAYING;
+    updateVolume(*playedAudioTrack_);
+
+    if (!openFile(*playedAudioTrack_))
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_ = State::AVAILABLE;
+        notifyFinished();
+        return;
+    }
+    resetDucking(sampleRate_);
+    prepareEffectChain();
+    if (playedAudioTrack_->isVoiceMessage()) beginOverlay();
+
+    BOOST_LOG_TRIVIAL(info) << "Playing " << AudioTrack::getFormatName(format_) << " audio stream. Rate: " << sampleRate_
+        << ", channels: " << nChannels_;
+    BOOST_LOG_TRIVIAL(info) << "Audio track played: " << playedAudioTrack_->getTrackName();
+    if (output_->isOpen()) output_->close();
+    output_->open(nChannels_, sampleRate_, RTAUDIO_SINT16, &bufferFrames_, &playCb, (void *) this);
+    /* Buffer size is known only after opening the output */
+    readBuffer_.resize(bufferFrames_ * nChannels_);
+    if (playedAudioTrack_->getLastPlayedMillisecond() > 0)
+        seek(playedAudioTrack_->getLastPlayedMillisecond());
+    output_->start();
+}
+
+void AudioStreamDecoded::play(const AudioTrack& audioTrack)
+{
+    updateVolume(audioTrack);
+
+    if (!openFile(audioTrack)) return;
+    resetDucking(sampleRate_);
+
+    if (output_->isOpen()) output_->close();
+    output_->open(nChannels_, sampleRate_, RTAUDIO_SINT16, &bufferFrames_, &playCb, (void *) this);
+    readBuffer_.resize(bufferFrames_ * nChannels_);
+    if (audioTrack.getLastPlayedMillisecond() > 0)
+        seek(audioTrack.getLastPlayedMillisecond());
+    output_->start();
+}
+
+void AudioStreamDecoded::stop()
+{
+    /* Closed before locking - closing waits for a running callback, which may itself be waiting for mutex_ */
+    if (output_->isOpen()) output_->close();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (reader_) reader_->close();
+    endOverlay();
+    state_ = State::AVAILABLE;
+    notifyFinished();
+}
+
+int AudioStreamDecoded::playCallback(void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames,
+         double streamTime, RtAudioStreamStatus status)
+{
+    const long long seekFrame = pendingSeekFrame_.exchange(noPendingSeek);
+    if (seekFrame != noPendingSeek)
+    {
+        reader_->seekToFrame(seekFrame);
+        nPlayedFrames_ = reader_->getFramePosition();
+    }
+
+    int16_t* outBuffer = static_cast<int16_t*>(outputBuffer);
+    const size_t nBufferSamples = nBufferFrames * nChannels_;
+    if (readBuffer_.size() < nBufferSamples) readBuffer_.resize(nBufferSamples);
+    const size_t nSamples = reader_->read(readBuffer_.data(), nBufferSamples);
+    const size_t nFrames = nSamples / nChannels_;
+
+    if (effectChain_) effectChain_->process(readBuffer_.data(), nSamples);
+
+    followConfigVolume();
+    const float duckingTargetGain = this->duckingTargetGain();
+    countDuckedBuffer(duckingTargetGain);
+    const float gain = volume_ * masterVolume_;
+    float* samples = readBuffer_.data();
+    for (size_t frame = 0; frame < nFrames; ++frame)
+    {
+        const float frameGain = gain * nextDuckingGain(duckingTargetGain);
+        for (unsigned int channel = 0; channel < nChannels_; ++channel) *samples++ *= frameGain;
+    }
+    DspKernels::floatToInt16(readBuffer_.data(), outBuffer, nSamples);
+    std::fill(outBuffer + nSamples, outBuffer + nBufferSamples, 0);
+    nPlayedFrames_ += nFrames;
+
+    if (nFrames < nBufferFrames)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BOOST_LOG_TRIVIAL(info) << "Finished playing " << AudioTrack::getFormatName(format_) << " audio stream.";
+        if (reader_) reader_->close();
+        endOverlay();
+        state_ = State::AVAILABLE;
+        notifyFinished();
+        return 1;
+    }
+
+    return 0;
+}
+
+int AudioStreamDecoded::currentPositionInMilliseconds()
+{
+    if (sampleRate_ == 0) return 0;
+    const long long seekFrame = pendingSeekFrame_;
+    const long long frame = (seekFrame != noPendingSeek) ? seekFrame : nPlayedFrames_.load();
+    return (int)(frame * 1000 / sampleRate_);
+}
+
+int AudioStreamDecoded::durationInMilliseconds()
+{
+    if (sampleRate_ == 0 || !reader_) return 0;
+    return (int)(reader_->getFrameCount() * 1000 / sampleRate_);
+}
+
+void AudioStreamDecoded::seek(int offsetInMilliseconds)
+{
+    if (sampleRate_ == 0 || !reader_) return;
+    /* Relative like the mp3 stream - offsets accumulate when seeking again before the callback applied the last seek */
+    const long long currentFrame = (pendingSeekFrame_ != noPendingSeek) ? pendingSeekFrame_.load() : nPlayedFrames_.load();
+    const long long targetFrame = std::max(0LL, currentFrame + (long long)offsetInMilliseconds * sampleRate_ / 1000);
+
+    BOOST_LOG_TRIVIAL(info) << "Seeking " << AudioTrack::getFormatName(format_) << " audio stream by " << offsetInMilliseconds << " ms to frame " << targetFrame;
+    seekToFrame(targetFrame);
+}
+
+void AudioStreamDecoded::seekTo(int positionInMilliseconds)
+{
+    if (sampleRate_ == 0 || !reader_) return;
+    const long long targetFrame = std::max(0LL, (long long)positionInMilliseconds * sampleRate_ / 1000);
+
+    BOOST_LOG_TRIVIAL(info) << "Seeking " << AudioTrack::getFormatName(format_) << " audio stream to " << positionInMilliseconds << " ms (frame " << targetFrame << ")";
+    seekToFrame(targetFrame);
+}
+
+void AudioStreamDecoded::seekToFrame(long long frame)
+{
+    if (output_->isRunning()) pendingSeekFrame_ = frame;
+    else
+    {
+        /* Callback not running (paused or not started yet) - safe to seek right away */
+        pendingSeekFrame_ = noPendingSeek;
+        reader_->seekToFrame(frame);
+        nPlayedFrames_ = reader_->getFramePosition();
+    }
+}
+
+}
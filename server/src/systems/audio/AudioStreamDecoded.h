@@ -0,0 +1,42 @@
+#pragma once
+#include "systems/audio/AudioStream.h"
+#include "systems/audio/SampleReader.h"
+#include <vector>
+
+namespace Pdb
+{
+
+/* Plays every format read through a SampleReader (wav, flac, ogg vorbis, opus). The file is streamed from disk,
+   so besides short prompts it plays whole audiobooks - with seeking, position tracking, volume and ducking like
+   the mp3 stream. */
+class AudioStreamDecoded : public AudioStream
+{
+public:
+    AudioStreamDecoded(std::atomic<float>& masterVolume, std::atomic<int>& nPlayingOverlays);
+
+    void play() override;
+    void stop() override;
+    void play(const AudioTrack& audioTrack) override;
+    int playCallback(void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames, 
+        double streamTime, RtAudioStreamStatus status) override;
+
+    int currentPositionInMilliseconds() override;
+    int durationInMilliseconds() override;
+
+    void seek(int offsetInMilliseconds) override;
+    void seekTo(int positionInMilliseconds) override;
+
+private:
+    bool openFile(const AudioTrack& audioTrack);
+    void seekToFrame(long long frame);
+
+    std::unique_ptr<SampleReader> reader_;
+    AudioTrack::Format format_;
+    std::vector<float> readBuffer_;
+
+    std::atomic<long long> nPlayedFrames_;
+    /* Seeks are requested from other threads and applied by the audio callback, which owns reader_ while playing */
+    std::atomic<long long> pendingSeekFrame_;
+};
+
+}
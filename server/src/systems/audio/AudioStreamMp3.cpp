@@ -1,9 +1,11 @@
 #include "AudioStreamMp3.h"
+#include "systems/audio/analysis/SilenceScanner.h"
+#include "Config.h"
 
 namespace Pdb
 {
 
-AudioStreamMp3::AudioStreamMp3(std::atomic<float>& masterVolume) : AudioStream(masterVolume)
+AudioStreamMp3::AudioStreamMp3(std::atomic<float>& masterVolume, std::atomic<int>& nPlayingOverlays) : AudioStream(masterVolume, nPlayingOverlays)
 {
     mpg123_init();
     int err;
@@ -11,6 +13,7 @@ AudioStreamMp3::AudioStreamMp3(std::atomic<float>& masterVolume) : AudioStream(m
     mp3DecoderOutputBufferSize_ = mpg123_outblock(mh_);
     mp3DecoderOutputBuffer_ = (unsigned char *) malloc(mp3DecoderOutputBufferSize_ * sizeof(unsigned char));
     doneDecodingMp3_= false;
+    skippedSilenceMilliseconds_ = 0;
 }
 
 AudioStreamMp3::~AudioStreamMp3()
@@ -24,40 +27,46 @@ AudioStreamMp3::~AudioStreamMp3()
 void AudioStreamMp3::play()
 {
     state_ = State::PLAYING;
-    volume_ = playedAudioTrack_->getVolume();
+    updateVolume(*playedAudioTrack_);
 
     std::string path = playedAudioTrack_->getFilePath();
     mpg123_open(mh_, path.c_str());
     mpg123_getformat(mh_, &rate_, &channels_, &encoding_);
     nPlayedFrames_ = 0;
     
-    parameters_.nChannels = channels_;
-    parameters_.firstChannel = 0;
+    nChannels_ = channels_;
     sampleRate_ = rate_;
     bufferFrames_ = 256;
     doneDecodingMp3_ = false;
+    resetDucking(sampleRate_);
+    prepareEffectChain();
+    skippedSilenceMilliseconds_ = 0;
+    silenceIndex_ = (Config::getInstance().skipSilence && playedAudioTrack_->isStandard())
+        ? SilenceScanner::getInstance().getIndex(path) : nullptr;
+    if (playedAudioTrack_->isVoiceMessage()) beginOverlay();
 
     BOOST_LOG_TRIVIAL(info) << "Playing mp3 audio stream. Rate: " << rate_ << ", channels: " << channels_ << ", encoding: " << encoding_;
     BOOST_LOG_TRIVIAL(info) << "Audio track played: " << playedAudioTrack_->getTrackName();
-    if (rtAudio_->isStreamOpen()) rtAudio_->closeStream();
-    rtAudio_->openStream(&parameters_, NULL, RTAUDIO_SINT16,
-        sampleRate_, &bufferFrames_, &playCb, (void*) this);
+    if (output_->isOpen()) output_->close();
+    output_->open(nChannels_, sampleRate_, RTAUDIO_SINT16, &bufferFrames_, &playCb, (void*) this);
     if (playedAudioTrack_->getLastPlayedMillisecond() > 0)
         seek(playedAudioTrack_->getLastPlayedMillisecond());
-    rtAudio_->startStream();
+    output_->start();
 }
 
 void AudioStreamMp3::stop()
 {
-    std::unique_lock<std::mutex> lock(mutex_);
+    BOOST_LOG_TRIVIAL(info) << "Stopping mp3 audio stream: " << playedAudioTrack_->getTrackName() << ", open: " << output_->isOpen() << ", running: " << output_->isRunning();
+    /* Closed before locking - closing waits for a running callback, which may itself be waiting for mutex_ */
+    if (output_->isOpen()) output_->close();
 
-    BOOST_LOG_TRIVIAL(info) << "Stopping mp3 audio stream: " << playedAudioTrack_->getTrackName() << ", open: " << rtAudio_->isStreamOpen() << ", running: " << rtAudio_->isStreamRunning();
-    rtAudio_->closeStream();
+    std::unique_lock<std::mutex> lock(mutex_);
     mpg123_close(mh_);
     doneDecodingMp3_ = false;
+    endOverlay();
     state_ = State::AVAILABLE;
-    finishedPlayingCondVar_.notify_all();
-    BOOST_LOG_TRIVIAL(info) << "Stopped mp3 audio stream: " << playedAudioTrack_->getTrackName() << ", open: " << rtAudio_->isStreamOpen() << ", running: " << rtAudio_->isStreamRunning();
+    notifyFinished();
+    BOOST_LOG_TRIVIAL(info) << "Stopped mp3 audio stream: " << playedAudioTrack_->getTrackName() << ", open: " << output_->isOpen() << ", running: " << output_->isRunning();
 }
 
 void AudioStreamMp3::play(const AudioTrack& audioTrack)
@@ -65,25 +74,23 @@ void AudioStreamMp3::play(const AudioTrack& audioTrack)
     // TODO: Funkcja do wyrzucenia
     std::unique_lock<std::mutex> lock(mutex_);
     
-    volume_ = audioTrack.getVolume();
+    updateVolume(audioTrack);
 
     std::string path = audioTrack.getFilePath();
     mpg123_open(mh_, path.c_str());
     mpg123_getformat(mh_, &rate_, &channels_, &encoding_);
     nPlayedFrames_ = 0;
     
-    parameters_.nChannels = channels_;
-    parameters_.firstChannel = 0;
+    nChannels_ = channels_;
     sampleRate_ = rate_;
     bufferFrames_ = 256;
     doneDecodingMp3_ = false;
 
     BOOST_LOG_TRIVIAL(info) << "Playing mp3 audio stream. Rate: " << rate_ << ", channels: " << channels_ << ", encoding: " << encoding_;
-    if (rtAudio_->isStreamOpen()) rtAudio_->closeStream();
-    rtAudio_->openStream(&parameters_, NULL, RTAUDIO_SINT16,
-        sampleRate_, &bufferFrames_, &playCb, (void*) this);
+    if (output_->isOpen()) output_->close();
+    output_->open(nChannels_, sampleRate_, RTAUDIO_SINT16, &bufferFrames_, &playCb, (void*) this);
 
-    rtAudio_->startStream();
+    output_->start();
     if (audioTrack.getLastPlayedMillisecond() > 0)
         seek(audioTrack.getLastPlayedMillisecond());
 }
@@ -95,6 +102,7 @@ int AudioStreamMp3::playCallback(void *outputBuffer, void *inputBuffer, unsigned
     if ((nPlayedFrames_ * 2) % mp3DecoderOutputBufferSize_ == 0)
     {
         nPlayedFrames_ = 0;
+        if (silenceIndex_) skipSilence();
         int mpg123readResult = mpg123_read(mh_, mp3DecoderOutputBuffer_, mp3DecoderOutputBufferSize_, &nDecodedBytesToProcessLeft_);
 
         BOOST_LOG_TRIVIAL(debug) << "Bytes decoded: " << nDecodedBytesToProcessLeft_
@@ -110,9 +118,15 @@ int AudioStreamMp3::playCallback(void *outputBuffer, void *inputBuffer, unsigned
 
     BOOST_LOG_TRIVIAL(debug) << "Current sample pos: " << mpg123_tell(mh_) << ", Current frame: " << mpg123_tellframe(mh_) << ", byte offset: " << mpg123_tell_stream(mh_);
 
+    if (effectChain_)
+        effectChain_->process(mp3DecoderOutputBuffer + nPlayedFrames_, std::min<size_t>(nBufferFrames, nDecodedBytesToProcessLeft_ / 2));
+
+    followConfigVolume();
+    const float duckingTargetGain = this->duckingTargetGain();
+    countDuckedBuffer(duckingTargetGain);
     for (int i = 0; i < nBufferFrames; ++i)
     {
-        *outBuffer = *(mp3DecoderOutputBuffer + nPlayedFrames_) * volume_ * masterVolume_;
+        *outBuffer = *(mp3DecoderOutputBuffer + nPlayedFrames_) * volume_ * masterVolume_ * nextDuckingGain(duckingTargetGain);
 
         mp3DecoderOutputBuffer++;
         nDecodedBytesToProcessLeft_ -= 2;
@@ -129,12 +143,14 @@ int AudioStreamMp3::playCallback(void *outputBuffer, void *inputBuffer, unsigned
     if (doneDecodingMp3_ && nDecodedBytesToProcessLeft_ <= 0)
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        BOOST_LOG_TRIVIAL(info) << "Finished playing mp3 audio stream." << rtAudio_->isStreamOpen() << " " << rtAudio_->isStreamRunning();
+        BOOST_LOG_TRIVIAL(info) << "Finished playing mp3 audio stream." << output_->isOpen() << " " << output_->isRunning();
+        if (silenceIndex_) BOOST_LOG_TRIVIAL(info) << "Skipped " << skippedSilenceMilliseconds_ << " ms of silence.";
         mpg123_close(mh_);
         doneDecodingMp3_ = false;
         BOOST_LOG_TRIVIAL(info) << "Closed audio stream successfully.";
+        endOverlay();
         state_ = State::AVAILABLE;
-        finishedPlayingCondVar_.notify_all();
+        notifyFinished();
         return 1;
     }
 
@@ -146,6 +162,30 @@ int AudioStreamMp3::currentPositionInMilliseconds()
     return ((double)(mpg123_tell(mh_)) / (double)(rate_)) * 1000;
 }
 
+int AudioStreamMp3::durationInMilliseconds()
+{
+    const off_t length = mpg123_length(mh_);
+    if (length <= 0 || rate_ <= 0) return 0;
+    return ((double)length / (double)rate_) * 1000;
+}
+
+void AudioStreamMp3::skipSilence()
+{
+    const Config& config = Config::getInstance();
+    const int position = ((double)(mpg123_tell(mh_)) / (double)(rate_)) * 1000;
+    const SilenceIndex::Silence* silence = silenceIndex_->findSilence(position);
+    if (!silence || (int)silence->getDuration() < config.skipSilenceMinMilliseconds) return;
+
+    /* Half of the kept pause is played before the jump, half after it */
+    const int keptMilliseconds = config.skipSilenceKeepMilliseconds / 2;
+    const int skipToMillisecond = (int)silence->endMillisecond - keptMilliseconds;
+    if (position < (int)silence->startMillisecond + keptMilliseconds || position >= skipToMillisecond) return;
+
+    mpg123_seek(mh_, (off_t)skipToMillisecond * rate_ / 1000, SEEK_SET);
+    skippedSilenceMilliseconds_ += skipToMillisecond - position;
+    BOOST_LOG_TRIVIAL(debug) << "Skipping silence from " << position << " ms to " << skipToMillisecond << " ms.";
+}
+
 void AudioStreamMp3::seek(int offsetInMilliseconds)
 {
     float secondsOffset = (float)(offsetInMilliseconds) / 1000.0f;
@@ -159,5 +199,13 @@ void AudioStreamMp3::seek(int offsetInMilliseconds)
     nPlayedFrames_ = 0;
 }
 
+void AudioStreamMp3::seekTo(int positionInMilliseconds)
+{
+    const off_t sample = (off_t)std::max(0, positionInMilliseconds) * rate_ / 1000;
+    BOOST_LOG_TRIVIAL(info) << "Seeking mp3 audio stream to " << positionInMilliseconds << " ms (sample " << sample << ")";
+    mpg123_seek(mh_, sample, SEEK_SET);
+    nPlayedFrames_ = 0;
+}
+
 
 }
\ No newline at end of file
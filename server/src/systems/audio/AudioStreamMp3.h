@@ -2,6 +2,7 @@
 
 #include <mpg123.h>
 #include "systems/audio/AudioStream.h"
+#include "systems/audio/analysis/SilenceIndex.h"
 
 namespace Pdb
 {
@@ -9,7 +10,7 @@ namespace Pdb
 class AudioStreamMp3 : public AudioStream 
 {
 public:
-    AudioStreamMp3(std::atomic<float>& masterVolume);
+    AudioStreamMp3(std::atomic<float>& masterVolume, std::atomic<int>& nPlayingOverlays);
     ~AudioStreamMp3();
 
     void play() override;
@@ -18,10 +19,15 @@ public:
     int playCallback(void *outputBuffer, void *inputBuffer, unsigned int nBufferFrames, 
         double streamTime, RtAudioStreamStatus status) override;
     int currentPositionInMilliseconds() override;
+    int durationInMilliseconds() override;
 
     void seek(int offsetInMilliseconds) override;
+    void seekTo(int positionInMilliseconds) override;
 
 private:
+    /* Skip-silence mode - called before decoding next block, jumps to the end of a long pause keeping a bit of it */
+    void skipSilence();
+
     mpg123_handle * mh_;
     unsigned char * mp3DecoderOutputBuffer_;
     size_t mp3DecoderOutputBufferSize_;
@@ -32,6 +38,9 @@ private:
 
     unsigned int nPlayedFrames_;
     bool doneDecodingMp3_;
+
+    std::shared_ptr<const SilenceIndex> silenceIndex_;     /* Set only when skipping silence */
+    int skippedSilenceMilliseconds_;
 };
 
 }
\ No newline at end of file
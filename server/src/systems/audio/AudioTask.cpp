@@ -1,4 +1,6 @@
 #include "AudioTask.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+#include "Config.h"
 #include <boost/log/trivial.hpp>
 
 namespace Pdb
@@ -16,7 +18,7 @@ AudioTask::Element::~Element()
 {
 }
 
-AudioTask::AudioTask() : state_(State::AVAILABLE)
+AudioTask::AudioTask() : state_(State::AVAILABLE), stopped_(false), generation_(0), startingStream_(nullptr), startingStreamFinished_(false)
 {
 }
 
@@ -29,20 +31,42 @@ void AudioTask::start(std::list<AudioTask::Element> taskElements, std::function<
 {
     std::unique_lock<std::mutex> lock(mutex_);
     state_ = State::UNAVAILABLE;
+    stopped_ = false;
     audioTaskElements_ = taskElements;
     taskCallbackFunction_ = callbackFunction;
-    taskThread_ = std::thread(&AudioTask::taskFunction, this);
-    taskThread_.detach();
+    continuations_.clear();
+    const unsigned int generation = ++generation_;
+    sequencer().post([this, generation] { playNextElement(generation); });
 }
 
 void AudioTask::stop()
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    stopElements();
+}
+
+void AudioTask::stop(unsigned int generation)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (generation == generation_) stopElements();
+}
+
+unsigned int AudioTask::getGeneration() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+void AudioTask::stopElements()
+{
     if (state_ == State::AVAILABLE) return;
+    stopped_ = true;
     taskCallbackFunction_ = {};
+    continuations_.clear();
     for (auto& audioTaskElement : audioTaskElements_)
     {
-        audioTaskElement.getStream()->stop();
+        /* Stream being started is stopped by playNextElement() once its play() returned */
+        if (audioTaskElement.getStream() != startingStream_) audioTaskElement.getStream()->stop();
     }
     audioTaskElements_.clear();
 }
@@ -50,6 +74,7 @@ void AudioTask::stop()
 bool AudioTask::isPausable() const
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
     if (audioTaskElements_.empty()) return false;
     auto taskElement = audioTaskElements_.front();
     AudioStream* currentStream = taskElement.getStream();
@@ -60,6 +85,7 @@ bool AudioTask::isPausable() const
 bool AudioTask::isPaused() const
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
     if (audioTaskElements_.empty()) return false;
     auto taskElement = audioTaskElements_.front();
     AudioStream* currentStream = taskElement.getStream();
@@ -70,6 +96,7 @@ bool AudioTask::isPaused() const
 void AudioTask::pauseToggle()
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
     if (state_ == State::AVAILABLE) return;
     auto taskElement = audioTaskElements_.front();
     AudioStream* currentStream = taskElement.getStream();
@@ -79,12 +106,23 @@ void AudioTask::pauseToggle()
 void AudioTask::seek(int offsetInMilliseconds)
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
     if (state_ == State::AVAILABLE) return;
     auto taskElement = audioTaskElements_.front();
     AudioStream* currentStream = taskElement.getStream();
     if (currentStream && currentStream->isPausable()) currentStream->seek(offsetInMilliseconds);
 }
 
+void AudioTask::seekTo(int positionInMilliseconds)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
+    if (state_ == State::AVAILABLE) return;
+    auto taskElement = audioTaskElements_.front();
+    AudioStream* currentStream = taskElement.getStream();
+    if (currentStream && currentStream->isPausable()) currentStream->seekTo(positionInMilliseconds);
+}
+
 void AudioTask::waitForEnd()
 {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -92,20 +130,81 @@ void AudioTask::waitForEnd()
     BOOST_LOG_TRIVIAL(info) << "Finished waiting for AudioStream end.";
 }
 
-void AudioTask::taskFunction()
+void AudioTask::then(Executor& executor, std::function<void()> continuation)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (state_ == State::AVAILABLE)
+    {
+        if (!stopped_) executor.post(std::move(continuation));
+        return;
+    }
+    continuations_.push_back(std::make_pair(&executor, std::move(continuation)));
+}
+
+Executor& AudioTask::sequencer()
+{
+    static ThreadPoolExecutor sequencerPool(Config::getInstance().audioSequencerThreads, ThreadRole::DECODE, "sequencer");
+    return sequencerPool;
+}
+
+void AudioTask::playNextElement(unsigned int generation)
 {
     std::unique_lock<std::mutex> lock(mutex_);
-    while (!audioTaskElements_.empty())
+    /* A stream failing to start finishes within its play(), the next one waits until that play() returned */
+    waitUntilStarted(lock);
+    if (generation != generation_ || state_ == State::AVAILABLE) return;
+    if (audioTaskElements_.empty())
     {
-        AudioTask::Element audioTaskElement = audioTaskElements_.front();
-        audioTaskElement.getStream()->play();
-        lock.unlock();
-        audioTaskElement.getStream()->waitForEnd();
-        lock.lock();
-        if (audioTaskElements_.empty()) break;
-        audioTaskElements_.pop_front();
+        finish();
+        return;
     }
-    if(taskCallbackFunction_) taskCallbackFunction_();
+    AudioStream* stream = audioTaskElements_.front().getStream();
+    startingStream_ = stream;
+    startingStreamFinished_ = false;
+    stream->setFinishedCallback([this, generation]
+    {
+        startingStreamFinished_ = true;
+        sequencer().post([this, generation] { onElementFinished(generation); });
+    });
+
+    /* Opening the output may block on the device - stop() and finished elements must not wait for it */
+    lock.unlock();
+    stream->play();
+    lock.lock();
+
+    startingStream_ = nullptr;
+    const bool stopRequested = stopped_ || generation != generation_;
+    const bool finished = startingStreamFinished_;
+    lock.unlock();
+    elementStartedCondVar_.notify_all();
+    /* Stopped while starting - its finished callback then completes the stop like for any other stream */
+    if (stopRequested && !finished) stream->stop();
+}
+
+void AudioTask::waitUntilStarted(std::unique_lock<std::mutex>& lock) const
+{
+    elementStartedCondVar_.wait(lock, [this] { return startingStream_ == nullptr; });
+}
+
+void AudioTask::onElementFinished(unsigned int generation)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (generation != generation_ || state_ == State::AVAILABLE) return;
+        if (!audioTaskElements_.empty()) audioTaskElements_.pop_front();
+    }
+    playNextElement(generation);
+}
+
+void AudioTask::finish()
+{
+    if (!stopped_)
+    {
+        if(taskCallbackFunction_) taskCallbackFunction_();
+        for (auto& continuation : continuations_) continuation.first->post(std::move(continuation.second));
+    }
+    taskCallbackFunction_ = {};
+    continuations_.clear();
     state_ = State::AVAILABLE;
     taskFinishedCondVar_.notify_all();
 }
@@ -113,12 +212,23 @@ void AudioTask::taskFunction()
 int AudioTask::getCurrentTaskElementMilliseconds() const
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
+    if (audioTaskElements_.empty()) return -1;
     return audioTaskElements_.front().getStream()->currentPositionInMilliseconds();
 }
 
+int AudioTask::getCurrentTaskElementDurationMilliseconds() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitUntilStarted(lock);
+    if (audioTaskElements_.empty()) return 0;
+    return audioTaskElements_.front().getStream()->durationInMilliseconds();
+}
+
 void AudioTask::printDebugInfo() const
 {
     std::unique_lock<std::mutex> lock(mutex_);
+    if (audioTaskElements_.empty()) return;
     BOOST_LOG_TRIVIAL(info) << "Current audio task track name: " << audioTaskElements_.front().getStream()->getPlayedAudioTrackName();
 }
 
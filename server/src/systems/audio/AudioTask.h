@@ -1,10 +1,12 @@
 #pragma once
 #include "AudioStream.h"
+#include "systems/executor/Executor.h"
 
-#include <thread>
 #include <mutex>
 #include <list>
 #include <functional>
+#include <vector>
+#include <atomic>
 
 namespace Pdb
 {
@@ -39,25 +41,52 @@ public:
     bool isPaused() const;
     void start(std::list<AudioTask::Element> taskElements, std::function<void()> callbackFunction = {});
     void stop();
+    /* Stops the task only while it still plays the given run (see getGeneration) - a pooled task may
+       have finished and been started again by someone else meanwhile */
+    void stop(unsigned int generation);
+    unsigned int getGeneration() const;
     void pauseToggle();
     void seek(int offsetInMilliseconds);
+    void seekTo(int positionInMilliseconds);
     void waitForEnd();
+    /* Continuation posted to executor once the task finishes playing all its elements.
+       Dropped if the task is stopped. Call right after the task was returned by AudioManager::play. */
+    void then(Executor& executor, std::function<void()> continuation);
+    /* -1 once the last element finished playing (the task may not be available yet) */
     int getCurrentTaskElementMilliseconds() const;
+    /* 0 when not known, or once the last element finished playing */
+    int getCurrentTaskElementDurationMilliseconds() const;
     void printDebugInfo() const;
 
 private:
     enum class State { AVAILABLE, UNAVAILABLE };
-    void taskFunction();
+
+    /* Elements are played one after another by a small pool of sequencer threads shared by all tasks,
+       driven by the streams' finished callbacks - no thread is created or blocked per task */
+    static Executor& sequencer();
+    /* Plays the front element - its play() runs unlocked, other calls on that stream wait for it to return */
+    void playNextElement(unsigned int generation);
+    void waitUntilStarted(std::unique_lock<std::mutex>& lock) const;
+    void onElementFinished(unsigned int generation);
+    /* mutex_ held */
+    void stopElements();
+    void finish();
 
     std::list<AudioTask::Element> audioTaskElements_;
 
-    State state_;
+    std::atomic<State> state_;
+    bool stopped_;
+    unsigned int generation_;   /* Incremented on each start, so late events of previous runs are ignored */
+
+    AudioStream* startingStream_;   /* Front element while its play() runs, nullptr otherwise */
+    std::atomic<bool> startingStreamFinished_;  /* Set by the finished callback, which runs under the stream's lock */
 
-    std::thread taskThread_;
     mutable std::mutex mutex_;
     std::condition_variable taskFinishedCondVar_;
+    mutable std::condition_variable elementStartedCondVar_;
 
     std::function<void()> taskCallbackFunction_;
+    std::vector<std::pair<Executor*, std::function<void()>>> continuations_;
 };
 
 }
\ No newline at end of file
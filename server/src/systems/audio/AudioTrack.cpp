@@ -1,32 +1,102 @@
 #include "AudioTrack.h"
+#include "systems/audio/analysis/LoudnessAnalyzer.h"
+#include "systems/audio/SampleReader.h"
+#include "Config.h"
 #include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+
+namespace filesystem = boost::filesystem;
 
 namespace Pdb
 {
 
-AudioTrack::AudioTrack(std::string trackName, int lastPlayedMillisecond) : trackName_(trackName), lastPlayedMillisecond_(lastPlayedMillisecond)
+AudioTrack::AudioTrack(std::string trackName, int lastPlayedMillisecond) : format_(Format::UNKNOWN), trackName_(trackName), lastPlayedMillisecond_(lastPlayedMillisecond)
 {
 
 }
 
-AudioTrack::AudioTrack(const std::string & filePath, const float volume, Type type) : filePath_(filePath), volume_(volume), lastPlayedMillisecond_(0), type_(type)
+AudioTrack::AudioTrack(const std::string & filePath, Type type) : filePath_(filePath), lastPlayedMillisecond_(0), type_(type)
 {
-    std::string fileExtension = filePath.substr(filePath.length() - 3, 3);
-    if (fileExtension == "mp3") format_ = Format::MP3;
-    else if (fileExtension == "wav") format_ = Format::WAV;
-    else
+    format_ = detectFormat(filePath);
+    trackName_ = isMultiPart() ? filesystem::path(filePath).filename().string() : filesystem::path(filePath).stem().string();
+    BOOST_LOG_TRIVIAL(debug) << "Audio track created: " << trackName_;
+}
+
+AudioTrack::~AudioTrack()
+{
+}
+
+void AudioTrack::setFilePath(const std::string& filePath)
+{
+    format_ = detectFormat(filePath);
+    filePath_ = filePath;
+}
+
+bool AudioTrack::isPlayable() const
+{
+    return isMp3() || SampleReader::isSupported(format_);
+}
+
+AudioTrack::Format AudioTrack::detectFormat(const std::string& filePath)
+{
+    boost::system::error_code error;
+    if (filesystem::is_directory(filePath, error)) return Format::MULTI_PART;
+
+    unsigned char header[64] = {};
+    std::ifstream file(filePath, std::ifstream::binary);
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    const size_t nRead = file.gcount();
+
+    if (nRead >= 12 && std::memcmp(header, "RIFF", 4) == 0 && std::memcmp(header + 8, "WAVE", 4) == 0) return Format::WAV;
+    if (nRead >= 4 && std::memcmp(header, "fLaC", 4) == 0) return Format::FLAC;
+    if (nRead >= 27 && std::memcmp(header, "OggS", 4) == 0)
+    {
+        /* First packet of the first page identifies the codec, it follows the page header and its segment table */
+        const size_t packetOffset = 27 + header[26];
+        if (nRead >= packetOffset + 8 && std::memcmp(header + packetOffset, "OpusHead", 8) == 0) return Format::OPUS;
+        if (nRead >= packetOffset + 7 && std::memcmp(header + packetOffset, "\x01vorbis", 7) == 0) return Format::VORBIS;
+        return Format::UNKNOWN;
+    }
+    if (nRead >= 3 && std::memcmp(header, "ID3", 3) == 0) return Format::MP3;
+    if (nRead >= 2 && header[0] == 0xFF && (header[1] & 0xE0) == 0xE0) return Format::MP3;
+    if (nRead > 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Unknown audio format: " << filePath;
+        return Format::UNKNOWN;
+    }
+
+    std::string fileExtension = filesystem::path(filePath).extension().string();
+    if (fileExtension == ".mp3") return Format::MP3;
+    if (fileExtension == ".wav") return Format::WAV;
+    if (fileExtension == ".flac") return Format::FLAC;
+    if (fileExtension == ".ogg" || fileExtension == ".oga") return Format::VORBIS;
+    if (fileExtension == ".opus") return Format::OPUS;
+    BOOST_LOG_TRIVIAL(error) << "Unknown file extension: " << filePath;
+    return Format::UNKNOWN;
+}
+
+const char* AudioTrack::getFormatName(Format format)
+{
+    switch (format)
     {
-        BOOST_LOG_TRIVIAL(error) << "Unknown file extension.";
-        exit(0);
+        case Format::MP3: return "mp3";
+        case Format::WAV: return "wav";
+        case Format::FLAC: return "flac";
+        case Format::VORBIS: return "vorbis";
+        case Format::OPUS: return "opus";
+        case Format::MULTI_PART: return "multi-part";
+        case Format::UNKNOWN: break;
     }
-    size_t lastSlashIndex = filePath.find_last_of("/\\");
-    std::string fileName = filePath.substr(lastSlashIndex + 1);
-    trackName_ = fileName.substr(0, fileName.length() - 4);
-    BOOST_LOG_TRIVIAL(debug) << "Audio track created: " << trackName_ << ", volume: " << volume_;
+    return "unknown";
 }
 
-AudioTrack::~AudioTrack()
+float AudioTrack::getVolume() const
 {
+    const Config& config = Config::getInstance();
+    if (isStandard()) return config.volumeForAudiobooks * LoudnessAnalyzer::getInstance().getNormalizationGain(filePath_);
+    return config.volumeForAwsSynthesized;
 }
 
 }
\ No newline at end of file
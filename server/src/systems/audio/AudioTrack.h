@@ -8,29 +8,41 @@ namespace Pdb
 class AudioTrack
 {
 public:
-    enum class Format { MP3, WAV };
+    /* MULTI_PART - directory of files (parts) played as one track */
+    enum class Format { MP3, WAV, FLAC, VORBIS, OPUS, MULTI_PART, UNKNOWN };
     enum class Type { STANDARD, VOICE_MESSAGE };
 
     AudioTrack(std::string trackName, int lastPlayedMillisecond);
-    AudioTrack(const std::string & filePath, const float volume, Type type);
+    AudioTrack(const std::string & filePath, Type type);
     ~AudioTrack();
 
     bool isMp3() const { return format_ == Format::MP3; }
     bool isWav() const { return format_ == Format::WAV; }
+    bool isMultiPart() const { return format_ == Format::MULTI_PART; }
+    Format getFormat() const { return format_; }
+    /* Whether this build can play the track */
+    bool isPlayable() const;
     bool isStandard() const { return type_ == Type::STANDARD; }
     bool isVoiceMessage() const { return type_ == Type::VOICE_MESSAGE; }
     std::string getFilePath() const { return filePath_; }
     std::string getTrackName() const { return trackName_; }
-    float getVolume() const { return volume_; }
+    /* Volume of the track's type in the current config snapshot (SynthesizedAudio.volume or AudiobookAudio.volume),
+       standard tracks include their loudness normalization gain */
+    float getVolume() const;
     int getLastPlayedMillisecond() const { return lastPlayedMillisecond_; }
     void setLastPlayedMillisecond(int newValue) { lastPlayedMillisecond_ = newValue; }
     void setTrackName(std::string newTrackName) { trackName_ = newTrackName; }
+    /* Points the track to another file with the same content (e.g. transcoded), keeping its name and position */
+    void setFilePath(const std::string& filePath);
+
+    /* Sniffs the file content, the extension decides only when the file cannot be read (yet) */
+    static Format detectFormat(const std::string& filePath);
+    static const char* getFormatName(Format format);
 
 private:
     Format format_;
     Type type_;
     std::string filePath_;
-    float volume_;    /* Values range from 0.0 to 1.0 */
     int lastPlayedMillisecond_;
     std::string trackName_;
 };
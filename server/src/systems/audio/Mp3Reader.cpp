@@ -0,0 +1,105 @@
+#include "Mp3Reader.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+
+namespace Pdb
+{
+
+Mp3Reader::Mp3Reader() : mh_(nullptr), isOpen_(false), sampleRate_(0), nChannels_(0), nFrames_(0), framePosition_(0),
+    nDecodedSamplesLeft_(0), decodedSamplePosition_(0), doneDecoding_(false)
+{
+    mpg123_init();
+    int err;
+    mh_ = mpg123_new(NULL, &err);
+    if (mh_) mpg123_param(mh_, MPG123_ADD_FLAGS, MPG123_QUIET, 0.0);
+}
+
+Mp3Reader::~Mp3Reader()
+{
+    close();
+    if (mh_) mpg123_delete(mh_);
+}
+
+bool Mp3Reader::open(const std::string& filePath)
+{
+    close();
+    if (!mh_) return false;
+
+    long rate;
+    int channels, encoding;
+    if (mpg123_open(mh_, filePath.c_str()) != MPG123_OK || mpg123_getformat(mh_, &rate, &channels, &encoding) != MPG123_OK)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not open mp3 file: " << filePath;
+        mpg123_close(mh_);
+        return false;
+    }
+    /* Output format locked, so it cannot change in the middle of the file */
+    mpg123_format_none(mh_);
+    mpg123_format(mh_, rate, channels, MPG123_ENC_SIGNED_16);
+    sampleRate_ = rate;
+    nChannels_ = channels;
+    const off_t length = mpg123_length(mh_);
+    nFrames_ = (length > 0) ? length : 0;
+    framePosition_ = 0;
+    decoderOutputBuffer_.resize(mpg123_outblock(mh_) / sizeof(int16_t));
+    nDecodedSamplesLeft_ = 0;
+    decodedSamplePosition_ = 0;
+    doneDecoding_ = false;
+    isOpen_ = true;
+    return true;
+}
+
+void Mp3Reader::close()
+{
+    if (isOpen_) mpg123_close(mh_);
+    isOpen_ = false;
+    framePosition_ = 0;
+}
+
+size_t Mp3Reader::read(float* samples, size_t maxSamples)
+{
+    if (!isOpen_) return 0;
+    maxSamples -= maxSamples % nChannels_;
+
+    size_t nRead = 0;
+    while (nRead < maxSamples)
+    {
+        if (nDecodedSamplesLeft_ == 0)
+        {
+            if (doneDecoding_) break;
+            size_t nDecodedBytes = 0;
+            int mpg123readResult = mpg123_read(mh_, decoderOutputBuffer_.data(), decoderOutputBuffer_.size() * sizeof(int16_t), &nDecodedBytes);
+            if (mpg123readResult != MPG123_OK) doneDecoding_ = true;
+            nDecodedSamplesLeft_ = nDecodedBytes / sizeof(int16_t);
+            decodedSamplePosition_ = 0;
+            continue;
+        }
+        const size_t nSamples = std::min(maxSamples - nRead, nDecodedSamplesLeft_);
+        DspKernels::int16ToFloat(decoderOutputBuffer_.data() + decodedSamplePosition_, samples + nRead, nSamples);
+        nRead += nSamples;
+        decodedSamplePosition_ += nSamples;
+        nDecodedSamplesLeft_ -= nSamples;
+    }
+    framePosition_ += nRead / nChannels_;
+    /* Estimated length may be short */
+    nFrames_ = std::max(nFrames_, framePosition_);
+    return nRead;
+}
+
+void Mp3Reader::seekToFrame(uint64_t frame)
+{
+    if (!isOpen_) return;
+    const off_t position = mpg123_seek(mh_, (off_t)frame, SEEK_SET);
+    if (position < 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Mp3 seek failed: " << mpg123_strerror(mh_);
+        return;
+    }
+    framePosition_ = position;
+    nDecodedSamplesLeft_ = 0;
+    doneDecoding_ = false;
+}
+
+}
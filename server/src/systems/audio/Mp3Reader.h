@@ -0,0 +1,44 @@
+#pragma once
+#include "systems/audio/SampleReader.h"
+
+#include <mpg123.h>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Mp3 file decoded by mpg123 as a SampleReader - for parts of multi-file audiobooks, standalone mp3 tracks are played
+   by AudioStreamMp3. The frame count comes from the Xing/Info header, or is estimated from the bitrate without one. */
+class Mp3Reader : public SampleReader
+{
+public:
+    Mp3Reader();
+    ~Mp3Reader() override;
+
+    bool open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override { return isOpen_; }
+
+    unsigned int getSampleRate() const override { return sampleRate_; }
+    unsigned int getChannelCount() const override { return nChannels_; }
+    uint64_t getFrameCount() const override { return nFrames_; }
+    uint64_t getFramePosition() const override { return framePosition_; }
+
+    size_t read(float* samples, size_t maxSamples) override;
+    void seekToFrame(uint64_t frame) override;
+
+private:
+    mpg123_handle* mh_;
+    bool isOpen_;
+    unsigned int sampleRate_;
+    unsigned int nChannels_;
+    uint64_t nFrames_;
+    uint64_t framePosition_;
+
+    std::vector<int16_t> decoderOutputBuffer_;
+    size_t nDecodedSamplesLeft_;
+    size_t decodedSamplePosition_;
+    bool doneDecoding_;
+};
+
+}
@@ -0,0 +1,248 @@
+#include "MultiPartReader.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace filesystem = boost::filesystem;
+
+namespace Pdb
+{
+
+namespace
+{
+    const unsigned int prefetchSeconds = 10;        /* Before the end of a part */
+    const unsigned int prefillMilliseconds = 1000;
+
+    ThreadPoolExecutor& prefetchExecutor()
+    {
+        /* Shared by all readers, decode role - a late prefetch would be heard, unlike background analysis */
+        static ThreadPoolExecutor* instance = new ThreadPoolExecutor(1, ThreadRole::DECODE, "prefetch");
+        return *instance;
+    }
+
+    /* Digit runs compared by value, everything else character by character */
+    bool isNaturallyLess(const std::string& left, const std::string& right)
+    {
+        size_t i = 0, j = 0;
+        while (i < left.size() && j < right.size())
+        {
+            if (std::isdigit((unsigned char)left[i]) && std::isdigit((unsigned char)right[j]))
+            {
+                size_t iEnd = i, jEnd = j;
+                while (iEnd < left.size() && std::isdigit((unsigned char)left[iEnd])) ++iEnd;
+                while (jEnd < right.size() && std::isdigit((unsigned char)right[jEnd])) ++jEnd;
+                /* Leading zeros do not count */
+                while (i + 1 < iEnd && left[i] == '0') ++i;
+                while (j + 1 < jEnd && right[j] == '0') ++j;
+                if (iEnd - i != jEnd - j) return iEnd - i < jEnd - j;
+                const int comparison = left.compare(i, iEnd - i, right, j, jEnd - j);
+                if (comparison != 0) return comparison < 0;
+                i = iEnd;
+                j = jEnd;
+            }
+            else
+            {
+                const int leftCharacter = std::tolower((unsigned char)left[i]), rightCharacter = std::tolower((unsigned char)right[j]);
+                if (leftCharacter != rightCharacter) return leftCharacter < rightCharacter;
+                ++i;
+                ++j;
+            }
+        }
+        return left.size() - i < right.size() - j;
+    }
+}
+
+MultiPartReader::~MultiPartReader()
+{
+    close();
+}
+
+std::vector<std::string> MultiPartReader::listParts(const std::string& directoryPath)
+{
+    std::vector<std::string> fileNames;
+    boost::system::error_code error;
+    for (filesystem::directory_iterator dirItr(directoryPath, error), endIter; !error && dirItr != endIter; dirItr.increment(error))
+    {
+        if (!filesystem::is_regular_file(dirItr->status())) continue;
+        const AudioTrack::Format format = AudioTrack::detectFormat(dirItr->path().string());
+        if (format != AudioTrack::Format::UNKNOWN && SampleReader::isSupported(format))
+            fileNames.push_back(dirItr->path().filename().string());
+    }
+    std::sort(fileNames.begin(), fileNames.end(), isNaturallyLess);
+
+    std::vector<std::string> filePaths;
+    for (const std::string& fileName : fileNames) filePaths.push_back((filesystem::path(directoryPath) / fileName).string());
+    return filePaths;
+}
+
+bool MultiPartReader::open(const std::string& directoryPath)
+{
+    close();
+    parts_.clear();
+    partStartFrames_.clear();
+
+    /* Every part is opened once for its length - headers only, nothing is decoded */
+    uint64_t startFrame = 0;
+    for (const std::string& filePath : listParts(directoryPath))
+    {
+        const AudioTrack::Format format = AudioTrack::detectFormat(filePath);
+        std::unique_ptr<SampleReader> reader = SampleReader::create(format);
+        if (!reader || !reader->open(filePath)) return false;
+        if (parts_.empty())
+        {
+            sampleRate_ = reader->getSampleRate();
+            nChannels_ = reader->getChannelCount();
+        }
+        else if (reader->getSampleRate() != sampleRate_ || reader->getChannelCount() != nChannels_)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Part " << filePath << " has " << reader->getSampleRate() << " Hz, " << reader->getChannelCount()
+                << " channels, the audiobook " << sampleRate_ << " Hz, " << nChannels_ << " channels - parts cannot be joined.";
+            parts_.clear();
+            partStartFrames_.clear();
+            return false;
+        }
+        parts_.push_back(Part { filePath, format });
+        partStartFrames_.push_back(startFrame);
+        startFrame += reader->getFrameCount();
+    }
+    if (parts_.empty())
+    {
+        BOOST_LOG_TRIVIAL(error) << "No playable parts in " << directoryPath;
+        return false;
+    }
+    partStartFrames_.push_back(startFrame);
+
+    BOOST_LOG_TRIVIAL(info) << "Multi-part audiobook " << directoryPath << ": " << parts_.size() << " parts, "
+        << startFrame / sampleRate_ << " s.";
+    switchToPart(0, 0);
+    return currentReader_ != nullptr;
+}
+
+void MultiPartReader::close()
+{
+    currentReader_.reset();
+    prefetch_.reset();      /* A running prefetch job keeps its own reference */
+    prefilledSamples_.clear();
+    prefilledSamplePosition_ = 0;
+    framePosition_ = 0;
+    if (nLatePrefetches_ > 0) BOOST_LOG_TRIVIAL(info) << "Multi-part reader: " << nLatePrefetches_ << " late prefetches.";
+    nLatePrefetches_ = 0;
+}
+
+size_t MultiPartReader::read(float* samples, size_t maxSamples)
+{
+    if (!currentReader_) return 0;
+    maxSamples -= maxSamples % nChannels_;
+
+    size_t nRead = 0;
+    while (nRead < maxSamples)
+    {
+        size_t nSamples;
+        if (prefilledSamplePosition_ < prefilledSamples_.size())
+        {
+            nSamples = std::min(maxSamples - nRead, prefilledSamples_.size() - prefilledSamplePosition_);
+            std::memcpy(samples + nRead, prefilledSamples_.data() + prefilledSamplePosition_, nSamples * sizeof(float));
+            prefilledSamplePosition_ += nSamples;
+        }
+        else nSamples = currentReader_->read(samples + nRead, maxSamples - nRead);
+
+        if (nSamples == 0)
+        {
+            if (!advanceToNextPart()) break;
+            continue;
+        }
+        nRead += nSamples;
+        framePosition_ += nSamples / nChannels_;
+    }
+
+    if (!prefetch_ && currentPartIndex_ + 1 < parts_.size()
+        && framePosition_ + prefetchSeconds * sampleRate_ >= partStartFrames_[currentPartIndex_ + 1])
+        requestPrefetch();
+    return nRead;
+}
+
+void MultiPartReader::seekToFrame(uint64_t frame)
+{
+    if (parts_.empty()) return;
+    frame = std::min(frame, partStartFrames_.back());
+    /* Last part starting at or before the frame */
+    size_t partIndex = std::upper_bound(partStartFrames_.begin(), partStartFrames_.end() - 1, frame) - partStartFrames_.begin() - 1;
+    switchToPart(partIndex, frame - partStartFrames_[partIndex]);
+}
+
+std::unique_ptr<SampleReader> MultiPartReader::openPart(size_t partIndex) const
+{
+    std::unique_ptr<SampleReader> reader = SampleReader::create(parts_[partIndex].format);
+    if (!reader || !reader->open(parts_[partIndex].filePath)) return nullptr;
+    return reader;
+}
+
+void MultiPartReader::requestPrefetch()
+{
+    auto prefetch = std::make_shared<Prefetch>();
+    prefetch_ = prefetch;
+    const std::string filePath = parts_[currentPartIndex_ + 1].filePath;
+    const AudioTrack::Format format = parts_[currentPartIndex_ + 1].format;
+    const size_t nPrefillSamples = (size_t)sampleRate_ * nChannels_ * prefillMilliseconds / 1000;
+
+    prefetchExecutor().post([prefetch, filePath, format, nPrefillSamples]
+    {
+        std::unique_ptr<SampleReader> reader = SampleReader::create(format);
+        if (reader && reader->open(filePath))
+        {
+            prefetch->samples.resize(nPrefillSamples);
+            prefetch->samples.resize(reader->read(prefetch->samples.data(), nPrefillSamples));
+            prefetch->reader = std::move(reader);
+        }
+        prefetch->isReady.store(true, std::memory_order_release);
+    });
+}
+
+bool MultiPartReader::advanceToNextPart()
+{
+    if (currentPartIndex_ + 1 >= parts_.size()) return false;
+
+    std::shared_ptr<Prefetch> prefetch = std::move(prefetch_);
+    if (prefetch && prefetch->isReady.load(std::memory_order_acquire) && prefetch->reader)
+    {
+        ++currentPartIndex_;
+        currentReader_ = std::move(prefetch->reader);
+        prefilledSamples_ = std::move(prefetch->samples);
+        prefilledSamplePosition_ = 0;
+        framePosition_ = partStartFrames_[currentPartIndex_];
+        return true;
+    }
+
+    /* Prefetch not requested (seek near the end) or not done in time - opened here, may be heard */
+    ++nLatePrefetches_;
+    BOOST_LOG_TRIVIAL(debug) << "Prefetch of part " << currentPartIndex_ + 1 << " not ready, opening it now.";
+    switchToPart(currentPartIndex_ + 1, 0);
+    return currentReader_ != nullptr;
+}
+
+void MultiPartReader::switchToPart(size_t partIndex, uint64_t partFrame)
+{
+    prefilledSamples_.clear();
+    prefilledSamplePosition_ = 0;
+    if (partIndex != currentPartIndex_ || !currentReader_)
+    {
+        /* Prefetch is only valid for the part after the current one */
+        prefetch_.reset();
+        currentReader_ = openPart(partIndex);
+        currentPartIndex_ = partIndex;
+        if (!currentReader_)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Could not open part " << parts_[partIndex].filePath;
+            return;
+        }
+    }
+    if (partFrame > 0) currentReader_->seekToFrame(partFrame);
+    else if (currentReader_->getFramePosition() > 0) currentReader_->seekToFrame(0);
+    framePosition_ = partStartFrames_[partIndex] + currentReader_->getFramePosition();
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "systems/audio/SampleReader.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Audiobook split into a directory of numbered files, read as one track with a single timeline (positions,
+   seeks and resume are global). Parts are ordered by name, numbers compared by value ("2" before "10"), and
+   must share sample rate and channel count. Shortly before a part ends the next one is opened and its first
+   second decoded by a prefetch thread, so the audio callback continues with it without a gap. */
+class MultiPartReader : public SampleReader
+{
+public:
+    ~MultiPartReader() override;
+
+    /* Playable files of the directory in playback order */
+    static std::vector<std::string> listParts(const std::string& directoryPath);
+
+    bool open(const std::string& directoryPath) override;
+    void close() override;
+    bool isOpen() const override { return currentReader_ != nullptr; }
+
+    unsigned int getSampleRate() const override { return sampleRate_; }
+    unsigned int getChannelCount() const override { return nChannels_; }
+    uint64_t getFrameCount() const override { return partStartFrames_.empty() ? 0 : partStartFrames_.back(); }
+    uint64_t getFramePosition() const override { return framePosition_; }
+
+    size_t read(float* samples, size_t maxSamples) override;
+    void seekToFrame(uint64_t frame) override;
+
+private:
+    struct Part
+    {
+        std::string filePath;
+        AudioTrack::Format format;
+    };
+
+    /* Filled by the prefetch thread, handed over to the reading thread once isReady is set */
+    struct Prefetch
+    {
+        std::unique_ptr<SampleReader> reader;
+        std::vector<float> samples;
+        std::atomic<bool> isReady { false };
+    };
+
+    std::unique_ptr<SampleReader> openPart(size_t partIndex) const;
+    void requestPrefetch();
+    bool advanceToNextPart();
+    void switchToPart(size_t partIndex, uint64_t partFrame);
+
+    std::vector<Part> parts_;
+    std::vector<uint64_t> partStartFrames_;     /* Global frame at which each part starts, plus the total frame count */
+    unsigned int sampleRate_ = 0;
+    unsigned int nChannels_ = 0;
+
+    size_t currentPartIndex_ = 0;
+    std::unique_ptr<SampleReader> currentReader_;
+    std::vector<float> prefilledSamples_;       /* Decoded ahead by the prefetch, consumed before currentReader_ */
+    size_t prefilledSamplePosition_ = 0;
+    uint64_t framePosition_ = 0;
+
+    std::shared_ptr<Prefetch> prefetch_;        /* Of the part after the current one, nullptr until requested */
+    int nLatePrefetches_ = 0;
+};
+
+}
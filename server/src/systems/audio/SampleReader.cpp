@@ -0,0 +1,54 @@
+#include "SampleReader.h"
+#include "systems/audio/WavFileReader.h"
+#include "systems/audio/Mp3Reader.h"
+#include "systems/audio/MultiPartReader.h"
+#ifdef PDB_WITH_SNDFILE
+#include "systems/audio/SndfileReader.h"
+#endif
+
+namespace Pdb
+{
+
+std::unique_ptr<SampleReader> SampleReader::create(AudioTrack::Format format)
+{
+    switch (format)
+    {
+        case AudioTrack::Format::WAV:
+            return std::make_unique<WavFileReader>();
+        case AudioTrack::Format::MP3:
+            return std::make_unique<Mp3Reader>();
+        case AudioTrack::Format::MULTI_PART:
+            return std::make_unique<MultiPartReader>();
+#ifdef PDB_WITH_SNDFILE
+        case AudioTrack::Format::FLAC:
+        case AudioTrack::Format::VORBIS:
+        case AudioTrack::Format::OPUS:
+            return std::make_unique<SndfileReader>();
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+bool SampleReader::isSupported(AudioTrack::Format format)
+{
+    switch (format)
+    {
+        case AudioTrack::Format::WAV:
+        case AudioTrack::Format::MP3:
+        case AudioTrack::Format::MULTI_PART:
+            return true;
+        case AudioTrack::Format::FLAC:
+        case AudioTrack::Format::VORBIS:
+        case AudioTrack::Format::OPUS:
+#ifdef PDB_WITH_SNDFILE
+            return SndfileReader::isFormatAvailable(format);
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+}
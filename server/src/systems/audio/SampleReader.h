@@ -0,0 +1,35 @@
+#pragma once
+#include "systems/audio/AudioTrack.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Pdb
+{
+
+/* Streaming source of interleaved float samples (range -1.0 to 1.0) read from an audio file block by block */
+class SampleReader
+{
+public:
+    virtual ~SampleReader() = default;
+
+    /* nullptr when the format is not supported by this build */
+    static std::unique_ptr<SampleReader> create(AudioTrack::Format format);
+    static bool isSupported(AudioTrack::Format format);
+
+    virtual bool open(const std::string& filePath) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    virtual unsigned int getSampleRate() const = 0;
+    virtual unsigned int getChannelCount() const = 0;
+    virtual uint64_t getFrameCount() const = 0;
+    virtual uint64_t getFramePosition() const = 0;
+
+    /* Returns the number of samples read (a multiple of the channel count), 0 at the end of the file */
+    virtual size_t read(float* samples, size_t maxSamples) = 0;
+    virtual void seekToFrame(uint64_t frame) = 0;
+};
+
+}
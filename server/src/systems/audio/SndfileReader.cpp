@@ -0,0 +1,85 @@
+#include "SndfileReader.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+
+namespace Pdb
+{
+
+SndfileReader::~SndfileReader()
+{
+    close();
+}
+
+bool SndfileReader::isFormatAvailable(AudioTrack::Format format)
+{
+    int subtype = 0;
+    if (format == AudioTrack::Format::FLAC) subtype = SF_FORMAT_FLAC;
+    else if (format == AudioTrack::Format::VORBIS) subtype = SF_FORMAT_VORBIS;
+    else if (format == AudioTrack::Format::OPUS)
+    {
+#ifdef SF_FORMAT_OPUS
+        subtype = SF_FORMAT_OPUS;
+#else
+        return false;
+#endif
+    }
+
+    /* Codecs are optional in libsndfile builds */
+    int nSubtypes = 0;
+    sf_command(nullptr, SFC_GET_FORMAT_SUBTYPE_COUNT, &nSubtypes, sizeof(int));
+    for (int i = 0; i < nSubtypes; ++i)
+    {
+        SF_FORMAT_INFO formatInfo {};
+        formatInfo.format = i;
+        sf_command(nullptr, SFC_GET_FORMAT_SUBTYPE, &formatInfo, sizeof(formatInfo));
+        if (formatInfo.format == subtype) return true;
+    }
+    return false;
+}
+
+bool SndfileReader::open(const std::string& filePath)
+{
+    close();
+    info_ = SF_INFO {};
+    file_ = sf_open(filePath.c_str(), SFM_READ, &info_);
+    if (!file_)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not open " << filePath << ": " << sf_strerror(nullptr);
+        return false;
+    }
+    if (info_.channels <= 0 || info_.samplerate <= 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Invalid audio file: " << filePath;
+        close();
+        return false;
+    }
+    framePosition_ = 0;
+    return true;
+}
+
+void SndfileReader::close()
+{
+    if (file_) sf_close(file_);
+    file_ = nullptr;
+    framePosition_ = 0;
+}
+
+size_t SndfileReader::read(float* samples, size_t maxSamples)
+{
+    if (!file_) return 0;
+    const sf_count_t nFrames = sf_readf_float(file_, samples, maxSamples / info_.channels);
+    if (nFrames <= 0) return 0;
+    framePosition_ += nFrames;
+    return nFrames * info_.channels;
+}
+
+void SndfileReader::seekToFrame(uint64_t frame)
+{
+    if (!file_) return;
+    const sf_count_t position = sf_seek(file_, std::min<uint64_t>(frame, info_.frames), SEEK_SET);
+    if (position >= 0) framePosition_ = position;
+    else BOOST_LOG_TRIVIAL(error) << "Seek failed: " << sf_strerror(file_);
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "systems/audio/SampleReader.h"
+
+#include <sndfile.h>
+
+namespace Pdb
+{
+
+/* FLAC, Ogg Vorbis and Ogg Opus files decoded by libsndfile (Opus needs libsndfile 1.0.29 or newer) */
+class SndfileReader : public SampleReader
+{
+public:
+    ~SndfileReader() override;
+
+    static bool isFormatAvailable(AudioTrack::Format format);
+
+    bool open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override { return file_ != nullptr; }
+
+    unsigned int getSampleRate() const override { return info_.samplerate; }
+    unsigned int getChannelCount() const override { return info_.channels; }
+    uint64_t getFrameCount() const override { return info_.frames; }
+    uint64_t getFramePosition() const override { return framePosition_; }
+
+    size_t read(float* samples, size_t maxSamples) override;
+    void seekToFrame(uint64_t frame) override;
+
+private:
+    SNDFILE* file_ = nullptr;
+    SF_INFO info_ {};
+    uint64_t framePosition_ = 0;
+};
+
+}
@@ -0,0 +1,138 @@
+#include "WavFileReader.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace Pdb
+{
+
+namespace
+{
+    const uint16_t formatPcm = 1;
+    const uint16_t formatFloat = 3;
+    const uint16_t formatExtensible = 0xFFFE;
+    const size_t readBufferFrames = 4096;
+
+    uint32_t readUint32(const char* bytes) { uint32_t value; std::memcpy(&value, bytes, 4); return value; }
+    uint16_t readUint16(const char* bytes) { uint16_t value; std::memcpy(&value, bytes, 2); return value; }
+}
+
+bool WavFileReader::open(const std::string& filePath)
+{
+    close();
+    file_.open(filePath, std::ifstream::binary);
+    if (!file_.is_open()) return false;
+
+    char riffHeader[12];
+    if (!file_.read(riffHeader, sizeof(riffHeader)) || std::memcmp(riffHeader, "RIFF", 4) != 0 || std::memcmp(riffHeader + 8, "WAVE", 4) != 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Not a WAV file: " << filePath;
+        close();
+        return false;
+    }
+
+    bool hasFormat = false;
+    uint16_t format = 0;
+    char chunkHeader[8];
+    while (file_.read(chunkHeader, sizeof(chunkHeader)))
+    {
+        const uint32_t chunkSize = readUint32(chunkHeader + 4);
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0)
+        {
+            std::vector<char> chunk(chunkSize);
+            if (chunkSize < 16 || !file_.read(chunk.data(), chunkSize)) break;
+            format = readUint16(chunk.data());
+            nChannels_ = readUint16(chunk.data() + 2);
+            sampleRate_ = readUint32(chunk.data() + 4);
+            bitsPerSample_ = readUint16(chunk.data() + 14);
+            /* Sub-format GUID starts with the actual format tag */
+            if (format == formatExtensible && chunkSize >= 26) format = readUint16(chunk.data() + 24);
+            hasFormat = true;
+        }
+        else if (std::memcmp(chunkHeader, "data", 4) == 0 && hasFormat)
+        {
+            dataOffset_ = file_.tellg();
+            const unsigned int frameSize = nChannels_ * bitsPerSample_ / 8;
+            nFrames_ = (frameSize > 0) ? chunkSize / frameSize : 0;
+            break;
+        }
+        else file_.seekg(chunkSize + (chunkSize & 1), std::ifstream::cur);     /* Chunks are word aligned */
+    }
+
+    isFloat_ = (format == formatFloat);
+    const bool isSupported = (format == formatPcm && (bitsPerSample_ == 16 || bitsPerSample_ == 24 || bitsPerSample_ == 32))
+        || (isFloat_ && bitsPerSample_ == 32);
+    if (dataOffset_ == 0 || nChannels_ == 0 || sampleRate_ == 0 || !isSupported)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Unsupported WAV file: " << filePath << " (format " << format << ", " << bitsPerSample_ << " bits).";
+        close();
+        return false;
+    }
+
+    readBuffer_.resize(readBufferFrames * nChannels_ * bitsPerSample_ / 8);
+    framePosition_ = 0;
+    return true;
+}
+
+void WavFileReader::close()
+{
+    if (file_.is_open()) file_.close();
+    file_.clear();
+    dataOffset_ = 0;
+    nFrames_ = 0;
+    framePosition_ = 0;
+}
+
+size_t WavFileReader::read(float* samples, size_t maxSamples)
+{
+    if (!file_.is_open()) return 0;
+
+    const unsigned int bytesPerSample = bitsPerSample_ / 8;
+    size_t nRead = 0;
+    while (nRead < maxSamples && framePosition_ < nFrames_)
+    {
+        const size_t nFrames = std::min<uint64_t>({ (maxSamples - nRead) / nChannels_, readBufferFrames, nFrames_ - framePosition_ });
+        if (nFrames == 0) break;
+        const size_t nSamples = nFrames * nChannels_;
+        if (!file_.read(readBuffer_.data(), nSamples * bytesPerSample))
+        {
+            /* Truncated file - ends where the data ends */
+            nFrames_ = framePosition_;
+            break;
+        }
+
+        float* output = samples + nRead;
+        if (bitsPerSample_ == 16)
+            DspKernels::int16ToFloat(reinterpret_cast<const int16_t*>(readBuffer_.data()), output, nSamples);
+        else if (isFloat_)
+            std::memcpy(output, readBuffer_.data(), nSamples * sizeof(float));
+        else
+        {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(readBuffer_.data());
+            const float scale = 1.0f / 2147483648.0f;
+            for (size_t i = 0; i < nSamples; ++i, bytes += bytesPerSample)
+            {
+                /* Little endian, aligned to the top of a 32-bit integer */
+                int32_t value = (bitsPerSample_ == 24)
+                    ? (int32_t)((uint32_t)bytes[0] << 8 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 24)
+                    : (int32_t)((uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24);
+                output[i] = value * scale;
+            }
+        }
+        nRead += nSamples;
+        framePosition_ += nFrames;
+    }
+    return nRead;
+}
+
+void WavFileReader::seekToFrame(uint64_t frame)
+{
+    if (!file_.is_open()) return;
+    framePosition_ = std::min(frame, nFrames_);
+    file_.clear();
+    file_.seekg(dataOffset_ + (std::streamoff)(framePosition_ * nChannels_ * (bitsPerSample_ / 8)));
+}
+
+}
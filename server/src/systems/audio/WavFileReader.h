@@ -0,0 +1,41 @@
+#pragma once
+#include "systems/audio/SampleReader.h"
+
+#include <fstream>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Streams samples of a WAV file (16, 24 or 32-bit PCM, 32-bit float) from disk block by block, converted to
+   interleaved float - playing or analysing hours long audiobooks never loads them into memory. */
+class WavFileReader : public SampleReader
+{
+public:
+    bool open(const std::string& filePath) override;
+    void close() override;
+    bool isOpen() const override { return file_.is_open(); }
+
+    unsigned int getSampleRate() const override { return sampleRate_; }
+    unsigned int getChannelCount() const override { return nChannels_; }
+    unsigned int getBitsPerSample() const { return bitsPerSample_; }
+    bool isFloat() const { return isFloat_; }
+    uint64_t getFrameCount() const override { return nFrames_; }
+    uint64_t getFramePosition() const override { return framePosition_; }
+
+    size_t read(float* samples, size_t maxSamples) override;
+    void seekToFrame(uint64_t frame) override;
+
+private:
+    std::ifstream file_;
+    unsigned int sampleRate_ = 0;
+    unsigned int nChannels_ = 0;
+    unsigned int bitsPerSample_ = 0;
+    bool isFloat_ = false;
+    std::streamoff dataOffset_ = 0;
+    uint64_t nFrames_ = 0;
+    uint64_t framePosition_ = 0;
+    std::vector<char> readBuffer_;
+};
+
+}
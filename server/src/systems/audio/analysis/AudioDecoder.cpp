@@ -0,0 +1,130 @@
+#include "AudioDecoder.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <sys/stat.h>
+
+namespace Pdb
+{
+
+AudioDecoder::AudioDecoder() : format_(Format::NONE), sampleRate_(0), nChannels_(0), mh_(nullptr),
+    nMp3SamplesLeft_(0), mp3SamplePosition_(0), doneDecodingMp3_(false), mp3FileSize_(0)
+{
+}
+
+AudioDecoder::~AudioDecoder()
+{
+    close();
+    if (mh_) mpg123_delete(mh_);
+}
+
+bool AudioDecoder::open(const std::string& filePath)
+{
+    close();
+    const AudioTrack::Format fileFormat = AudioTrack::detectFormat(filePath);
+
+    if (fileFormat == AudioTrack::Format::MP3)
+    {
+        if (!mh_)
+        {
+            mpg123_init();
+            int err;
+            mh_ = mpg123_new(NULL, &err);
+            if (!mh_) return false;
+            mpg123_param(mh_, MPG123_ADD_FLAGS, MPG123_QUIET, 0.0);
+        }
+        long rate;
+        int channels, encoding;
+        if (mpg123_open(mh_, filePath.c_str()) != MPG123_OK || mpg123_getformat(mh_, &rate, &channels, &encoding) != MPG123_OK)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Could not open mp3 file for decoding: " << filePath;
+            mpg123_close(mh_);
+            return false;
+        }
+        /* Output format locked, so it cannot change in the middle of the file */
+        mpg123_format_none(mh_);
+        mpg123_format(mh_, rate, channels, MPG123_ENC_SIGNED_16);
+        sampleRate_ = rate;
+        nChannels_ = channels;
+        mp3DecoderOutputBuffer_.resize(mpg123_outblock(mh_) / sizeof(int16_t));
+        nMp3SamplesLeft_ = 0;
+        mp3SamplePosition_ = 0;
+        doneDecodingMp3_ = false;
+        struct stat fileStatus;
+        mp3FileSize_ = (stat(filePath.c_str(), &fileStatus) == 0) ? fileStatus.st_size : 0;
+        format_ = Format::MP3;
+    }
+    else
+    {
+        sampleReader_ = SampleReader::create(fileFormat);
+        if (!sampleReader_)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Unsupported audio format (" << AudioTrack::getFormatName(fileFormat) << "), cannot decode: " << filePath;
+            return false;
+        }
+        if (!sampleReader_->open(filePath)) return false;
+        sampleRate_ = sampleReader_->getSampleRate();
+        nChannels_ = sampleReader_->getChannelCount();
+        format_ = Format::SAMPLE_READER;
+    }
+    return nChannels_ > 0 && sampleRate_ > 0;
+}
+
+void AudioDecoder::close()
+{
+    if (format_ == Format::MP3) mpg123_close(mh_);
+    else if (format_ == Format::SAMPLE_READER) sampleReader_->close();
+    format_ = Format::NONE;
+}
+
+size_t AudioDecoder::read(float* samples, size_t maxSamples)
+{
+    maxSamples -= maxSamples % std::max(1u, nChannels_);
+
+    if (format_ == Format::MP3)
+    {
+        size_t nRead = 0;
+        while (nRead < maxSamples)
+        {
+            if (nMp3SamplesLeft_ == 0)
+            {
+                if (doneDecodingMp3_) break;
+                size_t nDecodedBytes = 0;
+                int mpg123readResult = mpg123_read(mh_, mp3DecoderOutputBuffer_.data(), mp3DecoderOutputBuffer_.size() * sizeof(int16_t), &nDecodedBytes);
+                if (mpg123readResult != MPG123_OK) doneDecodingMp3_ = true;
+                nMp3SamplesLeft_ = nDecodedBytes / sizeof(int16_t);
+                mp3SamplePosition_ = 0;
+                continue;
+            }
+            const size_t nSamples = std::min(maxSamples - nRead, nMp3SamplesLeft_);
+            DspKernels::int16ToFloat(mp3DecoderOutputBuffer_.data() + mp3SamplePosition_, samples + nRead, nSamples);
+            nRead += nSamples;
+            mp3SamplePosition_ += nSamples;
+            nMp3SamplesLeft_ -= nSamples;
+        }
+        return nRead;
+    }
+    else if (format_ == Format::SAMPLE_READER)
+    {
+        return sampleReader_->read(samples, maxSamples);
+    }
+    return 0;
+}
+
+double AudioDecoder::getProgress() const
+{
+    if (format_ == Format::MP3)
+    {
+        if (doneDecodingMp3_) return 1.0;
+        return (mp3FileSize_ > 0) ? std::min(1.0, (double)mpg123_tell_stream(mh_) / mp3FileSize_) : 0.0;
+    }
+    else if (format_ == Format::SAMPLE_READER)
+    {
+        const uint64_t nFrames = sampleReader_->getFrameCount();
+        return (nFrames > 0) ? std::min(1.0, (double)sampleReader_->getFramePosition() / nFrames) : 1.0;
+    }
+    return 0.0;
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <mpg123.h>
+#include "systems/audio/SampleReader.h"
+
+#include <string>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Decodes a whole audio file (mp3 or any SampleReader format) sequentially into interleaved float samples.
+   Used by background jobs analysing audiobooks - not by playback. */
+class AudioDecoder
+{
+public:
+    AudioDecoder();
+    ~AudioDecoder();
+
+    bool open(const std::string& filePath);
+    void close();
+
+    unsigned int getSampleRate() const { return sampleRate_; }
+    unsigned int getChannelCount() const { return nChannels_; }
+
+    /* Returns the number of samples read (a multiple of the channel count), 0 at the end of the file */
+    size_t read(float* samples, size_t maxSamples);
+    /* Fraction of the file decoded so far, from 0.0 to 1.0 */
+    double getProgress() const;
+
+private:
+    enum class Format { NONE, MP3, SAMPLE_READER };
+
+    Format format_;
+    unsigned int sampleRate_;
+    unsigned int nChannels_;
+
+    mpg123_handle* mh_;
+    std::vector<int16_t> mp3DecoderOutputBuffer_;
+    size_t nMp3SamplesLeft_;
+    size_t mp3SamplePosition_;
+    bool doneDecodingMp3_;
+
+    off_t mp3FileSize_;
+
+    std::unique_ptr<SampleReader> sampleReader_;
+};
+
+}
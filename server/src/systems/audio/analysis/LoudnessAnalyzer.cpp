@@ -0,0 +1,149 @@
+#include "LoudnessAnalyzer.h"
+#include "AudioDecoder.h"
+#include "LoudnessMeter.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace filesystem = boost::filesystem;
+
+namespace Pdb
+{
+
+namespace
+{
+    const char* cacheFilePath = "../data/loudness_cache.txt";
+    /* Stored for files with nothing above the absolute gate, they are never normalized */
+    const double silentLoudness = -200.0;
+}
+
+LoudnessAnalyzer::LoudnessAnalyzer() : nPendingJobs_(0)
+{
+    loadCache();
+}
+
+void LoudnessAnalyzer::analyze(const std::vector<std::string>& filePaths)
+{
+    if (!Config::getInstance().loudnessNormalization) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const std::string& filePath : filePaths)
+    {
+        boost::system::error_code error;
+        const uintmax_t fileSize = filesystem::file_size(filePath, error);
+        if (error) continue;
+        const std::time_t modificationTime = filesystem::last_write_time(filePath, error);
+        if (error) continue;
+
+        auto entry = entries_.find(getFileName(filePath));
+        if (entry != entries_.end() && entry->second.fileSize == fileSize && entry->second.modificationTime == modificationTime)
+            continue;
+
+        ++nPendingJobs_;
+        ThreadPoolExecutor::background().post([this, filePath, fileSize, modificationTime]
+        {
+            analyzeFile(filePath, fileSize, modificationTime);
+        });
+    }
+    if (nPendingJobs_ > 0) BOOST_LOG_TRIVIAL(info) << "Loudness analysis scheduled for " << nPendingJobs_ << " audio tracks.";
+}
+
+float LoudnessAnalyzer::getNormalizationGain(const std::string& filePath) const
+{
+    const Config& config = Config::getInstance();
+    if (!config.loudnessNormalization) return 1.0f;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = entries_.find(getFileName(filePath));
+    if (entry == entries_.end() || entry->second.loudness <= silentLoudness) return 1.0f;
+
+    const double gainDb = std::min<double>(config.maxNormalizationGainDb,
+        std::max<double>(-config.maxNormalizationGainDb, config.targetLoudness - entry->second.loudness));
+    return std::pow(10.0, gainDb / 20.0);
+}
+
+void LoudnessAnalyzer::analyzeFile(const std::string& filePath, uintmax_t fileSize, std::time_t modificationTime)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    AudioDecoder decoder;
+    if (!decoder.open(filePath))
+    {
+        --nPendingJobs_;
+        return;
+    }
+
+    LoudnessMeter loudnessMeter(decoder.getSampleRate(), decoder.getChannelCount());
+    std::vector<float> samples(16384);
+    for (size_t nSamples; (nSamples = decoder.read(samples.data(), samples.size())) > 0; )
+        loudnessMeter.addSamples(samples.data(), nSamples);
+    double loudness = loudnessMeter.getIntegratedLoudness();
+    if (!std::isfinite(loudness)) loudness = silentLoudness;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[getFileName(filePath)] = Entry { fileSize, modificationTime, loudness };
+        saveCache();
+    }
+    --nPendingJobs_;
+
+    BOOST_LOG_TRIVIAL(info) << "Loudness of " << getFileName(filePath) << ": " << loudness << " LUFS, normalization gain "
+        << 20.0 * std::log10(getNormalizationGain(filePath)) << " dB (analysed in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count()
+        << " ms, " << nPendingJobs_ << " left).";
+}
+
+void LoudnessAnalyzer::loadCache()
+{
+    std::ifstream inputFile(cacheFilePath);
+    if (!inputFile.is_open()) return;
+
+    for (std::string line; std::getline(inputFile, line);)
+    {
+        std::istringstream iss(line);
+        std::string fileName;
+        Entry entry;
+        long long modificationTime;
+        if (iss >> fileName >> entry.fileSize >> modificationTime >> entry.loudness)
+        {
+            entry.modificationTime = modificationTime;
+            entries_[fileName] = entry;
+        }
+    }
+    BOOST_LOG_TRIVIAL(info) << "Loaded loudness of " << entries_.size() << " audio tracks.";
+}
+
+void LoudnessAnalyzer::saveCache() const
+{
+    /* Written aside and renamed, so a crash never leaves a truncated cache */
+    const std::string temporaryFilePath = std::string(cacheFilePath) + ".tmp";
+    {
+        std::ofstream outputFile(temporaryFilePath, std::ofstream::out | std::ofstream::trunc);
+        if (!outputFile.is_open())
+        {
+            BOOST_LOG_TRIVIAL(error) << "File " << temporaryFilePath << " could not be opened.";
+            return;
+        }
+        for (auto& entry : entries_)
+        {
+            outputFile << entry.first << " " << entry.second.fileSize << " " << (long long)entry.second.modificationTime
+                << " " << entry.second.loudness << "\n";
+        }
+    }
+    boost::system::error_code error;
+    filesystem::rename(temporaryFilePath, cacheFilePath, error);
+    if (error) BOOST_LOG_TRIVIAL(error) << "Could not save loudness cache: " << error.message();
+}
+
+std::string LoudnessAnalyzer::getFileName(const std::string& filePath)
+{
+    return filesystem::path(filePath).filename().string();
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Measures loudness of audiobooks in the background and keeps a normalization gain per file.
+   Results are cached in ../data/loudness_cache.txt by file name, size and modification time, so only new
+   or changed files are decoded again. Files are analysed one job at a time on the shared background
+   executor - startup never waits for it, tracks just play at unity gain until their analysis is done. */
+class LoudnessAnalyzer
+{
+public:
+    static LoudnessAnalyzer& getInstance()
+    {
+        static LoudnessAnalyzer* instance = new LoudnessAnalyzer();
+        return *instance;
+    }
+
+    void analyze(const std::vector<std::string>& filePaths);
+
+    /* Linear gain bringing the file to the target loudness, 1.0 when not analysed yet or disabled */
+    float getNormalizationGain(const std::string& filePath) const;
+
+private:
+    LoudnessAnalyzer();
+
+    struct Entry
+    {
+        uintmax_t fileSize;
+        std::time_t modificationTime;
+        double loudness;    /* LUFS */
+    };
+
+    void analyzeFile(const std::string& filePath, uintmax_t fileSize, std::time_t modificationTime);
+    void loadCache();
+    void saveCache() const;
+    static std::string getFileName(const std::string& filePath);
+
+    std::unordered_map<std::string, Entry> entries_;
+    std::atomic<int> nPendingJobs_;
+    mutable std::mutex mutex_;
+};
+
+}
@@ -0,0 +1,85 @@
+#include "LoudnessMeter.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Pdb
+{
+
+namespace
+{
+    const double absoluteGate = -70.0;
+    const double relativeGate = -10.0;
+    const size_t stepsPerBlock = 4;
+}
+
+LoudnessMeter::LoudnessMeter(unsigned int sampleRate, unsigned int nChannels)
+    : nChannels_(std::max(1u, nChannels)),
+    /* K-weighting: head related high shelf and revised low frequency B-curve high-pass */
+    preFilter_(Biquad::Type::HIGHSHELF, 1681.97f, 0.7072f, 4.0f),
+    rlbFilter_(Biquad::Type::HIGHPASS, 38.13f, 0.5003f),
+    framesPerStep_(std::max(1u, sampleRate / 10)), nStepFrames_(0), stepSumOfSquares_(0.0)
+{
+    preFilter_.prepare(sampleRate, nChannels_);
+    rlbFilter_.prepare(sampleRate, nChannels_);
+}
+
+void LoudnessMeter::addSamples(float* samples, size_t nSamples)
+{
+    const size_t nFrames = nSamples / nChannels_;
+    preFilter_.process(samples, nFrames);
+    rlbFilter_.process(samples, nFrames);
+
+    size_t frame = 0;
+    while (frame < nFrames)
+    {
+        const size_t nStepFramesToAdd = std::min(framesPerStep_ - nStepFrames_, nFrames - frame);
+        /* With equal channel weights the sum of per-channel mean squares is the interleaved sum over the frame count */
+        stepSumOfSquares_ += DspKernels::sumOfSquares(samples + frame * nChannels_, nStepFramesToAdd * nChannels_);
+        nStepFrames_ += nStepFramesToAdd;
+        frame += nStepFramesToAdd;
+
+        if (nStepFrames_ == framesPerStep_)
+        {
+            stepPowers_.push_back(stepSumOfSquares_ / framesPerStep_);
+            stepSumOfSquares_ = 0.0;
+            nStepFrames_ = 0;
+            if (stepPowers_.size() >= stepsPerBlock)
+            {
+                double blockPower = 0.0;
+                for (size_t i = stepPowers_.size() - stepsPerBlock; i < stepPowers_.size(); ++i) blockPower += stepPowers_[i];
+                blockPowers_.push_back(blockPower / stepsPerBlock);
+                stepPowers_.erase(stepPowers_.begin());
+            }
+        }
+    }
+}
+
+double LoudnessMeter::powerToLoudness(double power)
+{
+    return -0.691 + 10.0 * std::log10(power);
+}
+
+double LoudnessMeter::getIntegratedLoudness() const
+{
+    const double absoluteGatePower = std::pow(10.0, (absoluteGate + 0.691) / 10.0);
+    double powerSum = 0.0;
+    size_t nBlocks = 0;
+    for (double blockPower : blockPowers_)
+        if (blockPower > absoluteGatePower) { powerSum += blockPower; ++nBlocks; }
+    if (nBlocks == 0) return -std::numeric_limits<double>::infinity();
+
+    const double relativeGatePower = std::pow(10.0, (powerToLoudness(powerSum / nBlocks) + relativeGate + 0.691) / 10.0);
+    const double gatePower = std::max(absoluteGatePower, relativeGatePower);
+    powerSum = 0.0;
+    nBlocks = 0;
+    for (double blockPower : blockPowers_)
+        if (blockPower > gatePower) { powerSum += blockPower; ++nBlocks; }
+    if (nBlocks == 0) return -std::numeric_limits<double>::infinity();
+
+    return powerToLoudness(powerSum / nBlocks);
+}
+
+}
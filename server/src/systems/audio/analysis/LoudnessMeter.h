@@ -0,0 +1,37 @@
+#pragma once
+#include "systems/audio/dsp/Biquad.h"
+
+#include <vector>
+
+namespace Pdb
+{
+
+/* Integrated loudness as defined by EBU R128 / ITU-R BS.1770: K-weighted mean square in 400 ms blocks
+   overlapping by 75%, gated at -70 LUFS (absolute) and 10 LU below the ungated mean (relative).
+   All channels are weighted 1.0 (no surround channels in audiobooks). */
+class LoudnessMeter
+{
+public:
+    LoudnessMeter(unsigned int sampleRate, unsigned int nChannels);
+
+    /* Interleaved samples, filtered in place */
+    void addSamples(float* samples, size_t nSamples);
+
+    /* In LUFS, -infinity when everything was below the absolute gate */
+    double getIntegratedLoudness() const;
+
+private:
+    static double powerToLoudness(double power);
+
+    unsigned int nChannels_;
+    Biquad preFilter_;
+    Biquad rlbFilter_;
+
+    size_t framesPerStep_;          /* 100 ms */
+    size_t nStepFrames_;
+    double stepSumOfSquares_;
+    std::vector<double> stepPowers_;
+    std::vector<double> blockPowers_;    /* Mean square of every 400 ms block */
+};
+
+}
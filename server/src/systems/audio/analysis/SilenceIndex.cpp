@@ -0,0 +1,171 @@
+#include "SilenceIndex.h"
+#include "AudioDecoder.h"
+#include "systems/audio/dsp/DspKernels.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Pdb
+{
+
+namespace
+{
+    const char fileMagic[4] = { 'P', 'D', 'B', 'S' };
+    const uint32_t fileVersion = 1;
+    const unsigned int blockMilliseconds = 10;
+    const uint32_t minSilenceMilliseconds = 250;
+
+    template <typename T> void writeValue(std::ofstream& outputFile, const T& value)
+    {
+        outputFile.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T> bool readValue(std::ifstream& inputFile, T& value)
+    {
+        return static_cast<bool>(inputFile.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+std::unique_ptr<SilenceIndex> SilenceIndex::build(const std::string& filePath, uintmax_t fileSize, std::time_t modificationTime, float thresholdDb)
+{
+    AudioDecoder decoder;
+    if (!decoder.open(filePath)) return nullptr;
+
+    std::unique_ptr<SilenceIndex> silenceIndex(new SilenceIndex());
+    silenceIndex->fileSize_ = fileSize;
+    silenceIndex->modificationTime_ = modificationTime;
+    silenceIndex->thresholdDb_ = thresholdDb;
+
+    /* Compared with the mean square of a block, no square root nor log per block */
+    const double thresholdPower = std::pow(10.0, thresholdDb / 10.0);
+    const size_t blockSamples = decoder.getSampleRate() * blockMilliseconds / 1000 * decoder.getChannelCount();
+    std::vector<float> block(blockSamples);
+
+    uint32_t blockStartMillisecond = 0;
+    uint32_t silenceStartMillisecond = 0;
+    bool isInSilence = false;
+    auto endSilence = [&](uint32_t endMillisecond)
+    {
+        if (isInSilence && endMillisecond - silenceStartMillisecond >= minSilenceMilliseconds)
+            silenceIndex->silences_.push_back(Silence { silenceStartMillisecond, endMillisecond });
+        isInSilence = false;
+    };
+
+    for (size_t nSamples; (nSamples = decoder.read(block.data(), blockSamples)) > 0; blockStartMillisecond += blockMilliseconds)
+    {
+        const bool isSilent = DspKernels::sumOfSquares(block.data(), nSamples) / nSamples < thresholdPower;
+        if (isSilent && !isInSilence)
+        {
+            isInSilence = true;
+            silenceStartMillisecond = blockStartMillisecond;
+        }
+        else if (!isSilent) endSilence(blockStartMillisecond);
+    }
+    endSilence(blockStartMillisecond);
+
+    return silenceIndex;
+}
+
+std::unique_ptr<SilenceIndex> SilenceIndex::load(const std::string& indexFilePath)
+{
+    std::ifstream inputFile(indexFilePath, std::ifstream::binary);
+    if (!inputFile.is_open()) return nullptr;
+
+    char magic[4];
+    uint32_t version, nSilences;
+    std::unique_ptr<SilenceIndex> silenceIndex(new SilenceIndex());
+    if (!inputFile.read(magic, sizeof(magic)) || std::memcmp(magic, fileMagic, sizeof(magic)) != 0
+        || !readValue(inputFile, version) || version != fileVersion
+        || !readValue(inputFile, silenceIndex->fileSize_) || !readValue(inputFile, silenceIndex->modificationTime_)
+        || !readValue(inputFile, silenceIndex->thresholdDb_) || !readValue(inputFile, nSilences))
+    {
+        BOOST_LOG_TRIVIAL(error) << "Invalid silence index: " << indexFilePath;
+        return nullptr;
+    }
+
+    silenceIndex->silences_.resize(nSilences);
+    for (Silence& silence : silenceIndex->silences_)
+    {
+        if (!readValue(inputFile, silence.startMillisecond) || !readValue(inputFile, silence.endMillisecond))
+        {
+            BOOST_LOG_TRIVIAL(error) << "Truncated silence index: " << indexFilePath;
+            return nullptr;
+        }
+    }
+    return silenceIndex;
+}
+
+bool SilenceIndex::save(const std::string& indexFilePath) const
+{
+    /* Written aside and renamed, so a crash never leaves a truncated index */
+    const std::string temporaryFilePath = indexFilePath + ".tmp";
+    {
+        std::ofstream outputFile(temporaryFilePath, std::ofstream::binary | std::ofstream::trunc);
+        if (!outputFile.is_open())
+        {
+            BOOST_LOG_TRIVIAL(error) << "File " << temporaryFilePath << " could not be opened.";
+            return false;
+        }
+        outputFile.write(fileMagic, sizeof(fileMagic));
+        writeValue(outputFile, fileVersion);
+        writeValue(outputFile, fileSize_);
+        writeValue(outputFile, modificationTime_);
+        writeValue(outputFile, thresholdDb_);
+        writeValue(outputFile, static_cast<uint32_t>(silences_.size()));
+        for (const Silence& silence : silences_)
+        {
+            writeValue(outputFile, silence.startMillisecond);
+            writeValue(outputFile, silence.endMillisecond);
+        }
+        if (!outputFile) return false;
+    }
+    boost::system::error_code error;
+    boost::filesystem::rename(temporaryFilePath, indexFilePath, error);
+    return !error;
+}
+
+bool SilenceIndex::matches(uintmax_t fileSize, std::time_t modificationTime, float thresholdDb) const
+{
+    return fileSize_ == fileSize && modificationTime_ == modificationTime && thresholdDb_ == thresholdDb;
+}
+
+const SilenceIndex::Silence* SilenceIndex::findSilence(int millisecond) const
+{
+    if (millisecond < 0) return nullptr;
+    /* First silence ending after the position */
+    auto silence = std::upper_bound(silences_.begin(), silences_.end(), (uint32_t)millisecond,
+        [](uint32_t position, const Silence& silence) { return position < silence.endMillisecond; });
+    if (silence != silences_.end() && silence->startMillisecond <= (uint32_t)millisecond) return &*silence;
+    return nullptr;
+}
+
+int SilenceIndex::snapToSpeechStart(int millisecond, int maxDistance) const
+{
+    int snappedMillisecond = millisecond;
+    int bestDistance = maxDistance + 1;
+    auto silence = std::lower_bound(silences_.begin(), silences_.end(), (uint32_t)std::max(0, millisecond - maxDistance),
+        [](const Silence& silence, uint32_t position) { return silence.endMillisecond < position; });
+    for (; silence != silences_.end() && (int)silence->endMillisecond <= millisecond + maxDistance; ++silence)
+    {
+        const int distance = std::abs((int)silence->endMillisecond - millisecond);
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            snappedMillisecond = silence->endMillisecond;
+        }
+    }
+    return snappedMillisecond;
+}
+
+uint64_t SilenceIndex::getTotalSilenceMilliseconds() const
+{
+    uint64_t total = 0;
+    for (const Silence& silence : silences_) total += silence.getDuration();
+    return total;
+}
+
+}
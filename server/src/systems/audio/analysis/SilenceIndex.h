@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Sorted list of pauses (runs of 10 ms blocks quieter than a threshold, at least 250 ms long) in an audio file.
+   Persisted next to the file as a small binary sidecar, "<file>.silence". Immutable once built, so it can be
+   shared with the audio thread without locking. */
+class SilenceIndex
+{
+public:
+    struct Silence
+    {
+        uint32_t startMillisecond;
+        uint32_t endMillisecond;
+
+        uint32_t getDuration() const { return endMillisecond - startMillisecond; }
+    };
+
+    /* Decodes the whole file, nullptr when it cannot be decoded */
+    static std::unique_ptr<SilenceIndex> build(const std::string& filePath, uintmax_t fileSize, std::time_t modificationTime, float thresholdDb);
+    static std::unique_ptr<SilenceIndex> load(const std::string& indexFilePath);
+    bool save(const std::string& indexFilePath) const;
+    static std::string getIndexFilePath(const std::string& filePath) { return filePath + ".silence"; }
+
+    /* Index is still valid for the file and settings */
+    bool matches(uintmax_t fileSize, std::time_t modificationTime, float thresholdDb) const;
+
+    /* Silence containing the position, nullptr when there is none */
+    const Silence* findSilence(int millisecond) const;
+    /* End of the nearest silence (where speech starts again) within maxDistance, millisecond itself if there is none */
+    int snapToSpeechStart(int millisecond, int maxDistance) const;
+
+    size_t getSilenceCount() const { return silences_.size(); }
+    uint64_t getTotalSilenceMilliseconds() const;
+
+private:
+    SilenceIndex() = default;
+
+    uint64_t fileSize_;
+    int64_t modificationTime_;
+    float thresholdDb_;
+    std::vector<Silence> silences_;
+};
+
+}
@@ -0,0 +1,57 @@
+#include "SilenceScanner.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+#include <chrono>
+
+namespace filesystem = boost::filesystem;
+
+namespace Pdb
+{
+
+void SilenceScanner::scan(const std::vector<std::string>& filePaths)
+{
+    for (const std::string& filePath : filePaths)
+        ThreadPoolExecutor::background().post([this, filePath] { scanFile(filePath); });
+}
+
+std::shared_ptr<const SilenceIndex> SilenceScanner::getIndex(const std::string& filePath) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto silenceIndex = silenceIndexes_.find(filePath);
+    return (silenceIndex != silenceIndexes_.end()) ? silenceIndex->second : nullptr;
+}
+
+void SilenceScanner::scanFile(const std::string& filePath)
+{
+    boost::system::error_code error;
+    const uintmax_t fileSize = filesystem::file_size(filePath, error);
+    if (error) return;
+    const std::time_t modificationTime = filesystem::last_write_time(filePath, error);
+    if (error) return;
+
+    const float thresholdDb = Config::getInstance().silenceThresholdDb;
+    const std::string indexFilePath = SilenceIndex::getIndexFilePath(filePath);
+    std::shared_ptr<const SilenceIndex> silenceIndex = SilenceIndex::load(indexFilePath);
+
+    if (!silenceIndex || !silenceIndex->matches(fileSize, modificationTime, thresholdDb))
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        std::unique_ptr<SilenceIndex> builtSilenceIndex = SilenceIndex::build(filePath, fileSize, modificationTime, thresholdDb);
+        if (!builtSilenceIndex) return;
+        if (!builtSilenceIndex->save(indexFilePath))
+            BOOST_LOG_TRIVIAL(error) << "Could not save silence index: " << indexFilePath;
+        silenceIndex = std::move(builtSilenceIndex);
+
+        BOOST_LOG_TRIVIAL(info) << "Built silence index of " << filePath << ": " << silenceIndex->getSilenceCount() << " silences, "
+            << silenceIndex->getTotalSilenceMilliseconds() / 1000 << " s in total (in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count() << " ms).";
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    silenceIndexes_[filePath] = std::move(silenceIndex);
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "systems/audio/analysis/SilenceIndex.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Provides silence indexes of audiobooks. Sidecars are loaded, or (re)built when missing or stale, by jobs on
+   the shared background executor - until then getIndex() returns nullptr and playback is not affected. */
+class SilenceScanner
+{
+public:
+    static SilenceScanner& getInstance()
+    {
+        static SilenceScanner* instance = new SilenceScanner();
+        return *instance;
+    }
+
+    void scan(const std::vector<std::string>& filePaths);
+
+    std::shared_ptr<const SilenceIndex> getIndex(const std::string& filePath) const;
+
+private:
+    SilenceScanner() = default;
+
+    void scanFile(const std::string& filePath);
+
+    std::unordered_map<std::string, std::shared_ptr<const SilenceIndex>> silenceIndexes_;
+    mutable std::mutex mutex_;
+};
+
+}
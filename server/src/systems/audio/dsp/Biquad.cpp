@@ -0,0 +1,91 @@
+#include "Biquad.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Pdb
+{
+
+Biquad::Biquad(Type type, float frequency, float q, float gainDb)
+    : type_(type), frequency_(frequency), q_(q), gainDb_(gainDb), nChannels_(1),
+    b0_(1.0f), b1_(0.0f), b2_(0.0f), a1_(0.0f), a2_(0.0f)
+{
+}
+
+void Biquad::prepare(unsigned int sampleRate, unsigned int nChannels)
+{
+    nChannels_ = std::max(1u, nChannels);
+    z1_.assign(nChannels_, 0.0f);
+    z2_.assign(nChannels_, 0.0f);
+
+    /* Kept below Nyquist, otherwise the filter becomes unstable */
+    const double frequency = std::min<double>(frequency_, 0.45 * sampleRate);
+    const double omega = 2.0 * M_PI * frequency / sampleRate;
+    const double cosOmega = std::cos(omega);
+    const double alpha = std::sin(omega) / (2.0 * std::max(0.01f, q_));
+    const double a = std::pow(10.0, gainDb_ / 40.0);
+
+    double b0, b1, b2, a0, a1, a2;
+    switch (type_)
+    {
+        case Type::LOWPASS:
+            b0 = (1.0 - cosOmega) / 2.0; b1 = 1.0 - cosOmega; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosOmega; a2 = 1.0 - alpha;
+            break;
+        case Type::HIGHPASS:
+            b0 = (1.0 + cosOmega) / 2.0; b1 = -(1.0 + cosOmega); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cosOmega; a2 = 1.0 - alpha;
+            break;
+        case Type::PEAKING:
+            b0 = 1.0 + alpha * a; b1 = -2.0 * cosOmega; b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a; a1 = -2.0 * cosOmega; a2 = 1.0 - alpha / a;
+            break;
+        case Type::LOWSHELF:
+        {
+            const double beta = 2.0 * std::sqrt(a) * alpha;
+            b0 = a * ((a + 1.0) - (a - 1.0) * cosOmega + beta);
+            b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosOmega);
+            b2 = a * ((a + 1.0) - (a - 1.0) * cosOmega - beta);
+            a0 = (a + 1.0) + (a - 1.0) * cosOmega + beta;
+            a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosOmega);
+            a2 = (a + 1.0) + (a - 1.0) * cosOmega - beta;
+            break;
+        }
+        case Type::HIGHSHELF:
+        default:
+        {
+            const double beta = 2.0 * std::sqrt(a) * alpha;
+            b0 = a * ((a + 1.0) + (a - 1.0) * cosOmega + beta);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosOmega);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cosOmega - beta);
+            a0 = (a + 1.0) - (a - 1.0) * cosOmega + beta;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosOmega);
+            a2 = (a + 1.0) - (a - 1.0) * cosOmega - beta;
+            break;
+        }
+    }
+
+    b0_ = b0 / a0; b1_ = b1 / a0; b2_ = b2 / a0;
+    a1_ = a1 / a0; a2_ = a2 / a0;
+}
+
+void Biquad::process(float* samples, size_t nFrames)
+{
+    for (unsigned int channel = 0; channel < nChannels_; ++channel)
+    {
+        float z1 = z1_[channel], z2 = z2_[channel];
+        float* sample = samples + channel;
+        for (size_t i = 0; i < nFrames; ++i, sample += nChannels_)
+        {
+            const float input = *sample;
+            const float output = b0_ * input + z1;
+            z1 = b1_ * input - a1_ * output + z2;
+            z2 = b2_ * input - a2_ * output;
+            *sample = output;
+        }
+        z1_[channel] = z1;
+        z2_[channel] = z2;
+    }
+}
+
+}
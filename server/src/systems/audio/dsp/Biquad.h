@@ -0,0 +1,32 @@
+#pragma once
+#include "systems/audio/dsp/Effect.h"
+
+#include <vector>
+
+namespace Pdb
+{
+
+/* Second order IIR filter (RBJ audio EQ cookbook), transposed direct form II with a state per channel.
+   The recursion is inherently serial, so unlike the other effects it runs as a plain per-sample loop. */
+class Biquad : public Effect
+{
+public:
+    enum class Type { LOWPASS, HIGHPASS, PEAKING, LOWSHELF, HIGHSHELF };
+
+    Biquad(Type type, float frequency, float q, float gainDb = 0.0f);
+
+    void prepare(unsigned int sampleRate, unsigned int nChannels) override;
+    void process(float* samples, size_t nFrames) override;
+
+private:
+    Type type_;
+    float frequency_;
+    float q_;
+    float gainDb_;
+
+    unsigned int nChannels_;
+    float b0_, b1_, b2_, a1_, a2_;
+    std::vector<float> z1_, z2_;
+};
+
+}
@@ -0,0 +1,69 @@
+#include "Compressor.h"
+#include "DspKernels.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace Pdb
+{
+
+Compressor::Compressor(float thresholdDb, float ratio, float attackMilliseconds, float releaseMilliseconds, float makeupGainDb)
+    : thresholdDb_(thresholdDb), ratio_(std::max(1.0f, ratio)), attackMilliseconds_(attackMilliseconds),
+    releaseMilliseconds_(releaseMilliseconds), makeupGainDb_(makeupGainDb), nChannels_(1),
+    attackCoefficient_(0.0f), releaseCoefficient_(0.0f), gainReductionDb_(0.0f), previousGain_(1.0f)
+{
+}
+
+Compressor Compressor::limiter(float thresholdDb, float releaseMilliseconds)
+{
+    return Compressor(thresholdDb, 100.0f, 0.5f, releaseMilliseconds);
+}
+
+void Compressor::prepare(unsigned int sampleRate, unsigned int nChannels)
+{
+    nChannels_ = std::min<unsigned int>(std::max(1u, nChannels), maxChannels);
+
+    /* Envelope is updated once per sub-block */
+    const float updateRate = (float)sampleRate / detectionFrames;
+    auto coefficient = [updateRate](float milliseconds)
+    {
+        return (milliseconds > 0.0f) ? std::exp(-1000.0f / (milliseconds * updateRate)) : 0.0f;
+    };
+    attackCoefficient_ = coefficient(attackMilliseconds_);
+    releaseCoefficient_ = coefficient(releaseMilliseconds_);
+    gainReductionDb_ = 0.0f;
+    previousGain_ = std::pow(10.0f, makeupGainDb_ / 20.0f);
+}
+
+float Compressor::computeGain(float peak)
+{
+    const float levelDb = 20.0f * std::log10(std::max(peak, 1e-6f));
+    const float overDb = levelDb - thresholdDb_;
+    const float targetReductionDb = (overDb > 0.0f) ? overDb * (1.0f - 1.0f / ratio_) : 0.0f;
+    const float coefficient = (targetReductionDb > gainReductionDb_) ? attackCoefficient_ : releaseCoefficient_;
+    gainReductionDb_ = coefficient * gainReductionDb_ + (1.0f - coefficient) * targetReductionDb;
+    return std::pow(10.0f, (makeupGainDb_ - gainReductionDb_) / 20.0f);
+}
+
+void Compressor::process(float* samples, size_t nFrames)
+{
+    for (size_t frame = 0; frame < nFrames; frame += detectionFrames)
+    {
+        const size_t nBlockFrames = std::min(detectionFrames, nFrames - frame);
+        const size_t nBlockSamples = nBlockFrames * nChannels_;
+        float* block = samples + frame * nChannels_;
+
+        const float gain = computeGain(DspKernels::peak(block, nBlockSamples));
+        const float gainStep = (gain - previousGain_) / nBlockFrames;
+        for (size_t i = 0; i < nBlockFrames; ++i)
+        {
+            const float frameGain = previousGain_ + gainStep * (i + 1);
+            for (unsigned int channel = 0; channel < nChannels_; ++channel)
+                gains_[i * nChannels_ + channel] = frameGain;
+        }
+        DspKernels::multiply(block, gains_.data(), nBlockSamples);
+        previousGain_ = gain;
+    }
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "systems/audio/dsp/Effect.h"
+
+#include <array>
+
+namespace Pdb
+{
+
+/* Feed-forward peak compressor with linked channels. The gain is computed once per sub-block of
+   detectionFrames frames and linearly interpolated within it, so the costly dB conversions are
+   amortized and the gain itself is applied with vectorized kernels. A limiter is a compressor
+   with a very high ratio and a fast attack. */
+class Compressor : public Effect
+{
+public:
+    Compressor(float thresholdDb, float ratio, float attackMilliseconds, float releaseMilliseconds, float makeupGainDb = 0.0f);
+
+    static Compressor limiter(float thresholdDb, float releaseMilliseconds);
+
+    void prepare(unsigned int sampleRate, unsigned int nChannels) override;
+    void process(float* samples, size_t nFrames) override;
+
+    float getGainReductionDb() const { return gainReductionDb_; }
+
+private:
+    static constexpr size_t detectionFrames = 16;
+    static const size_t maxChannels = 8;
+
+    float computeGain(float peak);
+
+    float thresholdDb_;
+    float ratio_;
+    float attackMilliseconds_;
+    float releaseMilliseconds_;
+    float makeupGainDb_;
+
+    unsigned int nChannels_;
+    float attackCoefficient_;
+    float releaseCoefficient_;
+    float gainReductionDb_;     /* Smoothed, positive when compressing */
+    float previousGain_;
+    std::array<float, detectionFrames * maxChannels> gains_;
+};
+
+}
@@ -0,0 +1,167 @@
+#include "DspKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PDB_DSP_NEON
+#endif
+
+namespace Pdb
+{
+
+namespace
+{
+    const float int16ToFloatScale = 1.0f / 32768.0f;
+    const float floatToInt16Scale = 32768.0f;
+}
+
+void DspKernels::int16ToFloat(const int16_t* input, float* output, size_t nSamples)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(int16ToFloatScale);
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        /* Sign-extending the 16-bit halves to 32 bits */
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+#elif defined(PDB_DSP_NEON)
+    const float32x4_t scale = vdupq_n_f32(int16ToFloatScale);
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        int16x8_t samples = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), scale));
+        vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), scale));
+    }
+#endif
+    for (; i < nSamples; ++i)
+        output[i] = input[i] * int16ToFloatScale;
+}
+
+void DspKernels::floatToInt16(const float* input, int16_t* output, size_t nSamples)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(floatToInt16Scale);
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        /* Conversion rounds, packing saturates */
+        __m128i low = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(input + i), scale));
+        __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(low, high));
+    }
+#elif defined(PDB_DSP_NEON)
+    const float32x4_t scale = vdupq_n_f32(floatToInt16Scale);
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        int32x4_t low = vcvtq_s32_f32(vmulq_f32(vld1q_f32(input + i), scale));
+        int32x4_t high = vcvtq_s32_f32(vmulq_f32(vld1q_f32(input + i + 4), scale));
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+    }
+#endif
+    for (; i < nSamples; ++i)
+    {
+        float sample = std::round(input[i] * floatToInt16Scale);
+        output[i] = static_cast<int16_t>(std::min(32767.0f, std::max(-32768.0f, sample)));
+    }
+}
+
+void DspKernels::multiply(float* samples, const float* gains, size_t nSamples)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= nSamples; i += 4)
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), _mm_loadu_ps(gains + i)));
+#elif defined(PDB_DSP_NEON)
+    for (; i + 4 <= nSamples; i += 4)
+        vst1q_f32(samples + i, vmulq_f32(vld1q_f32(samples + i), vld1q_f32(gains + i)));
+#endif
+    for (; i < nSamples; ++i)
+        samples[i] *= gains[i];
+}
+
+float DspKernels::peak(const float* samples, size_t nSamples)
+{
+    size_t i = 0;
+    float result = 0.0f;
+#if defined(__SSE2__)
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 maximum = _mm_setzero_ps();
+    for (; i + 4 <= nSamples; i += 4)
+        maximum = _mm_max_ps(maximum, _mm_and_ps(_mm_loadu_ps(samples + i), signMask));
+    float lanes[4];
+    _mm_storeu_ps(lanes, maximum);
+    result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#elif defined(PDB_DSP_NEON)
+    float32x4_t maximum = vdupq_n_f32(0.0f);
+    for (; i + 4 <= nSamples; i += 4)
+        maximum = vmaxq_f32(maximum, vabsq_f32(vld1q_f32(samples + i)));
+    float lanes[4];
+    vst1q_f32(lanes, maximum);
+    result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+    for (; i < nSamples; ++i)
+        result = std::max(result, std::fabs(samples[i]));
+    return result;
+}
+
+double DspKernels::sumOfSquares(const float* samples, size_t nSamples)
+{
+    size_t i = 0;
+    double result = 0.0;
+    /* Partial sums are kept in float lanes for short runs only, then added to the double result */
+    const size_t runSamples = 4096;
+#if defined(__SSE2__)
+    while (i + 4 <= nSamples)
+    {
+        __m128 sum = _mm_setzero_ps();
+        const size_t runEnd = std::min(nSamples - nSamples % 4, i + runSamples);
+        for (; i < runEnd; i += 4)
+        {
+            __m128 block = _mm_loadu_ps(samples + i);
+            sum = _mm_add_ps(sum, _mm_mul_ps(block, block));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, sum);
+        result += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+#elif defined(PDB_DSP_NEON)
+    while (i + 4 <= nSamples)
+    {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        const size_t runEnd = std::min(nSamples - nSamples % 4, i + runSamples);
+        for (; i < runEnd; i += 4)
+        {
+            float32x4_t block = vld1q_f32(samples + i);
+            sum = vmlaq_f32(sum, block, block);
+        }
+        float lanes[4];
+        vst1q_f32(lanes, sum);
+        result += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+    for (; i < nSamples; ++i)
+        result += (double)samples[i] * samples[i];
+    return result;
+}
+
+const char* DspKernels::getInstructionSetName()
+{
+#if defined(__SSE2__)
+    return "SSE2";
+#elif defined(PDB_DSP_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+}
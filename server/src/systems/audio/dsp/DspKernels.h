@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Pdb
+{
+
+/* Block operations used by effects on the audio thread. Vectorized with SSE2 (x86-64) or NEON (ARM)
+   when the compiler targets them, plain loops otherwise. */
+class DspKernels
+{
+public:
+    static void int16ToFloat(const int16_t* input, float* output, size_t nSamples);
+    /* Saturates to the int16 range */
+    static void floatToInt16(const float* input, int16_t* output, size_t nSamples);
+    static void multiply(float* samples, const float* gains, size_t nSamples);
+    static float peak(const float* samples, size_t nSamples);
+    static double sumOfSquares(const float* samples, size_t nSamples);
+
+    static const char* getInstructionSetName();
+};
+
+}
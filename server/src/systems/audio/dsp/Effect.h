@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+namespace Pdb
+{
+
+/* Audio effect processing interleaved float samples (range -1.0 to 1.0) in place, block by block.
+   prepare() is called before the stream starts, process() from the audio callback - it must not
+   allocate, lock nor log. */
+class Effect
+{
+public:
+    virtual ~Effect() { };
+
+    virtual void prepare(unsigned int sampleRate, unsigned int nChannels) = 0;
+    virtual void process(float* samples, size_t nFrames) = 0;
+};
+
+}
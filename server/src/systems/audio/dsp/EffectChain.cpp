@@ -0,0 +1,122 @@
+#include "EffectChain.h"
+#include "Biquad.h"
+#include "Compressor.h"
+#include "DspKernels.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace Pdb
+{
+
+std::unique_ptr<EffectChain> EffectChain::create(const EffectChainConfig& voiceConfig, const EffectChainConfig& masterConfig,
+    unsigned int sampleRate, unsigned int nChannels)
+{
+    if (voiceConfig.effects.empty() && masterConfig.effects.empty()) return nullptr;
+    if (nChannels == 0 || nChannels > 8 || sampleRate == 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Effect chain not supported for " << nChannels << " channels at " << sampleRate << " Hz, bypassing.";
+        return nullptr;
+    }
+
+    auto effectChain = std::make_unique<EffectChain>(sampleRate, nChannels);
+    addEffects(*effectChain, voiceConfig);
+    addEffects(*effectChain, masterConfig);
+    if (effectChain->isEmpty()) return nullptr;
+    return effectChain;
+}
+
+EffectChain::EffectChain(unsigned int sampleRate, unsigned int nChannels)
+    : sampleRate_(sampleRate), nChannels_(nChannels), budgetFraction_(Config::getInstance().dspBudgetPercent / 100.0f),
+    nBlocks_(0), nBlocksOverBudget_(0), maxLoad_(0.0f), totalLoad_(0.0f), nBlocksSinceWarning_(0)
+{
+}
+
+void EffectChain::addEffects(EffectChain& effectChain, const EffectChainConfig& config)
+{
+    for (const std::string& effectName : config.effects)
+    {
+        if (effectName == "highpass")
+            effectChain.add(std::make_unique<Biquad>(Biquad::Type::HIGHPASS, config.highPassFrequency, 0.707f));
+        else if (effectName == "eq")
+            effectChain.add(std::make_unique<Biquad>(Biquad::Type::PEAKING, config.eqFrequency, config.eqQ, config.eqGainDb));
+        else if (effectName == "compressor")
+            effectChain.add(std::make_unique<Compressor>(config.compressorThresholdDb, config.compressorRatio,
+                config.compressorAttackMilliseconds, config.compressorReleaseMilliseconds, config.compressorMakeupGainDb));
+        else if (effectName == "limiter")
+            effectChain.add(std::make_unique<Compressor>(Compressor::limiter(config.limiterThresholdDb, config.limiterReleaseMilliseconds)));
+        else
+            BOOST_LOG_TRIVIAL(error) << "Unknown effect: " << effectName << " (expected highpass, eq, compressor or limiter), skipping.";
+    }
+}
+
+void EffectChain::add(std::unique_ptr<Effect> effect)
+{
+    effect->prepare(sampleRate_, nChannels_);
+    effects_.push_back(std::move(effect));
+}
+
+void EffectChain::process(int16_t* samples, size_t nSamples)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    const size_t maxBlockSamples = blockSamples - blockSamples % nChannels_;
+    for (size_t offset = 0; offset < nSamples; offset += maxBlockSamples)
+    {
+        const size_t nBlockSamples = std::min(maxBlockSamples, nSamples - offset);
+        DspKernels::int16ToFloat(samples + offset, block_.data(), nBlockSamples);
+        processBlock(block_.data(), nBlockSamples);
+        DspKernels::floatToInt16(block_.data(), samples + offset, nBlockSamples);
+    }
+    measure(startTime, nSamples);
+}
+
+void EffectChain::process(float* samples, size_t nSamples)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    processBlock(samples, nSamples);
+    measure(startTime, nSamples);
+}
+
+void EffectChain::processBlock(float* samples, size_t nSamples)
+{
+    const size_t nFrames = nSamples / nChannels_;
+    for (auto& effect : effects_) effect->process(samples, nFrames);
+}
+
+void EffectChain::measure(std::chrono::steady_clock::time_point startTime, size_t nSamples)
+{
+    if (nSamples == 0) return;
+    const float processingSeconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+    const float blockSeconds = (float)nSamples / nChannels_ / sampleRate_;
+    const float load = processingSeconds / blockSeconds;
+
+    nBlocks_.store(nBlocks_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalLoad_.store(totalLoad_.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+    if (load > maxLoad_.load(std::memory_order_relaxed)) maxLoad_.store(load, std::memory_order_relaxed);
+
+    ++nBlocksSinceWarning_;
+    if (load > budgetFraction_)
+    {
+        const unsigned long nBlocksOverBudget = nBlocksOverBudget_.load(std::memory_order_relaxed) + 1;
+        nBlocksOverBudget_.store(nBlocksOverBudget, std::memory_order_relaxed);
+        /* At most one warning per second of audio */
+        if (nBlocksOverBudget == 1 || nBlocksSinceWarning_ * blockSeconds >= 1.0f)
+        {
+            nBlocksSinceWarning_ = 0;
+            BOOST_LOG_TRIVIAL(warning) << "Effect chain over CPU budget: " << load * 100.0f << "% of block duration (budget "
+                << budgetFraction_ * 100.0f << "%).";
+        }
+    }
+}
+
+void EffectChain::printStats(const std::string& streamName) const
+{
+    const unsigned long nBlocks = nBlocks_;
+    if (nBlocks == 0) return;
+    BOOST_LOG_TRIVIAL(info) << "Effect chain (" << effects_.size() << " effects, " << DspKernels::getInstructionSetName() << ") of "
+        << streamName << ": load avg " << totalLoad_ / nBlocks * 100.0f << "%, max " << maxLoad_ * 100.0f
+        << "%, blocks over budget " << nBlocksOverBudget_ << "/" << nBlocks;
+}
+
+}
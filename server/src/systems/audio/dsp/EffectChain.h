@@ -0,0 +1,59 @@
+#pragma once
+#include "systems/audio/dsp/Effect.h"
+#include "Config.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Effects run one after another on blocks of a stream's samples. Every stream has its own chain made of
+   the per-voice effects for the played track type followed by the master effects - there is no shared
+   output bus, each stream has its own output, so the master chain is instantiated per stream too.
+   Processing time of each block is compared with its playback duration (CPU budget meter). */
+class EffectChain
+{
+public:
+    /* nullptr when no effect is configured - streams then skip processing entirely */
+    static std::unique_ptr<EffectChain> create(const EffectChainConfig& voiceConfig, const EffectChainConfig& masterConfig,
+        unsigned int sampleRate, unsigned int nChannels);
+
+    EffectChain(unsigned int sampleRate, unsigned int nChannels);
+
+    void add(std::unique_ptr<Effect> effect);
+    bool isEmpty() const { return effects_.empty(); }
+
+    /* Interleaved samples, processed in place */
+    void process(int16_t* samples, size_t nSamples);
+    void process(float* samples, size_t nSamples);
+
+    void printStats(const std::string& streamName) const;
+
+private:
+    static const size_t blockSamples = 512;
+
+    static void addEffects(EffectChain& effectChain, const EffectChainConfig& config);
+    void processBlock(float* samples, size_t nSamples);
+    void measure(std::chrono::steady_clock::time_point startTime, size_t nSamples);
+
+    std::vector<std::unique_ptr<Effect>> effects_;
+    unsigned int sampleRate_;
+    unsigned int nChannels_;
+    float budgetFraction_;
+    std::array<float, blockSamples> block_;
+
+    /* Written by the audio thread only */
+    std::atomic<unsigned long> nBlocks_;
+    std::atomic<unsigned long> nBlocksOverBudget_;
+    std::atomic<float> maxLoad_;
+    std::atomic<float> totalLoad_;
+    unsigned long nBlocksSinceWarning_;
+};
+
+}
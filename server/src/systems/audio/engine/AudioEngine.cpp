@@ -0,0 +1,176 @@
+#include "AudioEngine.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <unistd.h>
+
+namespace Pdb
+{
+
+namespace
+{
+    const auto loopPeriod = std::chrono::milliseconds(5);
+    /* Client heartbeat older than this - server is gone */
+    const auto clientTimeout = std::chrono::seconds(3);
+}
+
+AudioEngine::AudioEngine(std::unique_ptr<SharedAudioMemory> memory) : memory_(std::move(memory))
+{
+    for (uint32_t i = 0; i < SharedAudio::maxChannels; ++i)
+        deviceChannels_[i].channel = &memory_->getLayout().channels[i];
+}
+
+AudioEngine::~AudioEngine()
+{
+    for (uint32_t i = 0; i < SharedAudio::maxChannels; ++i) closeChannel(i);
+}
+
+void AudioEngine::run()
+{
+    SharedAudio::Layout& layout = memory_->getLayout();
+    layout.enginePid = getpid();
+    restoreChannels();
+
+    uint64_t lastClientHeartbeat = layout.clientHeartbeat;
+    auto lastClientHeartbeatTime = std::chrono::steady_clock::now();
+    while (true)
+    {
+        SharedAudio::CommandRing& ring = layout.commandRing;
+        const uint64_t writePosition = ring.writePosition.load(std::memory_order_acquire);
+        for (uint64_t position = ring.readPosition.load(std::memory_order_relaxed); position < writePosition; ++position)
+        {
+            executeCommand(ring.commands[position % SharedAudio::commandRingCapacity]);
+            ring.readPosition.store(position + 1, std::memory_order_release);
+        }
+
+        layout.engineHeartbeat.fetch_add(1, std::memory_order_relaxed);
+        const auto now = std::chrono::steady_clock::now();
+        const uint64_t clientHeartbeat = layout.clientHeartbeat;
+        if (clientHeartbeat != lastClientHeartbeat)
+        {
+            lastClientHeartbeat = clientHeartbeat;
+            lastClientHeartbeatTime = now;
+        }
+        else if (now - lastClientHeartbeatTime > clientTimeout)
+        {
+            BOOST_LOG_TRIVIAL(info) << "Audio engine: server is gone, exiting.";
+            return;
+        }
+        std::this_thread::sleep_for(loopPeriod);
+    }
+}
+
+void AudioEngine::restoreChannels()
+{
+    SharedAudio::CommandRing& ring = memory_->getLayout().commandRing;
+    ring.readPosition.store(ring.writePosition.load(std::memory_order_acquire), std::memory_order_release);
+
+    int nRestored = 0;
+    for (uint32_t i = 0; i < SharedAudio::maxChannels; ++i)
+    {
+        const SharedAudio::ChannelState state = deviceChannels_[i].channel->state.load(std::memory_order_acquire);
+        if (state == SharedAudio::ChannelState::FREE) continue;
+        /* Continues from what the previous engine had not played yet */
+        const uint64_t readFrame = deviceChannels_[i].channel->readFrame;
+        openChannel(i);
+        deviceChannels_[i].channel->readFrame = std::max(readFrame, deviceChannels_[i].channel->startFrame.load());
+        if (state == SharedAudio::ChannelState::RUNNING) startChannel(i);
+        ++nRestored;
+    }
+    if (nRestored > 0) BOOST_LOG_TRIVIAL(info) << "Audio engine: restored " << nRestored << " channels.";
+}
+
+void AudioEngine::executeCommand(const SharedAudio::Command& command)
+{
+    if (command.channel >= SharedAudio::maxChannels) return;
+    switch (command.type)
+    {
+        case SharedAudio::CommandType::OPEN: openChannel(command.channel); break;
+        case SharedAudio::CommandType::START: startChannel(command.channel); break;
+        case SharedAudio::CommandType::STOP: stopChannel(command.channel); break;
+        case SharedAudio::CommandType::CLOSE: closeChannel(command.channel); break;
+    }
+}
+
+void AudioEngine::openChannel(uint32_t channelIndex)
+{
+    DeviceChannel& deviceChannel = deviceChannels_[channelIndex];
+    SharedAudio::Channel& channel = *deviceChannel.channel;
+    closeChannel(channelIndex);
+
+    channel.readFrame.store(channel.startFrame.load(), std::memory_order_release);
+    channel.nCallbacks = 0;
+    channel.nUnderruns = 0;
+    channel.totalJitterMicroseconds = 0;
+    channel.maxJitterMicroseconds = 0;
+
+    if (!deviceChannel.output) deviceChannel.output = AudioOutput::create();
+    deviceChannel.bufferFrames = channel.bufferFrames;
+    deviceChannel.output->open(channel.nChannels, channel.sampleRate, RTAUDIO_SINT16, &deviceChannel.bufferFrames,
+        &AudioEngine::deviceCallback, &deviceChannel);
+}
+
+void AudioEngine::startChannel(uint32_t channelIndex)
+{
+    DeviceChannel& deviceChannel = deviceChannels_[channelIndex];
+    if (!deviceChannel.output || !deviceChannel.output->isOpen() || deviceChannel.output->isRunning()) return;
+    deviceChannel.lastCallbackTime = std::chrono::steady_clock::time_point();
+    deviceChannel.output->start();
+}
+
+void AudioEngine::stopChannel(uint32_t channelIndex)
+{
+    DeviceChannel& deviceChannel = deviceChannels_[channelIndex];
+    if (deviceChannel.output && deviceChannel.output->isRunning()) deviceChannel.output->abort();
+}
+
+void AudioEngine::closeChannel(uint32_t channelIndex)
+{
+    DeviceChannel& deviceChannel = deviceChannels_[channelIndex];
+    if (deviceChannel.output && deviceChannel.output->isOpen()) deviceChannel.output->close();
+}
+
+int AudioEngine::deviceCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime,
+    RtAudioStreamStatus status, void* userData)
+{
+    DeviceChannel& deviceChannel = *static_cast<DeviceChannel*>(userData);
+    SharedAudio::Channel& channel = *deviceChannel.channel;
+    const unsigned int nChannels = channel.nChannels;
+    const uint64_t capacityFrames = channel.capacityFrames;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (deviceChannel.lastCallbackTime != std::chrono::steady_clock::time_point())
+    {
+        const double intervalMicroseconds = std::chrono::duration<double, std::micro>(now - deviceChannel.lastCallbackTime).count();
+        const uint64_t jitterMicroseconds = std::abs(intervalMicroseconds - 1e6 * nBufferFrames / channel.sampleRate);
+        channel.totalJitterMicroseconds.fetch_add(jitterMicroseconds, std::memory_order_relaxed);
+        if (jitterMicroseconds > channel.maxJitterMicroseconds.load(std::memory_order_relaxed))
+            channel.maxJitterMicroseconds.store(jitterMicroseconds, std::memory_order_relaxed);
+    }
+    deviceChannel.lastCallbackTime = now;
+    channel.nCallbacks.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t readFrame = channel.readFrame.load(std::memory_order_relaxed);
+    const uint64_t writeFrame = channel.writeFrame.load(std::memory_order_acquire);
+    const uint64_t nFrames = std::min<uint64_t>(nBufferFrames, (writeFrame > readFrame) ? writeFrame - readFrame : 0);
+
+    int16_t* output = static_cast<int16_t*>(outputBuffer);
+    const uint64_t ringFrame = readFrame % capacityFrames;
+    const uint64_t nFirstFrames = std::min(nFrames, capacityFrames - ringFrame);
+    std::memcpy(output, channel.samples + ringFrame * nChannels, nFirstFrames * nChannels * sizeof(int16_t));
+    std::memcpy(output + nFirstFrames * nChannels, channel.samples, (nFrames - nFirstFrames) * nChannels * sizeof(int16_t));
+    std::memset(output + nFrames * nChannels, 0, (nBufferFrames - nFrames) * nChannels * sizeof(int16_t));
+    channel.readFrame.store(readFrame + nFrames, std::memory_order_release);
+
+    /* Not before the first samples of the track arrived, nor after its last ones */
+    if (nFrames < nBufferFrames && readFrame > channel.startFrame.load(std::memory_order_relaxed)
+        && !channel.isDraining.load(std::memory_order_relaxed))
+        channel.nUnderruns.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "systems/audio/AudioOutput.h"
+#include "systems/audio/engine/SharedAudioMemory.h"
+
+#include <chrono>
+#include <memory>
+
+namespace Pdb
+{
+
+/* The pdbAudioEngine process - plays the PCM rings of the shared memory to the device outputs, executing
+   the commands of the server. Device callbacks only copy from the rings, nothing in this process
+   allocates, logs or waits for the server while audio is running. */
+class AudioEngine
+{
+public:
+    AudioEngine(std::unique_ptr<SharedAudioMemory> memory);
+    ~AudioEngine();
+
+    /* Returns when the server is gone (its heartbeat stopped) */
+    void run();
+
+private:
+    struct DeviceChannel
+    {
+        SharedAudio::Channel* channel = nullptr;
+        std::unique_ptr<AudioOutput> output;
+        unsigned int bufferFrames = 0;
+        std::chrono::steady_clock::time_point lastCallbackTime;
+    };
+
+    /* Restores channel states after (re)connecting, commands issued before are skipped */
+    void restoreChannels();
+    void executeCommand(const SharedAudio::Command& command);
+    void openChannel(uint32_t channelIndex);
+    void startChannel(uint32_t channelIndex);
+    void stopChannel(uint32_t channelIndex);
+    void closeChannel(uint32_t channelIndex);
+
+    static int deviceCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames, double streamTime,
+        RtAudioStreamStatus status, void* userData);
+
+    std::unique_ptr<SharedAudioMemory> memory_;
+    DeviceChannel deviceChannels_[SharedAudio::maxChannels];
+};
+
+}
@@ -0,0 +1,155 @@
+#include "AudioEngineClient.h"
+#include "Config.h"
+#include "systems/executor/ThreadRole.h"
+
+#include <boost/log/trivial.hpp>
+#include <cstring>
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+namespace Pdb
+{
+
+namespace
+{
+    const char* sharedMemoryName = "/pdb_audio_engine";
+    const auto monitorPeriod = std::chrono::milliseconds(100);
+    /* Engine heartbeat older than this - engine hung, killed and restarted */
+    const auto engineTimeout = std::chrono::seconds(2);
+    const auto respawnDelay = std::chrono::seconds(1);
+}
+
+AudioEngineClient::AudioEngineClient() : enginePid_(-1), isConnected_(false), lastEngineHeartbeat_(0), nRestarts_(0)
+{
+    memory_ = SharedAudioMemory::create(sharedMemoryName);
+    if (!memory_) return;
+    /* Never joined, the client lives as long as the process */
+    monitorThread_ = std::thread(&AudioEngineClient::monitorThreadFunction, this);
+    monitorThread_.detach();
+}
+
+SharedAudio::Channel* AudioEngineClient::allocateChannel(uint32_t& channelIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!memory_) return nullptr;
+    for (uint32_t i = 0; i < SharedAudio::maxChannels; ++i)
+    {
+        if (channelsTaken_[i]) continue;
+        channelsTaken_[i] = true;
+        channelIndex = i;
+        return &memory_->getLayout().channels[i];
+    }
+    BOOST_LOG_TRIVIAL(error) << "All " << SharedAudio::maxChannels << " audio engine channels are taken.";
+    return nullptr;
+}
+
+void AudioEngineClient::releaseChannel(uint32_t channelIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    channelsTaken_[channelIndex] = false;
+}
+
+void AudioEngineClient::sendCommand(SharedAudio::CommandType type, uint32_t channelIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!memory_) return;
+    SharedAudio::CommandRing& ring = memory_->getLayout().commandRing;
+    const uint64_t writePosition = ring.writePosition.load(std::memory_order_relaxed);
+    if (writePosition - ring.readPosition.load(std::memory_order_acquire) >= SharedAudio::commandRingCapacity)
+    {
+        /* Engine not reading (down) - it restores channel states when it comes back */
+        BOOST_LOG_TRIVIAL(debug) << "Audio engine command ring full, command dropped.";
+        return;
+    }
+    ring.commands[writePosition % SharedAudio::commandRingCapacity] = SharedAudio::Command { type, channelIndex };
+    ring.writePosition.store(writePosition + 1, std::memory_order_release);
+}
+
+void AudioEngineClient::printStats() const
+{
+    if (!memory_) return;
+    BOOST_LOG_TRIVIAL(info) << "Audio engine: " << (isConnected_ ? "connected" : "disconnected") << ", restarts: " << nRestarts_;
+    for (uint32_t i = 0; i < SharedAudio::maxChannels; ++i)
+    {
+        const SharedAudio::Channel& channel = memory_->getLayout().channels[i];
+        const uint64_t nCallbacks = channel.nCallbacks;
+        if (nCallbacks == 0) continue;
+        BOOST_LOG_TRIVIAL(info) << "Audio engine channel " << i << ": " << nCallbacks << " callbacks, " << channel.nUnderruns
+            << " underruns, jitter avg " << channel.totalJitterMicroseconds / nCallbacks << " us, max " << channel.maxJitterMicroseconds << " us";
+    }
+}
+
+void AudioEngineClient::monitorThreadFunction()
+{
+    setUpCurrentThread(ThreadRole::APP, "engine-monitor");
+    SharedAudio::Layout& layout = memory_->getLayout();
+    lastEngineHeartbeatTime_ = std::chrono::steady_clock::now();
+    spawnEngine();
+
+    while (true)
+    {
+        std::this_thread::sleep_for(monitorPeriod);
+        layout.clientHeartbeat.fetch_add(1, std::memory_order_relaxed);
+        const auto now = std::chrono::steady_clock::now();
+
+        const uint64_t engineHeartbeat = layout.engineHeartbeat.load(std::memory_order_relaxed);
+        if (engineHeartbeat != lastEngineHeartbeat_)
+        {
+            lastEngineHeartbeat_ = engineHeartbeat;
+            lastEngineHeartbeatTime_ = now;
+            if (!isConnected_.exchange(true))
+                BOOST_LOG_TRIVIAL(info) << "Audio engine connected (pid " << layout.enginePid << ").";
+        }
+        else if (now - lastEngineHeartbeatTime_ > engineTimeout && isConnected_.exchange(false))
+        {
+            BOOST_LOG_TRIVIAL(error) << "Audio engine not responding, restarting it.";
+            if (enginePid_ > 0) kill(enginePid_, SIGKILL);
+        }
+
+        /* Reap and restart a dead engine */
+        if (enginePid_ > 0)
+        {
+            int status;
+            if (waitpid(enginePid_, &status, WNOHANG) == enginePid_)
+            {
+                BOOST_LOG_TRIVIAL(error) << "Audio engine exited (" << (WIFSIGNALED(status) ? "signal " : "status ")
+                    << (WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status)) << ").";
+                enginePid_ = -1;
+                isConnected_ = false;
+            }
+        }
+        if (Config::getInstance().remoteEngineSpawn && enginePid_ <= 0 && now - lastSpawnTime_ > respawnDelay)
+        {
+            ++nRestarts_;
+            spawnEngine();
+        }
+    }
+}
+
+void AudioEngineClient::spawnEngine()
+{
+    const Config& config = Config::getInstance();
+    lastSpawnTime_ = std::chrono::steady_clock::now();
+    lastEngineHeartbeatTime_ = lastSpawnTime_;
+    if (!config.remoteEngineSpawn) return;   /* Started and supervised externally */
+
+    std::string enginePath = config.remoteEnginePath;
+    std::string backendArgument = std::string("--backend=") + Config::getAudioBackendName(config.remoteEngineBackend);
+    std::string memoryArgument = std::string("--memory=") + sharedMemoryName;
+    char* arguments[] = { &enginePath[0], &backendArgument[0], &memoryArgument[0], nullptr };
+    pid_t pid;
+    const int result = posix_spawn(&pid, enginePath.c_str(), nullptr, nullptr, arguments, environ);
+    if (result != 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not start audio engine " << enginePath << ": " << std::strerror(result);
+        return;
+    }
+    enginePid_ = pid;
+    BOOST_LOG_TRIVIAL(info) << "Audio engine started: " << enginePath << " (pid " << pid << ").";
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "systems/audio/engine/SharedAudioMemory.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <sys/types.h>
+
+namespace Pdb
+{
+
+/* Server side of the out-of-process audio engine (AudioEngine.backend = remote). Owns the shared memory,
+   starts the pdbAudioEngine process and watches it - a crashed or hung engine is restarted and restores
+   the channels from their state in shared memory, streams keep their position. */
+class AudioEngineClient
+{
+public:
+    static AudioEngineClient& getInstance()
+    {
+        static AudioEngineClient* instance = new AudioEngineClient();
+        return *instance;
+    }
+
+    /* Returns nullptr when all channels are taken or the shared memory is not available */
+    SharedAudio::Channel* allocateChannel(uint32_t& channelIndex);
+    void releaseChannel(uint32_t channelIndex);
+    void sendCommand(SharedAudio::CommandType type, uint32_t channelIndex);
+
+    bool isConnected() const { return isConnected_; }
+    void printStats() const;
+
+private:
+    AudioEngineClient();
+
+    void monitorThreadFunction();
+    void spawnEngine();
+
+    std::unique_ptr<SharedAudioMemory> memory_;
+    bool channelsTaken_[SharedAudio::maxChannels] = {};
+    std::mutex mutex_;      /* Guards the command ring producer side and channel allocation */
+
+    pid_t enginePid_;
+    std::atomic<bool> isConnected_;
+    uint64_t lastEngineHeartbeat_;
+    std::chrono::steady_clock::time_point lastEngineHeartbeatTime_;
+    std::chrono::steady_clock::time_point lastSpawnTime_;
+    int nRestarts_;
+    std::thread monitorThread_;
+};
+
+}
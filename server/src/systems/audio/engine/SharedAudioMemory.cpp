@@ -0,0 +1,85 @@
+#include "SharedAudioMemory.h"
+
+#include <boost/log/trivial.hpp>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Pdb
+{
+
+SharedAudioMemory::SharedAudioMemory(SharedAudio::Layout* layout, const std::string& name, bool isOwner)
+    : layout_(layout), name_(name), isOwner_(isOwner)
+{
+}
+
+SharedAudioMemory::~SharedAudioMemory()
+{
+    munmap(layout_, sizeof(SharedAudio::Layout));
+    if (isOwner_) shm_unlink(name_.c_str());
+}
+
+std::unique_ptr<SharedAudioMemory> SharedAudioMemory::create(const std::string& name)
+{
+    /* A new object every time - an engine still attached to the old one sees the client heartbeat stop */
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not create shared memory " << name << ": " << std::strerror(errno);
+        return nullptr;
+    }
+    if (ftruncate(fd, sizeof(SharedAudio::Layout)) != 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not size shared memory " << name << ": " << std::strerror(errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* address = mmap(nullptr, sizeof(SharedAudio::Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not map shared memory " << name << ": " << std::strerror(errno);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    /* Zero filled by ftruncate, which is a valid initial state of all the atomics */
+    SharedAudio::Layout* layout = new (address) SharedAudio::Layout;
+    layout->version = SharedAudio::version;
+    std::atomic_thread_fence(std::memory_order_release);
+    layout->magic = SharedAudio::magic;
+    return std::unique_ptr<SharedAudioMemory>(new SharedAudioMemory(layout, name, true));
+}
+
+std::unique_ptr<SharedAudioMemory> SharedAudioMemory::attach(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) return nullptr;
+    /* Client may not have sized it yet, touching the mapping would then raise SIGBUS */
+    struct stat fileStatus;
+    if (fstat(fd, &fileStatus) != 0 || (size_t)fileStatus.st_size < sizeof(SharedAudio::Layout))
+    {
+        close(fd);
+        return nullptr;
+    }
+    void* address = mmap(nullptr, sizeof(SharedAudio::Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) return nullptr;
+
+    SharedAudio::Layout* layout = static_cast<SharedAudio::Layout*>(address);
+    if (layout->magic != SharedAudio::magic || layout->version != SharedAudio::version)
+    {
+        munmap(address, sizeof(SharedAudio::Layout));
+        return nullptr;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return std::unique_ptr<SharedAudioMemory>(new SharedAudioMemory(layout, name, false));
+}
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Pdb
+{
+
+/* Layout of the shared memory between the server (client) and the out-of-process audio engine.
+   Every ring has a single producer and a single consumer, indexes only ever grow - no locks cross the process
+   boundary, so neither side can block the other (or stay blocked when the other one dies). */
+namespace SharedAudio
+{
+    const uint32_t magic = 0x41424450;      /* "PDBA" */
+    const uint32_t version = 1;
+    const size_t maxChannels = 16;
+    const size_t maxChannelSamples = 48000 * 2;     /* One second of 48 kHz stereo */
+    const size_t commandRingCapacity = 64;
+
+    enum class CommandType : uint32_t { OPEN, START, STOP, CLOSE };
+    /* Desired state of a channel - kept by the client, so that a restarted engine can restore it */
+    enum class ChannelState : uint32_t { FREE, OPEN, RUNNING };
+
+    struct Command
+    {
+        CommandType type;
+        uint32_t channel;
+    };
+
+    /* Client -> engine */
+    struct CommandRing
+    {
+        std::atomic<uint64_t> writePosition;
+        std::atomic<uint64_t> readPosition;
+        Command commands[commandRingCapacity];
+    };
+
+    /* 16-bit interleaved PCM, client -> engine, plus engine statistics */
+    struct Channel
+    {
+        std::atomic<ChannelState> state;
+        std::atomic<bool> isDraining;     /* Stream ended - an empty ring is not an underrun */
+        uint32_t sampleRate;
+        uint32_t nChannels;
+        uint32_t bufferFrames;
+        uint32_t capacityFrames;
+        std::atomic<uint64_t> startFrame;     /* Of the current track, set before OPEN */
+        std::atomic<uint64_t> writeFrame;
+        std::atomic<uint64_t> readFrame;
+
+        std::atomic<uint64_t> nCallbacks;
+        std::atomic<uint64_t> nUnderruns;
+        std::atomic<uint64_t> totalJitterMicroseconds;    /* Deviation of device callback intervals from the buffer period */
+        std::atomic<uint64_t> maxJitterMicroseconds;
+
+        int16_t samples[maxChannelSamples];
+    };
+
+    struct Layout
+    {
+        uint32_t magic;
+        uint32_t version;
+        std::atomic<uint64_t> clientHeartbeat;
+        std::atomic<uint64_t> engineHeartbeat;
+        std::atomic<int32_t> enginePid;
+        CommandRing commandRing;
+        Channel channels[maxChannels];
+    };
+
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory rings need lock-free 64-bit atomics");
+}
+
+/* POSIX shared memory object mapped into the process */
+class SharedAudioMemory
+{
+public:
+    ~SharedAudioMemory();
+
+    /* Client side - (re)creates and initializes the object */
+    static std::unique_ptr<SharedAudioMemory> create(const std::string& name);
+    /* Engine side - nullptr when it does not exist (yet) or has other version */
+    static std::unique_ptr<SharedAudioMemory> attach(const std::string& name);
+
+    SharedAudio::Layout& getLayout() { return *layout_; }
+
+private:
+    SharedAudioMemory(SharedAudio::Layout* layout, const std::string& name, bool isOwner);
+
+    SharedAudio::Layout* layout_;
+    std::string name_;
+    bool isOwner_;
+};
+
+}
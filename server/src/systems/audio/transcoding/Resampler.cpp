@@ -0,0 +1,45 @@
+#include "Resampler.h"
+
+namespace Pdb
+{
+
+Resampler::Resampler(unsigned int inputSampleRate, unsigned int outputSampleRate)
+    : step_((double)inputSampleRate / outputSampleRate), position_(1.0), previousSample_(0.0f)
+{
+    if (outputSampleRate < inputSampleRate)
+    {
+        /* Two cascaded Butterworth sections */
+        for (float q : { 0.5412f, 1.3066f })
+        {
+            antiAliasingFilters_.push_back(std::make_unique<Biquad>(Biquad::Type::LOWPASS, 0.45f * outputSampleRate, q));
+            antiAliasingFilters_.back()->prepare(inputSampleRate, 1);
+        }
+    }
+}
+
+void Resampler::process(const float* input, size_t nSamples, std::vector<float>& output)
+{
+    if (!antiAliasingFilters_.empty())
+    {
+        filteredInput_.assign(input, input + nSamples);
+        for (auto& filter : antiAliasingFilters_) filter->process(filteredInput_.data(), nSamples);
+        input = filteredInput_.data();
+    }
+
+    /* Sample i of the input is at position i + 1, previousSample_ (last of the previous block) at 0 */
+    for (; position_ <= nSamples; position_ += step_)
+    {
+        const size_t index = (size_t)position_;
+        const double fraction = position_ - index;
+        const float left = (index == 0) ? previousSample_ : input[index - 1];
+        const float right = (index < nSamples) ? input[index] : left;
+        output.push_back(left + (float)(fraction * (right - left)));
+    }
+    if (nSamples > 0)
+    {
+        position_ -= nSamples;
+        previousSample_ = input[nSamples - 1];
+    }
+}
+
+}
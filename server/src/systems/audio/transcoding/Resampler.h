@@ -0,0 +1,28 @@
+#pragma once
+#include "systems/audio/dsp/Biquad.h"
+
+#include <memory>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Mono sample rate converter for offline use. Linear interpolation - speech content only - preceded, when
+   downsampling, by a fourth order lowpass below the new Nyquist frequency against aliasing. */
+class Resampler
+{
+public:
+    Resampler(unsigned int inputSampleRate, unsigned int outputSampleRate);
+
+    /* Appends resampled samples to output. Consecutive calls continue the same signal. */
+    void process(const float* input, size_t nSamples, std::vector<float>& output);
+
+private:
+    double step_;             /* Input samples per output sample */
+    double position_;         /* Of the next output sample, relative to previousSample_ */
+    float previousSample_;
+    std::vector<std::unique_ptr<Biquad>> antiAliasingFilters_;
+    std::vector<float> filteredInput_;
+};
+
+}
@@ -0,0 +1,257 @@
+#include "Transcoder.h"
+#include "Resampler.h"
+#include "WavFileWriter.h"
+#include "systems/audio/WavFileReader.h"
+#include "systems/audio/analysis/AudioDecoder.h"
+#include "systems/audio/dsp/DspKernels.h"
+#include "systems/executor/ThreadPoolExecutor.h"
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/filesystem.hpp>
+#include <cmath>
+
+namespace filesystem = boost::filesystem;
+
+namespace Pdb
+{
+
+namespace
+{
+    const char* originalsDirectoryPath = "../data/audiobooks_originals/";
+    const char* partFileExtension = ".part";
+    /* Transcoded duration may differ from the source by a fraction of the last resampled block */
+    const double maxDurationDifferenceSeconds = 0.1;
+}
+
+Transcoder::Transcoder() : sampleRate_(Config::getInstance().transcodingSampleRate), currentProgress_(0.0), nTranscoded_(0), nFailed_(0)
+{
+}
+
+void Transcoder::transcode(const std::vector<std::string>& filePaths, Executor& executor, TranscodedCallback transcodedCallback)
+{
+    if (!Config::getInstance().transcodingEnabled) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int nScheduled = 0;
+    for (const std::string& filePath : filePaths)
+    {
+        if (scheduledFiles_.count(filePath) || !needsTranscoding(filePath)) continue;
+
+        scheduledFiles_[filePath] = Callback { &executor, transcodedCallback };
+        ++nScheduled;
+        ThreadPoolExecutor::background().post([this, filePath] { transcodeFile(filePath); });
+    }
+    if (nScheduled > 0) BOOST_LOG_TRIVIAL(info) << "Transcoding scheduled for " << nScheduled << " audio tracks.";
+}
+
+void Transcoder::cancel(Executor& executor)
+{
+    /* Destroyed once unlocked */
+    std::vector<TranscodedCallback> transcodedCallbacks;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& scheduledFile : scheduledFiles_)
+    {
+        Callback& callback = scheduledFile.second;
+        if (callback.executor != &executor) continue;
+        callback.executor = nullptr;
+        transcodedCallbacks.push_back(std::move(callback.transcodedCallback));
+        callback.transcodedCallback = nullptr;
+    }
+}
+
+void Transcoder::printStatus() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    BOOST_LOG_TRIVIAL(info) << "Transcoder: " << nTranscoded_ << " transcoded, " << nFailed_ << " failed, "
+        << scheduledFiles_.size() << " pending.";
+    if (!currentFilePath_.empty())
+        BOOST_LOG_TRIVIAL(info) << "Transcoding " << currentFilePath_ << ": " << (int)(currentProgress_ * 100.0) << "%";
+}
+
+bool Transcoder::needsTranscoding(const std::string& filePath) const
+{
+    /* Parts of multi-part audiobooks are played as they are */
+    boost::system::error_code error;
+    if (filesystem::is_directory(filePath, error)) return false;
+    if (filesystem::path(filePath).extension() != ".wav") return true;
+
+    WavFileReader reader;
+    if (!reader.open(filePath)) return false;     /* Not playable anyway, nothing to convert from */
+    return reader.getSampleRate() != sampleRate_ || reader.getChannelCount() != 1 || reader.getBitsPerSample() != 16 || reader.isFloat();
+}
+
+void Transcoder::transcodeFile(const std::string& filePath)
+{
+    const std::string transcodedFilePath = filesystem::path(filePath).replace_extension(".wav").string();
+    const std::string partFilePath = transcodedFilePath + partFileExtension;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        currentFilePath_ = filePath;
+        currentProgress_ = 0.0;
+        currentStartTime_ = std::chrono::steady_clock::now();
+    }
+    BOOST_LOG_TRIVIAL(info) << "Transcoding " << filePath << " to " << sampleRate_ << " Hz mono.";
+
+    unsigned int sourceSampleRate = 0;
+    const size_t nSourceFrames = convert(filePath, partFilePath, sourceSampleRate);
+    const bool isTranscoded = nSourceFrames > 0 && verify(partFilePath, nSourceFrames, sourceSampleRate)
+        && swap(filePath, partFilePath, transcodedFilePath);
+
+    if (!isTranscoded)
+    {
+        boost::system::error_code error;
+        filesystem::remove(partFilePath, error);
+        BOOST_LOG_TRIVIAL(error) << "Transcoding of " << filePath << " failed, keeping the original.";
+    }
+    else
+    {
+        BOOST_LOG_TRIVIAL(info) << "Transcoded " << filePath << " in " << std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - currentStartTime_).count() << " s.";
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    isTranscoded ? ++nTranscoded_ : ++nFailed_;
+    /* Posted under the lock, so that cancel() returning means no callback is on its way anymore */
+    auto scheduledFile = scheduledFiles_.find(filePath);
+    if (isTranscoded && scheduledFile != scheduledFiles_.end() && scheduledFile->second.executor)
+    {
+        TranscodedCallback transcodedCallback = std::move(scheduledFile->second.transcodedCallback);
+        scheduledFile->second.executor->post([transcodedCallback, filePath, transcodedFilePath] { transcodedCallback(filePath, transcodedFilePath); });
+    }
+    scheduledFiles_.erase(filePath);
+    currentFilePath_.clear();
+}
+
+size_t Transcoder::convert(const std::string& sourceFilePath, const std::string& partFilePath, unsigned int& sourceSampleRate)
+{
+    AudioDecoder decoder;
+    if (!decoder.open(sourceFilePath)) return 0;
+    sourceSampleRate = decoder.getSampleRate();
+    const unsigned int nChannels = decoder.getChannelCount();
+
+    WavFileWriter writer;
+    if (!writer.open(partFilePath, sampleRate_, 1)) return 0;
+
+    Resampler resampler(sourceSampleRate, sampleRate_);
+    std::vector<float> samples(16384 - 16384 % nChannels);
+    std::vector<float> monoSamples;
+    std::vector<float> resampledSamples;
+    std::vector<int16_t> outputSamples;
+    size_t nSourceFrames = 0;
+    int reportedDecile = 0;
+
+    for (size_t nSamples; (nSamples = decoder.read(samples.data(), samples.size())) > 0; )
+    {
+        const size_t nFrames = nSamples / nChannels;
+        monoSamples.resize(nFrames);
+        for (size_t frame = 0; frame < nFrames; ++frame)
+        {
+            float sum = 0.0f;
+            for (unsigned int channel = 0; channel < nChannels; ++channel) sum += samples[frame * nChannels + channel];
+            monoSamples[frame] = sum / nChannels;
+        }
+        nSourceFrames += nFrames;
+
+        resampledSamples.clear();
+        resampler.process(monoSamples.data(), nFrames, resampledSamples);
+        outputSamples.resize(resampledSamples.size());
+        DspKernels::floatToInt16(resampledSamples.data(), outputSamples.data(), resampledSamples.size());
+        if (!writer.write(outputSamples.data(), outputSamples.size()))
+        {
+            BOOST_LOG_TRIVIAL(error) << "Could not write " << partFilePath << " (disk full?).";
+            writer.close();
+            return 0;
+        }
+
+        const double progress = decoder.getProgress();
+        if ((int)(progress * 10.0) > reportedDecile)
+        {
+            reportedDecile = (int)(progress * 10.0);
+            reportProgress(progress, (double)nSourceFrames / sourceSampleRate);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            currentProgress_ = progress;
+        }
+    }
+    if (!writer.close()) return 0;
+    return nSourceFrames;
+}
+
+bool Transcoder::verify(const std::string& partFilePath, size_t nSourceFrames, unsigned int sourceSampleRate) const
+{
+    WavFileReader reader;
+    if (!reader.open(partFilePath)) return false;
+    if (reader.getSampleRate() != sampleRate_ || reader.getChannelCount() != 1 || reader.getBitsPerSample() != 16)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transcoded file " << partFilePath << " has unexpected format.";
+        return false;
+    }
+
+    const double sourceDuration = (double)nSourceFrames / sourceSampleRate;
+    const double transcodedDuration = (double)reader.getFrameCount() / sampleRate_;
+    if (std::abs(sourceDuration - transcodedDuration) > maxDurationDifferenceSeconds)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transcoded file " << partFilePath << " lasts " << transcodedDuration << " s, source "
+            << sourceDuration << " s.";
+        return false;
+    }
+
+    /* Everything written must be readable back */
+    std::vector<float> samples(16384);
+    size_t nFrames = 0;
+    for (size_t nSamples; (nSamples = reader.read(samples.data(), samples.size())) > 0; ) nFrames += nSamples;
+    if (nFrames != reader.getFrameCount())
+    {
+        BOOST_LOG_TRIVIAL(error) << "Transcoded file " << partFilePath << " is truncated.";
+        return false;
+    }
+    return true;
+}
+
+bool Transcoder::swap(const std::string& sourceFilePath, const std::string& partFilePath, const std::string& transcodedFilePath) const
+{
+    boost::system::error_code error;
+    if (Config::getInstance().keepOriginals)
+    {
+        filesystem::create_directories(originalsDirectoryPath, error);
+        const filesystem::path originalFilePath = filesystem::path(originalsDirectoryPath) / filesystem::path(sourceFilePath).filename();
+        /* Linked rather than moved - the source stays in place until the transcoded file replaced it */
+        filesystem::remove(originalFilePath, error);
+        filesystem::create_hard_link(sourceFilePath, originalFilePath, error);
+        if (error) filesystem::copy_file(sourceFilePath, originalFilePath, filesystem::copy_option::overwrite_if_exists, error);
+        if (error)
+        {
+            BOOST_LOG_TRIVIAL(error) << "Could not keep original of " << sourceFilePath << ": " << error.message();
+            return false;
+        }
+    }
+
+    filesystem::rename(partFilePath, transcodedFilePath, error);
+    if (error)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not replace " << transcodedFilePath << ": " << error.message();
+        return false;
+    }
+    if (sourceFilePath != transcodedFilePath)
+    {
+        filesystem::remove(sourceFilePath, error);
+        if (error) BOOST_LOG_TRIVIAL(error) << "Could not remove " << sourceFilePath << ": " << error.message();
+    }
+    return true;
+}
+
+void Transcoder::reportProgress(double progress, double decodedSeconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    currentProgress_ = progress;
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - currentStartTime_).count();
+    const double speed = (elapsedSeconds > 0.0) ? decodedSeconds / elapsedSeconds : 0.0;
+    const double remainingSeconds = (progress > 0.0) ? elapsedSeconds * (1.0 - progress) / progress : 0.0;
+    BOOST_LOG_TRIVIAL(info) << "Transcoding " << filesystem::path(currentFilePath_).filename().string() << ": "
+        << (int)(progress * 100.0) << "%, " << speed << "x realtime, " << (int)remainingSeconds << " s left.";
+}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "systems/executor/Executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Converts audiobooks in the background to the format cheapest to play on the device - 16-bit mono PCM WAV at
+   the configured sample rate, streamed from disk without decoding. Each file is converted to "<name>.wav.part",
+   verified (format, length, duration against the source) and swapped in with an atomic rename, so a crash or a
+   failed conversion never leaves a broken audiobook. The track name does not change, neither does the timeline,
+   so saved resume positions stay valid. Originals are moved aside to ../data/audiobooks_originals/. */
+class Transcoder
+{
+public:
+    /* Called on the given executor with the path of the source file and of the transcoded file replacing it */
+    using TranscodedCallback = std::function<void(const std::string& sourceFilePath, const std::string& transcodedFilePath)>;
+
+    static Transcoder& getInstance()
+    {
+        static Transcoder* instance = new Transcoder();
+        return *instance;
+    }
+
+    /* Schedules conversion of files not in the target format yet, one job at a time on the shared background executor */
+    void transcode(const std::vector<std::string>& filePaths, Executor& executor, TranscodedCallback transcodedCallback);
+    /* Callbacks of files scheduled with executor are destroyed and never posted once this returns, the files are
+       still transcoded. For owners going away, e.g. an app whose shared object is unloaded. */
+    void cancel(Executor& executor);
+
+    void printStatus() const;
+
+private:
+    Transcoder();
+
+    /* Where the result of a scheduled file goes, no executor when cancelled */
+    struct Callback
+    {
+        Executor* executor;
+        TranscodedCallback transcodedCallback;
+    };
+
+    bool needsTranscoding(const std::string& filePath) const;
+    void transcodeFile(const std::string& filePath);
+    /* Returns the number of source frames decoded, 0 on failure */
+    size_t convert(const std::string& sourceFilePath, const std::string& partFilePath, unsigned int& sourceSampleRate);
+    bool verify(const std::string& partFilePath, size_t nSourceFrames, unsigned int sourceSampleRate) const;
+    bool swap(const std::string& sourceFilePath, const std::string& partFilePath, const std::string& transcodedFilePath) const;
+    void reportProgress(double progress, double decodedSeconds);
+
+    const unsigned int sampleRate_;
+
+    std::unordered_map<std::string, Callback> scheduledFiles_;
+    std::string currentFilePath_;
+    double currentProgress_;
+    std::chrono::steady_clock::time_point currentStartTime_;
+    int nTranscoded_;
+    int nFailed_;
+    mutable std::mutex mutex_;
+};
+
+}
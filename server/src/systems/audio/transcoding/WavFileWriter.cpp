@@ -0,0 +1,88 @@
+#include "WavFileWriter.h"
+
+#include <boost/log/trivial.hpp>
+#include <limits>
+
+namespace Pdb
+{
+
+namespace
+{
+    void writeUint32(std::ofstream& file, uint32_t value)
+    {
+        const char bytes[4] = { (char)(value & 0xFF), (char)((value >> 8) & 0xFF), (char)((value >> 16) & 0xFF), (char)(value >> 24) };
+        file.write(bytes, sizeof(bytes));
+    }
+
+    void writeUint16(std::ofstream& file, uint16_t value)
+    {
+        const char bytes[2] = { (char)(value & 0xFF), (char)(value >> 8) };
+        file.write(bytes, sizeof(bytes));
+    }
+}
+
+WavFileWriter::~WavFileWriter()
+{
+    if (file_.is_open()) close();
+}
+
+bool WavFileWriter::open(const std::string& filePath, unsigned int sampleRate, unsigned int nChannels)
+{
+    file_.open(filePath, std::ofstream::binary | std::ofstream::trunc);
+    if (!file_.is_open())
+    {
+        BOOST_LOG_TRIVIAL(error) << "File " << filePath << " could not be opened.";
+        return false;
+    }
+    sampleRate_ = sampleRate;
+    nChannels_ = nChannels;
+    dataSize_ = 0;
+    writeHeader(0);
+    return file_.good();
+}
+
+bool WavFileWriter::write(const int16_t* samples, size_t nSamples)
+{
+    /* Little endian host assumed (x86, ARM) */
+    file_.write(reinterpret_cast<const char*>(samples), nSamples * sizeof(int16_t));
+    dataSize_ += nSamples * sizeof(int16_t);
+    return file_.good();
+}
+
+bool WavFileWriter::close()
+{
+    if (!file_.is_open()) return false;
+    if (dataSize_ > std::numeric_limits<uint32_t>::max() - 36)
+    {
+        BOOST_LOG_TRIVIAL(error) << "WAV file too large: " << dataSize_ << " bytes.";
+        file_.setstate(std::ofstream::failbit);
+    }
+    else
+    {
+        file_.seekp(0);
+        writeHeader((uint32_t)dataSize_);
+    }
+    const bool isGood = file_.good();
+    file_.close();
+    return isGood && !file_.fail();
+}
+
+void WavFileWriter::writeHeader(uint32_t dataSize)
+{
+    const uint16_t bitsPerSample = 16;
+    const uint16_t blockAlign = nChannels_ * bitsPerSample / 8;
+    file_.write("RIFF", 4);
+    writeUint32(file_, 36 + dataSize);
+    file_.write("WAVEfmt ", 8);
+    writeUint32(file_, 16);
+    writeUint16(file_, 1);     /* PCM */
+    writeUint16(file_, nChannels_);
+    writeUint32(file_, sampleRate_);
+    writeUint32(file_, sampleRate_ * blockAlign);
+    writeUint16(file_, blockAlign);
+    writeUint16(file_, bitsPerSample);
+    file_.write("data", 4);
+    writeUint32(file_, dataSize);
+}
+
+}
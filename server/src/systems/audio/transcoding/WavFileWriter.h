@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace Pdb
+{
+
+/* Writes 16-bit PCM WAV files sample block by sample block, sizes in the header are filled in by close() */
+class WavFileWriter
+{
+public:
+    ~WavFileWriter();
+
+    bool open(const std::string& filePath, unsigned int sampleRate, unsigned int nChannels);
+    bool write(const int16_t* samples, size_t nSamples);
+    /* Returns false when any write failed */
+    bool close();
+
+private:
+    void writeHeader(uint32_t dataSize);
+
+    std::ofstream file_;
+    unsigned int sampleRate_ = 0;
+    unsigned int nChannels_ = 0;
+    uint64_t dataSize_ = 0;
+};
+
+}
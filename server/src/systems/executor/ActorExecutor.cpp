@@ -0,0 +1,130 @@
+#include "ActorExecutor.h"
+#include "systems/executor/ThreadRole.h"
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+
+namespace Pdb
+{
+
+ActorExecutor::ActorExecutor(const std::string& name) : name_(name), nPending_(0), stopping_(false), stopped_(false)
+{
+}
+
+ActorExecutor::~ActorExecutor()
+{
+    stop();
+}
+
+void ActorExecutor::start()
+{
+    if (thread_.joinable() || stopped_) return;
+    thread_ = std::thread(&ActorExecutor::threadFunction, this);
+}
+
+void ActorExecutor::stop()
+{
+    if (stopped_.exchange(true)) return;
+    if (thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeUpMutex_);
+            stopping_ = true;
+        }
+        wakeUpCondVar_.notify_one();
+        thread_.join();
+    }
+    else runPending();
+}
+
+void ActorExecutor::post(std::function<void()> job)
+{
+    send("posted", std::move(job));
+}
+
+void ActorExecutor::send(const char* commandName, std::function<void()> command)
+{
+    if (stopped_) return;
+    queue_.push(Command { commandName, std::move(command), std::chrono::steady_clock::now() });
+    /* Only the first command after the actor drained its queue has to wake it up */
+    if (nPending_.fetch_add(1) == 0)
+    {
+        std::lock_guard<std::mutex> lock(wakeUpMutex_);
+        wakeUpCondVar_.notify_one();
+    }
+}
+
+Executor& ActorExecutor::channel(const char* commandName)
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    channels_.emplace_back(*this, commandName);
+    return channels_.back();
+}
+
+void ActorExecutor::threadFunction()
+{
+    setUpCurrentThread(ThreadRole::APP, name_);
+    while (true)
+    {
+        runPending();
+        std::unique_lock<std::mutex> lock(wakeUpMutex_);
+        wakeUpCondVar_.wait(lock, [this] { return nPending_ > 0 || stopping_; });
+        if (stopping_)
+        {
+            lock.unlock();
+            runPending();
+            return;
+        }
+    }
+}
+
+size_t ActorExecutor::runPending()
+{
+    size_t nRun = 0;
+    while (nPending_ > 0)
+    {
+        Command command;
+        if (!queue_.pop(command))
+        {
+            /* Sent, but its producer has not linked it into the queue yet */
+            std::this_thread::yield();
+            continue;
+        }
+        run(command);
+        --nPending_;
+        ++nRun;
+    }
+    return nRun;
+}
+
+void ActorExecutor::run(Command& command)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    command.job();
+    const auto endTime = std::chrono::steady_clock::now();
+
+    const auto queueingDelay = std::chrono::duration_cast<std::chrono::microseconds>(startTime - command.sendTime);
+    const auto handlingTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    Stats& stats = stats_[command.name];
+    ++stats.nCommands;
+    stats.totalQueueingDelay += queueingDelay;
+    stats.maxQueueingDelay = std::max(stats.maxQueueingDelay, queueingDelay);
+    stats.totalHandlingTime += handlingTime;
+    stats.maxHandlingTime = std::max(stats.maxHandlingTime, handlingTime);
+}
+
+void ActorExecutor::printStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    for (const auto& commandStats : stats_)
+    {
+        const Stats& stats = commandStats.second;
+        BOOST_LOG_TRIVIAL(info) << "Actor " << name_ << ", " << commandStats.first << ": " << stats.nCommands << " commands, queueing delay avg "
+            << stats.totalQueueingDelay.count() / 1000.0 / stats.nCommands << " ms, max " << stats.maxQueueingDelay.count() / 1000.0
+            << " ms, handling avg " << stats.totalHandlingTime.count() / 1000.0 / stats.nCommands << " ms, max "
+            << stats.maxHandlingTime.count() / 1000.0 << " ms";
+    }
+}
+
+}
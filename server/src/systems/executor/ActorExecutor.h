@@ -0,0 +1,88 @@
+#pragma once
+#include "systems/executor/Executor.h"
+#include "systems/executor/MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Pdb
+{
+
+/* Mailbox of an actor: commands sent from any thread (input, timers, audio completions) go through a lock-free
+   MPSC queue and run one at a time on the actor's own thread, so the actor's state needs no locking. The sender
+   takes a lock only to wake the actor up when it is idle. Queueing delay and handling time are measured per
+   command name. */
+class ActorExecutor : public Executor
+{
+public:
+    explicit ActorExecutor(const std::string& name);
+    ~ActorExecutor();
+
+    /* Commands sent before start() wait for it */
+    void start();
+    /* Runs the commands sent so far and ends the actor thread (or runs them on the calling thread when not started).
+       Commands sent later are dropped. */
+    void stop();
+
+    void post(std::function<void()> job) override;
+    void send(const char* commandName, std::function<void()> command);
+    /* Executor sending its jobs as commandName, e.g. for timers and audio task continuations. Lives as long as the actor. */
+    Executor& channel(const char* commandName);
+
+    void printStats() const;
+
+private:
+    struct Command
+    {
+        const char* name;
+        std::function<void()> job;
+        std::chrono::steady_clock::time_point sendTime;
+    };
+
+    struct Stats
+    {
+        unsigned long nCommands = 0;
+        std::chrono::microseconds totalQueueingDelay { 0 };
+        std::chrono::microseconds maxQueueingDelay { 0 };
+        std::chrono::microseconds totalHandlingTime { 0 };
+        std::chrono::microseconds maxHandlingTime { 0 };
+    };
+
+    class Channel : public Executor
+    {
+    public:
+        Channel(ActorExecutor& actor, const char* commandName) : actor_(actor), commandName_(commandName) { }
+        void post(std::function<void()> job) override { actor_.send(commandName_, std::move(job)); }
+    private:
+        ActorExecutor& actor_;
+        const char* commandName_;
+    };
+
+    void threadFunction();
+    /* Returns number of commands run */
+    size_t runPending();
+    void run(Command& command);
+
+    std::string name_;
+    MpscQueue<Command> queue_;
+    std::atomic<size_t> nPending_;      /* Sent and not run yet */
+    std::atomic<bool> stopping_;
+    std::atomic<bool> stopped_;
+
+    std::mutex wakeUpMutex_;
+    std::condition_variable wakeUpCondVar_;
+    std::thread thread_;
+
+    std::list<Channel> channels_;
+    std::map<std::string, Stats> stats_;
+    mutable std::mutex statsMutex_;
+};
+
+}
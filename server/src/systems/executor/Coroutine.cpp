@@ -0,0 +1,26 @@
+#include "Coroutine.h"
+#include <boost/log/trivial.hpp>
+
+#include <exception>
+
+namespace Pdb
+{
+
+void Coroutine::promise_type::unhandled_exception()
+{
+    try
+    {
+        throw;
+    }
+    catch (const std::exception& exception)
+    {
+        BOOST_LOG_TRIVIAL(fatal) << "Coroutine failed: " << exception.what();
+    }
+    catch (...)
+    {
+        BOOST_LOG_TRIVIAL(fatal) << "Coroutine failed with an unknown exception.";
+    }
+    std::terminate();
+}
+
+}
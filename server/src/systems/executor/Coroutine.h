@@ -0,0 +1,79 @@
+#pragma once
+#include "systems/executor/Executor.h"
+
+#include <coroutine>
+#include <memory>
+
+namespace Pdb
+{
+
+/* Fire-and-forget coroutine, for app flows (announce something, wait for it, then act) written top to bottom
+   instead of as chains of continuations. Runs on the calling thread up to its first co_await and frees itself
+   when it returns. A suspended flow holds no thread - the awaitables (AudioScheduler::playAndWait,
+   TimerWheel::sleepFor, InputService::nextButton, resumeOn) resume it as a job posted to an executor,
+   normally the one of the app, so that its state is only ever touched there.
+   Whatever a flow waited for may have been preempted or cancelled meanwhile, after each co_await it must
+   re-check the state it acts upon. A flow whose resumption is dropped without running (timer cancelled, executor
+   stopped, request discarded) is destroyed then - its locals are, nothing after its co_await runs. */
+class Coroutine
+{
+public:
+    struct promise_type
+    {
+        Coroutine get_return_object() { return Coroutine(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() { }
+        /* Nobody to rethrow to, logged and terminates */
+        void unhandled_exception();
+    };
+};
+
+/* Job resuming a suspended flow, what awaitables post or schedule. Copies share the flow, which is destroyed
+   when the last of them goes away without any having run. */
+class Resumption
+{
+public:
+    explicit Resumption(std::coroutine_handle<> handle) : flow_(std::make_shared<Flow>(handle)) { }
+
+    void operator()() const { flow_->resume(); }
+
+private:
+    struct Flow
+    {
+        explicit Flow(std::coroutine_handle<> handle) : handle(handle) { }
+        ~Flow() { if (handle) handle.destroy(); }
+        Flow(const Flow&) = delete;
+        Flow& operator=(const Flow&) = delete;
+
+        /* Once - the flow owns itself again when resumed, and frees itself when it returns */
+        void resume()
+        {
+            std::coroutine_handle<> resumed = handle;
+            handle = nullptr;
+            if (resumed) resumed.resume();
+        }
+
+        std::coroutine_handle<> handle;
+    };
+
+    std::shared_ptr<Flow> flow_;
+};
+
+/* co_await resumeOn(executor) - the rest of the flow runs as a job of executor */
+class ResumeOn
+{
+public:
+    explicit ResumeOn(Executor& executor) : executor_(executor) { }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { executor_.post(Resumption(handle)); }
+    void await_resume() const noexcept { }
+
+private:
+    Executor& executor_;
+};
+
+inline ResumeOn resumeOn(Executor& executor) { return ResumeOn(executor); }
+
+}
@@ -0,0 +1,182 @@
+#include "EventLoop.h"
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace Pdb
+{
+
+namespace
+{
+
+timespec toTimespec(std::chrono::milliseconds duration)
+{
+    timespec result;
+    result.tv_sec = duration.count() / 1000;
+    result.tv_nsec = (duration.count() % 1000) * 1000000;
+    return result;
+}
+
+}
+
+EventLoop::EventLoop() : stopping_(false), nextSourceId_(wakeUpSourceId + 1)
+{
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeUpFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeUpFd_ < 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not create the event loop: " << std::strerror(errno);
+        exit(0);
+    }
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = wakeUpSourceId;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeUpFd_, &event);
+}
+
+EventLoop::~EventLoop()
+{
+    for (auto& source : sources_)
+    {
+        if (source.second.isTimer) close(source.second.fd);
+    }
+    close(wakeUpFd_);
+    close(epollFd_);
+}
+
+void EventLoop::post(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    const uint64_t one = 1;
+    if (write(wakeUpFd_, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        BOOST_LOG_TRIVIAL(error) << "Could not wake up the event loop: " << std::strerror(errno);
+}
+
+EventLoop::SourceId EventLoop::addFileDescriptor(int fd, uint32_t events, std::function<void(uint32_t events)> handler)
+{
+    return add(fd, events, Source { fd, false, false, std::make_shared<std::function<void(uint32_t)>>(std::move(handler)) });
+}
+
+EventLoop::SourceId EventLoop::addTimer(std::chrono::milliseconds delay, std::chrono::milliseconds interval, std::function<void()> handler)
+{
+    const int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not create a timer: " << std::strerror(errno);
+        return 0;
+    }
+    itimerspec timerSpec {};
+    /* Zero would disarm the timer */
+    timerSpec.it_value = toTimespec(std::max(delay, std::chrono::milliseconds(0)));
+    if (timerSpec.it_value.tv_sec == 0 && timerSpec.it_value.tv_nsec == 0) timerSpec.it_value.tv_nsec = 1;
+    timerSpec.it_interval = toTimespec(std::max(interval, std::chrono::milliseconds(0)));
+    timerfd_settime(timerFd, 0, &timerSpec, nullptr);
+
+    auto timerHandler = [handler = std::move(handler)](uint32_t) { handler(); };
+    const SourceId sourceId = add(timerFd, EPOLLIN, Source { timerFd, true, interval.count() > 0,
+        std::make_shared<std::function<void(uint32_t)>>(std::move(timerHandler)) });
+    if (sourceId == 0) close(timerFd);
+    return sourceId;
+}
+
+EventLoop::SourceId EventLoop::add(int fd, uint32_t events, Source source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const SourceId sourceId = nextSourceId_++;
+    epoll_event event {};
+    event.events = events;
+    event.data.u64 = sourceId;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not add descriptor " << fd << " to the event loop: " << std::strerror(errno);
+        return 0;
+    }
+    sources_.insert(std::make_pair(sourceId, std::move(source)));
+    return sourceId;
+}
+
+void EventLoop::remove(SourceId sourceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto source = sources_.find(sourceId);
+    if (source == sources_.end()) return;
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, source->second.fd, nullptr);
+    if (source->second.isTimer) close(source->second.fd);
+    sources_.erase(source);
+}
+
+void EventLoop::run()
+{
+    const int maxEvents = 16;
+    epoll_event events[maxEvents];
+    while (!stopping_)
+    {
+        const int nEvents = epoll_wait(epollFd_, events, maxEvents, -1);
+        if (nEvents < 0)
+        {
+            if (errno == EINTR) continue;
+            BOOST_LOG_TRIVIAL(error) << "Event loop wait failed: " << std::strerror(errno);
+            break;
+        }
+        for (int i = 0; i < nEvents && !stopping_; ++i)
+        {
+            if (events[i].data.u64 == wakeUpSourceId) runPosted();
+            else dispatch(events[i].data.u64, events[i].events);
+        }
+    }
+    stopping_ = false;
+}
+
+void EventLoop::stop()
+{
+    stopping_ = true;
+    post([] { });
+}
+
+void EventLoop::dispatch(SourceId sourceId, uint32_t events)
+{
+    std::shared_ptr<std::function<void(uint32_t)>> handler;
+    bool isTimer = false;
+    bool isPeriodic = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto source = sources_.find(sourceId);
+        /* Removed by a handler run earlier in this batch */
+        if (source == sources_.end()) return;
+        handler = source->second.handler;
+        isTimer = source->second.isTimer;
+        isPeriodic = source->second.isPeriodic;
+        if (isTimer)
+        {
+            uint64_t nExpirations = 0;
+            if (read(source->second.fd, &nExpirations, sizeof(nExpirations)) != sizeof(nExpirations)) return;
+        }
+    }
+    if (isTimer && !isPeriodic) remove(sourceId);
+    (*handler)(events);
+}
+
+void EventLoop::runPosted()
+{
+    uint64_t nWakeUps;
+    if (read(wakeUpFd_, &nWakeUps, sizeof(nWakeUps)) < 0 && errno != EAGAIN)
+        BOOST_LOG_TRIVIAL(error) << "Could not read event loop wake-ups: " << std::strerror(errno);
+
+    std::deque<std::function<void()>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs.swap(jobs_);
+    }
+    for (auto& job : jobs) job();
+}
+
+}
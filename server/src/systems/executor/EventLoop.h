@@ -0,0 +1,65 @@
+#pragma once
+#include "systems/executor/Executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Pdb
+{
+
+/* Reactor (epoll) running on the thread that called run(): handlers of registered file descriptors and timers
+   (timerfd) and posted jobs are executed there, one at a time. The thread sleeps in epoll_wait while nothing is
+   ready. Registration, removal, post() and stop() may be called from any thread. */
+class EventLoop : public Executor
+{
+public:
+    using SourceId = uint64_t;
+
+    EventLoop();
+    ~EventLoop();
+
+    void post(std::function<void()> job) override;
+
+    /* Handler gets the ready epoll events (EPOLLIN, EPOLLOUT, EPOLLHUP...), the descriptor stays owned by the caller */
+    SourceId addFileDescriptor(int fd, uint32_t events, std::function<void(uint32_t events)> handler);
+    /* Fires after delay, then every interval - once when interval is zero */
+    SourceId addTimer(std::chrono::milliseconds delay, std::chrono::milliseconds interval, std::function<void()> handler);
+    /* Handler is not called anymore once this returns, unless it is running right now on the loop thread */
+    void remove(SourceId sourceId);
+
+    /* Runs until stop() */
+    void run();
+    void stop();
+
+private:
+    struct Source
+    {
+        int fd;
+        bool isTimer;
+        bool isPeriodic;
+        std::shared_ptr<std::function<void(uint32_t events)>> handler;
+    };
+
+    SourceId add(int fd, uint32_t events, Source source);
+    void dispatch(SourceId sourceId, uint32_t events);
+    void runPosted();
+
+    static const SourceId wakeUpSourceId = 0;
+
+    int epollFd_;
+    int wakeUpFd_;      /* eventfd, signaled by post() and stop() */
+    std::atomic<bool> stopping_;
+
+    std::unordered_map<SourceId, Source> sources_;
+    SourceId nextSourceId_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+};
+
+}
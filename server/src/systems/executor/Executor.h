@@ -0,0 +1,16 @@
+#pragma once
+#include <functional>
+
+namespace Pdb
+{
+
+/* Something that runs posted jobs at some later point, on a thread of its own choosing */
+class Executor
+{
+public:
+    virtual ~Executor() { };
+
+    virtual void post(std::function<void()> job) = 0;
+};
+
+}
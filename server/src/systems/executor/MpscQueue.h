@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+namespace Pdb
+{
+
+/* Unbounded multi-producer single-consumer queue (Vyukov). push() is wait-free - one atomic exchange - and may be
+   called from any thread, pop() from one consumer thread only. Right after a push the value may briefly not be
+   visible to pop() yet, while the producer links it. */
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load()) { }
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value)) { }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value)
+    {
+        Node* node = new Node(std::move(value));
+        Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /* False when empty */
+    bool pop(T& value)
+    {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        value = std::move(next->value);
+        tail_ = next;       /* next becomes the stub node */
+        delete tail;
+        return true;
+    }
+
+private:
+    struct Node
+    {
+        Node() : next(nullptr) { }
+        explicit Node(T&& nodeValue) : next(nullptr), value(std::move(nodeValue)) { }
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    std::atomic<Node*> head_;   /* Last pushed, producers */
+    Node* tail_;                /* Stub before the oldest, consumer */
+};
+
+}
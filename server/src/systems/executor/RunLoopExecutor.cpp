@@ -0,0 +1,35 @@
+#include "RunLoopExecutor.h"
+
+namespace Pdb
+{
+
+void RunLoopExecutor::post(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobPostedCondVar_.notify_one();
+}
+
+size_t RunLoopExecutor::runPending()
+{
+    std::deque<std::function<void()>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs.swap(jobs_);
+    }
+    for (auto& job : jobs) job();
+    return jobs.size();
+}
+
+size_t RunLoopExecutor::waitAndRunPending(std::chrono::milliseconds timeout)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        jobPostedCondVar_.wait_for(lock, timeout, [this] { return !jobs_.empty(); });
+    }
+    return runPending();
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "systems/executor/Executor.h"
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+namespace Pdb
+{
+
+/* Executor drained by a thread's own loop (e.g. app loop) - posted jobs run on that thread only */
+class RunLoopExecutor : public Executor
+{
+public:
+    void post(std::function<void()> job) override;
+
+    /* Runs all jobs posted so far. Returns number of executed jobs. */
+    size_t runPending();
+    /* Same as runPending() but waits up to timeout for the first job if there is none */
+    size_t waitAndRunPending(std::chrono::milliseconds timeout);
+
+private:
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable jobPostedCondVar_;
+};
+
+}
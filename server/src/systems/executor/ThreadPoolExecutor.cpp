@@ -0,0 +1,57 @@
+#include "ThreadPoolExecutor.h"
+#include <boost/log/trivial.hpp>
+
+namespace Pdb
+{
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t nThreads, ThreadRole role, const std::string& name) : role_(role), stopping_(false)
+{
+    for (size_t i = 0; i < nThreads; ++i)
+        threads_.emplace_back(&ThreadPoolExecutor::workerFunction, this, name + "-" + std::to_string(i));
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobPostedCondVar_.notify_all();
+    for (auto& thread : threads_)
+        if (thread.joinable()) thread.join();
+}
+
+ThreadPoolExecutor& ThreadPoolExecutor::background()
+{
+    /* Never destroyed, jobs may still be running at exit */
+    static ThreadPoolExecutor* instance = new ThreadPoolExecutor(1, ThreadRole::BACKGROUND, "background");
+    return *instance;
+}
+
+void ThreadPoolExecutor::post(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobPostedCondVar_.notify_one();
+}
+
+void ThreadPoolExecutor::workerFunction(const std::string& threadName)
+{
+    setUpCurrentThread(role_, threadName);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        jobPostedCondVar_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) return;  /* stopping and nothing left to do */
+        std::function<void()> job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+}
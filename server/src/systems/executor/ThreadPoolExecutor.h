@@ -0,0 +1,43 @@
+#pragma once
+#include "systems/executor/Executor.h"
+#include "systems/executor/ThreadRole.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Pdb
+{
+
+/* Fixed number of worker threads created once and executing posted jobs in FIFO order */
+class ThreadPoolExecutor : public Executor
+{
+public:
+    /* Workers are named name-0, name-1... and set up for role (by default BACKGROUND workers get idle CPU and I/O
+       scheduling, so they never take time from audio or input) */
+    ThreadPoolExecutor(size_t nThreads, ThreadRole role, const std::string& name);
+    ~ThreadPoolExecutor();
+
+    /* Single background worker shared by long running jobs (e.g. audiobook analysis), run one at a time */
+    static ThreadPoolExecutor& background();
+
+    void post(std::function<void()> job) override;
+
+    size_t getThreadCount() const { return threads_.size(); }
+
+private:
+    void workerFunction(const std::string& threadName);
+
+    ThreadRole role_;
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> jobs_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable jobPostedCondVar_;
+};
+
+}
@@ -0,0 +1,147 @@
+#include "ThreadRole.h"
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/algorithm/string.hpp>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Pdb
+{
+
+namespace
+{
+    const char* roleName(ThreadRole role)
+    {
+        switch (role)
+        {
+            case ThreadRole::AUDIO: return "audio";
+            case ThreadRole::DECODE: return "decode";
+            case ThreadRole::APP: return "app";
+            case ThreadRole::BACKGROUND: return "background";
+        }
+        return "unknown";
+    }
+
+    const ThreadRoleConfig& roleConfig(ThreadRole role)
+    {
+        const Config& config = Config::getInstance();
+        switch (role)
+        {
+            case ThreadRole::AUDIO: return config.audioThreadRole;
+            case ThreadRole::DECODE: return config.decodeThreadRole;
+            case ThreadRole::APP: return config.appThreadRole;
+            case ThreadRole::BACKGROUND: break;
+        }
+        return config.backgroundThreadRole;
+    }
+
+    /* Exits on a malformed list, like on other config errors */
+    std::vector<int> parseCpus(ThreadRole role, const std::string& cpus)
+    {
+        std::vector<int> parsedCpus;
+        if (!parseCpuList(cpus, parsedCpus))
+        {
+            BOOST_LOG_TRIVIAL(error) << "Config: " << cpus << " is a wrong Threads." << roleName(role) << "Cpus value (expected e.g. 0-1,3).";
+            exit(0);
+        }
+        return parsedCpus;
+    }
+
+#ifdef __linux__
+    int parsePolicy(ThreadRole role, const std::string& scheduling)
+    {
+        if (scheduling == "other") return SCHED_OTHER;
+        if (scheduling == "batch") return SCHED_BATCH;
+        if (scheduling == "idle") return SCHED_IDLE;
+        if (scheduling == "fifo") return SCHED_FIFO;
+        if (scheduling == "rr") return SCHED_RR;
+        BOOST_LOG_TRIVIAL(error) << "Config: " << scheduling << " is a wrong Threads." << roleName(role)
+            << "Scheduling value (expected other, batch, idle, fifo or rr).";
+        exit(0);
+    }
+#endif
+}
+
+bool parseCpuList(const std::string& cpus, std::vector<int>& parsedCpus)
+{
+    parsedCpus.clear();
+    std::vector<std::string> ranges;
+    boost::algorithm::split(ranges, cpus, boost::algorithm::is_any_of(","));
+    for (std::string& range : ranges)
+    {
+        boost::algorithm::trim(range);
+        if (range.empty()) continue;
+        /* nConsumed catches whatever follows a valid range (e.g. 1-2-3) */
+        int first = 0, last = 0, nConsumed = 0;
+        char separator = 0;
+        if (sscanf(range.c_str(), "%d%n", &first, &nConsumed) == 1 && nConsumed == (int)range.size()) last = first;
+        else if (sscanf(range.c_str(), "%d%c%d%n", &first, &separator, &last, &nConsumed) != 3
+            || nConsumed != (int)range.size() || separator != '-' || last < first) return false;
+        if (first < 0) return false;
+        for (int cpu = first; cpu <= last; ++cpu) parsedCpus.push_back(cpu);
+    }
+    return true;
+}
+
+void setUpCurrentThread(ThreadRole role, const std::string& name)
+{
+#ifdef __linux__
+    if (!name.empty()) pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    const ThreadRoleConfig& config = roleConfig(role);
+
+    const std::vector<int> cpus = parseCpus(role, config.cpus);
+    if (!cpus.empty())
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (int cpu : cpus) if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpuSet);
+        const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        if (result != 0)
+            BOOST_LOG_TRIVIAL(warning) << "Could not pin " << roleName(role) << " thread " << name << " to CPUs " << config.cpus << ": " << std::strerror(result);
+    }
+
+    const int policy = parsePolicy(role, config.scheduling);
+    const bool isRealtime = (policy == SCHED_FIFO || policy == SCHED_RR);
+    sched_param parameters {};
+    if (isRealtime) parameters.sched_priority = config.priority;
+    const int result = pthread_setschedparam(pthread_self(), policy, &parameters);
+    if (result != 0)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Could not switch " << roleName(role) << " thread " << name << " to " << config.scheduling
+            << " scheduling: " << std::strerror(result);
+        /* Fallback to the lowest nice value, which on Linux is per thread */
+        if (policy == SCHED_IDLE) setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+    }
+    else if (!isRealtime && policy != SCHED_IDLE && config.priority != 0)
+    {
+        if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), config.priority) != 0)
+            BOOST_LOG_TRIVIAL(warning) << "Could not set nice value " << config.priority << " of " << roleName(role) << " thread " << name
+                << ": " << std::strerror(errno);
+    }
+    /* Idle I/O class (IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT), reading whole audiobooks must not stall playback reads */
+    if (policy == SCHED_IDLE) syscall(SYS_ioprio_set, 1, 0, 3 << 13);
+
+    BOOST_LOG_TRIVIAL(debug) << "Thread " << name << ": " << roleName(role) << " role, CPUs " << (config.cpus.empty() ? "all" : config.cpus)
+        << ", " << config.scheduling << " scheduling.";
+#endif
+}
+
+void setUpCurrentThreadOnce(ThreadRole role, const std::string& name)
+{
+    static thread_local bool isSetUp = false;
+    if (isSetUp) return;
+    isSetUp = true;
+    setUpCurrentThread(role, name);
+}
+
+}
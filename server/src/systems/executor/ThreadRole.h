@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace Pdb
+{
+
+/* What a thread of the server does, each role gets the CPU affinity and scheduling of its [Threads] config section
+   entries, so that audio can be isolated on a core of its own:
+    - AUDIO: device callbacks and the threads producing audio buffers in real time
+    - DECODE: audio task sequencers and prefetching of the parts of audiobooks
+    - APP: app loops and actors, the server event loop, the audio scheduler dispatcher
+    - BACKGROUND: long running jobs (analysis, transcoding), idle scheduling also gets the idle I/O class */
+enum class ThreadRole { AUDIO, DECODE, APP, BACKGROUND };
+
+/* Names the calling thread (shown by top -H, at most 15 characters, kept when empty) and applies the settings
+   of its role. Failures are logged, the thread keeps running as it was. */
+void setUpCurrentThread(ThreadRole role, const std::string& name);
+/* For threads the server does not create (e.g. device callbacks of audio libraries) - set up on their first call */
+void setUpCurrentThreadOnce(ThreadRole role, const std::string& name);
+/* Threads.*Cpus value like "0-1,3" (empty - all CPUs), false when it is malformed */
+bool parseCpuList(const std::string& cpus, std::vector<int>& parsedCpus);
+
+}
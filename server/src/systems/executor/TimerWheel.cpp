@@ -0,0 +1,193 @@
+#include "TimerWheel.h"
+#include "Coroutine.h"
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <vector>
+
+namespace Pdb
+{
+
+TimerWheel::TimerWheel(EventLoop& eventLoop, std::chrono::milliseconds resolution) : eventLoop_(eventLoop),
+    resolution_(std::max(resolution, std::chrono::milliseconds(1))), sourceId_(0), armed_(false), currentTick_(0), nextTimerId_(1)
+{
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd_ < 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not create the timer wheel: " << std::strerror(errno);
+        exit(0);
+    }
+    sourceId_ = eventLoop_.addFileDescriptor(timerFd_, EPOLLIN, [this](uint32_t) { onTimerFd(); });
+}
+
+TimerWheel::~TimerWheel()
+{
+    eventLoop_.remove(sourceId_);
+    close(timerFd_);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, std::chrono::milliseconds interval, Executor& executor,
+    std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto timer = std::make_shared<Timer>();
+    timer->id = nextTimerId_++;
+    timer->expiryTick = currentTick_ + std::max<uint64_t>(1, toTicks(delay));
+    timer->intervalTicks = (interval.count() > 0) ? std::max<uint64_t>(1, toTicks(interval)) : 0;
+    timer->executor = &executor;
+    timer->handler = std::move(handler);
+    timer->cancelled = false;
+    timers_[timer->id] = timer;
+    insert(timer);
+    if (!armed_) setArmed(true);
+    return timer->id;
+}
+
+void TimerWheel::cancel(TimerId timerId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto timer = timers_.find(timerId);
+    if (timer == timers_.end()) return;
+    /* Stays in its slot until reached, then it is dropped */
+    timer->second->cancelled = true;
+    timers_.erase(timer);
+}
+
+void TimerWheel::cancelAll(Executor& executor)
+{
+    /* Destroyed once unlocked, their captures may schedule or cancel timers */
+    std::vector<std::function<void()>> handlers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto timer = timers_.begin(); timer != timers_.end(); )
+        {
+            if (timer->second->executor != &executor)
+            {
+                ++timer;
+                continue;
+            }
+            timer->second->cancelled = true;
+            handlers.push_back(std::move(timer->second->handler));
+            timer->second->handler = nullptr;
+            timer = timers_.erase(timer);
+        }
+    }
+}
+
+void TimerWheel::Sleep::await_suspend(std::coroutine_handle<> handle)
+{
+    timerWheel_.schedule(delay_, std::chrono::milliseconds(0), executor_, Resumption(handle));
+}
+
+size_t TimerWheel::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.size();
+}
+
+uint64_t TimerWheel::toTicks(std::chrono::milliseconds duration) const
+{
+    return (std::max<int64_t>(0, duration.count()) + resolution_.count() - 1) / resolution_.count();
+}
+
+void TimerWheel::insert(std::shared_ptr<Timer> timer)
+{
+    /* Timers beyond the wheel's range are parked in the last level and re-inserted when reached */
+    const uint64_t maxDelta = (uint64_t(1) << (nLevels * slotBits)) - 1;
+    const uint64_t delta = (timer->expiryTick > currentTick_) ? timer->expiryTick - currentTick_ : 0;
+    const uint64_t placementTick = currentTick_ + std::min(delta, maxDelta);
+
+    int level = 0;
+    while (level < nLevels - 1 && delta >= (uint64_t(1) << ((level + 1) * slotBits))) ++level;
+    wheel_[level][(placementTick >> (level * slotBits)) & (nSlots - 1)].push_back(std::move(timer));
+}
+
+void TimerWheel::cascade(int level)
+{
+    Slot slot;
+    slot.swap(wheel_[level][(currentTick_ >> (level * slotBits)) & (nSlots - 1)]);
+    for (auto& timer : slot)
+    {
+        if (!timer->cancelled) insert(std::move(timer));
+    }
+}
+
+void TimerWheel::onTimerFd()
+{
+    uint64_t nExpirations = 0;
+    if (read(timerFd_, &nExpirations, sizeof(nExpirations)) != sizeof(nExpirations)) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    /* Ticks missed while the loop was busy are caught up */
+    for (uint64_t i = 0; i < nExpirations && armed_; ++i) tick();
+}
+
+void TimerWheel::tick()
+{
+    ++currentTick_;
+    /* Upper level slot whose time has come is spread over the levels below */
+    for (int level = 1; level < nLevels; ++level)
+    {
+        if ((currentTick_ & ((uint64_t(1) << (level * slotBits)) - 1)) != 0) break;
+        cascade(level);
+    }
+
+    Slot slot;
+    slot.swap(wheel_[0][currentTick_ & (nSlots - 1)]);
+    for (auto& timer : slot)
+    {
+        if (timer->cancelled) continue;
+        if (timer->expiryTick > currentTick_)
+        {
+            insert(std::move(timer));
+            continue;
+        }
+        fire(timer);
+        if (timer->intervalTicks)
+        {
+            timer->expiryTick += timer->intervalTicks;
+            insert(std::move(timer));
+        }
+    }
+
+    if (timers_.empty()) setArmed(false);
+}
+
+void TimerWheel::fire(const std::shared_ptr<Timer>& timer)
+{
+    std::shared_ptr<Timer> firedTimer = timer;
+    timer->executor->post([this, firedTimer]
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (firedTimer->cancelled) return;
+            /* One-shot timers can be cancelled until their handler starts */
+            if (!firedTimer->intervalTicks) timers_.erase(firedTimer->id);
+        }
+        firedTimer->handler();
+    });
+}
+
+void TimerWheel::setArmed(bool armed)
+{
+    itimerspec timerSpec {};
+    if (armed)
+    {
+        timerSpec.it_interval.tv_sec = resolution_.count() / 1000;
+        timerSpec.it_interval.tv_nsec = (resolution_.count() % 1000) * 1000000;
+        timerSpec.it_value = timerSpec.it_interval;
+    }
+    if (timerfd_settime(timerFd_, 0, &timerSpec, nullptr) != 0)
+    {
+        BOOST_LOG_TRIVIAL(error) << "Could not " << (armed ? "arm" : "disarm") << " the timer wheel: " << std::strerror(errno);
+        return;
+    }
+    armed_ = armed;
+}
+
+}
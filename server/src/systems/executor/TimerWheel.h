@@ -0,0 +1,98 @@
+#pragma once
+#include "systems/executor/EventLoop.h"
+#include "systems/executor/Executor.h"
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Pdb
+{
+
+/* Timers of all apps and subsystems on one timerfd of the server event loop, so that no feature needs a sleeping
+   thread of its own. Hierarchical wheel: 4 levels of 64 slots, a timer sits in the level matching how far away
+   it is and moves down as it gets closer, so scheduling, cancelling and ticking do not depend on the number of
+   timers. Ticks every resolution while any timer is pending, the event loop sleeps otherwise. Timers fire up to
+   one resolution early or late. Scheduling and cancelling may be done from any thread. */
+class TimerWheel
+{
+public:
+    using TimerId = uint64_t;
+
+    TimerWheel(EventLoop& eventLoop, std::chrono::milliseconds resolution);
+    ~TimerWheel();
+
+    /* Handler is posted to executor after delay, then every interval - once when interval is zero.
+       The wheel must outlive the executor's pending jobs. */
+    TimerId schedule(std::chrono::milliseconds delay, std::chrono::milliseconds interval, Executor& executor, std::function<void()> handler);
+    /* Handler does not start anymore once this returns, even if it was already posted. Unknown ids are ignored. */
+    void cancel(TimerId timerId);
+    /* Cancels every timer posting to executor and destroys their handlers before returning, for owners going away
+       (e.g. an app whose shared object is unloaded). The executor must not run timer handlers anymore (stopped). */
+    void cancelAll(Executor& executor);
+
+    /* Awaitable of sleepFor() */
+    class Sleep
+    {
+    public:
+        Sleep(TimerWheel& timerWheel, std::chrono::milliseconds delay, Executor& executor)
+            : timerWheel_(timerWheel), delay_(delay), executor_(executor) { }
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept { }
+
+    private:
+        TimerWheel& timerWheel_;
+        std::chrono::milliseconds delay_;
+        Executor& executor_;
+    };
+    /* co_await timerWheel.sleepFor(delay, executor) - the coroutine is resumed on executor after delay, as a one-shot timer */
+    Sleep sleepFor(std::chrono::milliseconds delay, Executor& executor) { return Sleep(*this, delay, executor); }
+
+    size_t getPendingCount() const;
+
+private:
+    struct Timer
+    {
+        TimerId id;
+        uint64_t expiryTick;
+        uint64_t intervalTicks;     /* 0 for one-shot */
+        Executor* executor;
+        std::function<void()> handler;
+        bool cancelled;     /* Guarded by mutex_ */
+    };
+    using Slot = std::list<std::shared_ptr<Timer>>;
+
+    static const int nLevels = 4;
+    static const int slotBits = 6;
+    static const uint64_t nSlots = 1 << slotBits;
+
+    uint64_t toTicks(std::chrono::milliseconds duration) const;
+    void insert(std::shared_ptr<Timer> timer);
+    void cascade(int level);
+    void onTimerFd();
+    void tick();
+    void fire(const std::shared_ptr<Timer>& timer);
+    void setArmed(bool armed);
+
+    EventLoop& eventLoop_;
+    std::chrono::milliseconds resolution_;
+    int timerFd_;
+    EventLoop::SourceId sourceId_;
+    bool armed_;
+
+    std::array<std::array<Slot, nSlots>, nLevels> wheel_;
+    uint64_t currentTick_;
+    std::unordered_map<TimerId, std::shared_ptr<Timer>> timers_;     /* Not cancelled, one-shots until their handler starts */
+    TimerId nextTimerId_;
+    mutable std::mutex mutex_;
+};
+
+}
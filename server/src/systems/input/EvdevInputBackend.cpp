@@ -0,0 +1,63 @@
+#include "EvdevInputBackend.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace Pdb
+{
+
+EvdevInputBackend::EvdevInputBackend(EventLoop& eventLoop, ButtonHandler buttonHandler) : buttonHandler_(std::move(buttonHandler)),
+    devices_(eventLoop, [this](const std::vector<input_event>& events) { onEvents(events); })
+{
+    if (devices_.getCount() == 0) BOOST_LOG_TRIVIAL(error) << "No readable keyboard found in /dev/input.";
+}
+
+void EvdevInputBackend::onEvents(const std::vector<input_event>& events)
+{
+    for (const input_event& event : events)
+    {
+        /* Value 0 is release, 1 press and 2 autorepeat */
+        if (event.type != EV_KEY || event.value != 0) continue;
+        InputManager::Button button;
+        if (toButton(event.code, button)) buttonHandler_(button, InputDevices::getEventTime(event));
+    }
+}
+
+bool EvdevInputBackend::toButton(unsigned short keyCode, InputManager::Button& button)
+{
+    switch (keyCode)
+    {
+        case KEY_Q: button = InputManager::Button::BUTTON_Q; return true;
+        case KEY_W: button = InputManager::Button::BUTTON_W; return true;
+        case KEY_E: button = InputManager::Button::BUTTON_E; return true;
+        case KEY_S: button = InputManager::Button::BUTTON_S; return true;
+        case KEY_A: button = InputManager::Button::BUTTON_A; return true;
+        case KEY_R: button = InputManager::Button::BUTTON_R; return true;
+        case KEY_X: button = InputManager::Button::BUTTON_X; return true;
+        case KEY_UP: button = InputManager::Button::BUTTON_UP; return true;
+        case KEY_DOWN: button = InputManager::Button::BUTTON_DOWN; return true;
+        case KEY_F: button = InputManager::Button::BUTTON_F; return true;
+        case KEY_T: button = InputManager::Button::BUTTON_T; return true;
+        case KEY_D: button = InputManager::Button::BUTTON_D; return true;
+        case KEY_KPEQUAL: button = InputManager::Button::KeyKpEqual; return true;
+        case KEY_KPSLASH: button = InputManager::Button::KeyKpDivide; return true;
+        case KEY_KPASTERISK: button = InputManager::Button::KeyKpMultiply; return true;
+        case KEY_KPMINUS: button = InputManager::Button::KeyKpSubtract; return true;
+        case KEY_KPPLUS: button = InputManager::Button::KeyKpAdd; return true;
+        case KEY_KPENTER: button = InputManager::Button::KeyKpEnter; return true;
+        /* The kernel reports keypad digits regardless of num lock, the keypad is used with num lock off */
+        case KEY_KPDOT: button = InputManager::Button::KeyKpDelete; return true;
+        case KEY_KP0: button = InputManager::Button::KeyKpInsert; return true;
+        case KEY_KP1: button = InputManager::Button::KeyKpEnd; return true;
+        case KEY_KP2: button = InputManager::Button::KeyKpDown; return true;
+        case KEY_KP3: button = InputManager::Button::KeyKpPageDown; return true;
+        case KEY_KP4: button = InputManager::Button::KeyKpLeft; return true;
+        case KEY_KP5: button = InputManager::Button::KeyKpBegin; return true;
+        case KEY_KP6: button = InputManager::Button::KeyKpRight; return true;
+        case KEY_KP7: button = InputManager::Button::KeyKpHome; return true;
+        case KEY_KP8: button = InputManager::Button::KeyKpUp; return true;
+        case KEY_KP9: button = InputManager::Button::KeyKpPageUp; return true;
+        default: return false;
+    }
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "systems/input/InputBackend.h"
+#include "systems/input/InputDevices.h"
+
+namespace Pdb
+{
+
+/* Reads key events straight from the kernel (evdev), no X server or input library needed */
+class EvdevInputBackend : public InputBackend
+{
+public:
+    EvdevInputBackend(EventLoop& eventLoop, ButtonHandler buttonHandler);
+
+    size_t getDeviceCount() const override { return devices_.getCount(); }
+
+    /* False for keys that are not mapped to any button */
+    static bool toButton(unsigned short keyCode, InputManager::Button& button);
+
+private:
+    void onEvents(const std::vector<input_event>& events);
+
+    ButtonHandler buttonHandler_;
+    InputDevices devices_;
+};
+
+}
@@ -0,0 +1,45 @@
+#include "GainputInputBackend.h"
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+
+namespace Pdb
+{
+
+GainputInputBackend::GainputInputBackend(EventLoop& eventLoop, ButtonHandler buttonHandler) : eventLoop_(eventLoop),
+    buttonHandler_(std::move(buttonHandler)), devices_(eventLoop, [this](const std::vector<input_event>& events) { onEvents(events); }),
+    pollTimerId_(0)
+{
+    if (devices_.getCount() == 0)
+    {
+        BOOST_LOG_TRIVIAL(info) << "No readable input device, polling input every " << Config::getInstance().inputPollMilliseconds << " ms.";
+        const std::chrono::milliseconds pollInterval(std::max(1, Config::getInstance().inputPollMilliseconds));
+        pollTimerId_ = eventLoop_.addTimer(pollInterval, pollInterval, [this] { update(std::chrono::steady_clock::now()); });
+    }
+}
+
+GainputInputBackend::~GainputInputBackend()
+{
+    if (pollTimerId_) eventLoop_.remove(pollTimerId_);
+}
+
+void GainputInputBackend::onEvents(const std::vector<input_event>& events)
+{
+    std::chrono::steady_clock::time_point eventTime = std::chrono::steady_clock::now();
+    for (const input_event& event : events)
+        if (event.type == EV_KEY) eventTime = InputDevices::getEventTime(event);
+    update(eventTime);
+}
+
+void GainputInputBackend::update(std::chrono::steady_clock::time_point eventTime)
+{
+    inputManager_.update();
+    for (int button = 0; button < InputManager::Button::BUTTON_COUNT; ++button)
+    {
+        if (inputManager_.isButtonPressed(static_cast<InputManager::Button>(button)))
+            buttonHandler_(static_cast<InputManager::Button>(button), eventTime);
+    }
+}
+
+}
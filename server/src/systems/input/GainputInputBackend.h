@@ -0,0 +1,29 @@
+#pragma once
+#include "systems/input/InputBackend.h"
+#include "systems/input/InputDevices.h"
+
+namespace Pdb
+{
+
+/* Button state from the gainput library (links X11). Updated when one of the keyboard devices becomes readable,
+   or every General.inputPollMilliseconds when none of them can be opened. */
+class GainputInputBackend : public InputBackend
+{
+public:
+    GainputInputBackend(EventLoop& eventLoop, ButtonHandler buttonHandler);
+    ~GainputInputBackend();
+
+    size_t getDeviceCount() const override { return devices_.getCount(); }
+
+private:
+    void onEvents(const std::vector<input_event>& events);
+    void update(std::chrono::steady_clock::time_point eventTime);
+
+    EventLoop& eventLoop_;
+    ButtonHandler buttonHandler_;
+    InputManager inputManager_;     /* Used on the event loop thread only */
+    InputDevices devices_;
+    EventLoop::SourceId pollTimerId_;
+};
+
+}
@@ -0,0 +1,25 @@
+#include "InputBackend.h"
+#include "EvdevInputBackend.h"
+#ifdef PDB_WITH_GAINPUT
+#include "GainputInputBackend.h"
+#endif
+#include "Config.h"
+
+#include <boost/log/trivial.hpp>
+
+namespace Pdb
+{
+
+std::unique_ptr<InputBackend> InputBackend::create(EventLoop& eventLoop, ButtonHandler buttonHandler)
+{
+    const InputBackendType backend = Config::getInstance().inputBackend;
+    if (backend == InputBackendType::EVDEV) return std::make_unique<EvdevInputBackend>(eventLoop, std::move(buttonHandler));
+#ifdef PDB_WITH_GAINPUT
+    if (backend == InputBackendType::GAINPUT) return std::make_unique<GainputInputBackend>(eventLoop, std::move(buttonHandler));
+#endif
+
+    BOOST_LOG_TRIVIAL(error) << "Config: General.inputBackend is gainput, but the server was built without it (GAINPUT).";
+    exit(0);
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "systems/input/InputManager.h"
+#include "systems/executor/EventLoop.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace Pdb
+{
+
+/* Source of button presses for the InputService. Watches its devices on the server event loop and reports
+   each pressed button (on key release, as the keypad always did) with the time of the key event. */
+class InputBackend
+{
+public:
+    using ButtonHandler = std::function<void(InputManager::Button button, std::chrono::steady_clock::time_point eventTime)>;
+
+    virtual ~InputBackend() { };
+
+    virtual size_t getDeviceCount() const = 0;
+
+    /* Creates backend of the type selected in config (General.inputBackend), buttonHandler runs on the event loop thread */
+    static std::unique_ptr<InputBackend> create(EventLoop& eventLoop, ButtonHandler buttonHandler);
+};
+
+}
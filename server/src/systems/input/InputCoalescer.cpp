@@ -0,0 +1,82 @@
+#include "InputCoalescer.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+
+namespace Pdb
+{
+
+InputCoalescer::InputCoalescer(TimerWheel& timerWheel, Executor& executor, std::chrono::milliseconds window,
+    std::vector<InputManager::Button> coalescedButtons, Handler handler)
+    : timerWheel_(timerWheel), executor_(executor), window_(window), coalescedButtons_(std::move(coalescedButtons)),
+    handler_(std::move(handler)), nBurstPresses_(0), windowTimerId_(0), nPresses_(0), nHandled_(0), longestBurst_(0)
+{
+}
+
+InputCoalescer::~InputCoalescer()
+{
+    if (windowTimerId_) timerWheel_.cancel(windowTimerId_);
+}
+
+void InputCoalescer::press(InputManager::Button button)
+{
+    ++nPresses_;
+    if (nBurstPresses_ > 0 && button == burstButton_)
+    {
+        ++nBurstPresses_;
+        restartWindow();
+        return;
+    }
+
+    flush();
+    if (window_.count() <= 0 || !isCoalesced(button))
+    {
+        handle(button, 1);
+        return;
+    }
+    burstButton_ = button;
+    nBurstPresses_ = 1;
+    restartWindow();
+}
+
+void InputCoalescer::flush()
+{
+    if (windowTimerId_) timerWheel_.cancel(windowTimerId_);
+    windowTimerId_ = 0;
+    if (nBurstPresses_ == 0) return;
+
+    const int nPresses = nBurstPresses_;
+    nBurstPresses_ = 0;
+    handle(burstButton_, nPresses);
+}
+
+void InputCoalescer::printStats() const
+{
+    BOOST_LOG_TRIVIAL(info) << "Input coalescing: " << nPresses_ << " button presses, " << nHandled_ << " commands handled ("
+        << nPresses_ - nHandled_ << " avoided), longest burst " << longestBurst_ << " presses";
+}
+
+bool InputCoalescer::isCoalesced(InputManager::Button button) const
+{
+    return std::find(coalescedButtons_.begin(), coalescedButtons_.end(), button) != coalescedButtons_.end();
+}
+
+void InputCoalescer::restartWindow()
+{
+    if (windowTimerId_) timerWheel_.cancel(windowTimerId_);
+    windowTimerId_ = timerWheel_.schedule(window_, std::chrono::milliseconds(0), executor_, [this]
+    {
+        windowTimerId_ = 0;
+        flush();
+    });
+}
+
+void InputCoalescer::handle(InputManager::Button button, int nPresses)
+{
+    ++nHandled_;
+    longestBurst_ = std::max(longestBurst_, nPresses);
+    if (nPresses > 1) BOOST_LOG_TRIVIAL(debug) << "Coalesced " << nPresses << " presses of button " << (int)button << ".";
+    handler_(button, nPresses);
+}
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "systems/input/InputManager.h"
+#include "systems/executor/Executor.h"
+#include "systems/executor/TimerWheel.h"
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Merges bursts of presses of the same repeatable button (next, fast-forward, volume) into one command with a press
+   count, so an app switches five audiobooks and announces the last one instead of starting and preempting five
+   prompts. A burst ends once its button was not pressed for the window, or right away when another button is
+   pressed - so the order of commands is kept and other buttons are not delayed.
+   Not thread-safe, to be used from executor only (on which the bursts ending with the window are handled). */
+class InputCoalescer
+{
+public:
+    using Handler = std::function<void(InputManager::Button button, int nPresses)>;
+
+    /* Zero window handles every press right away */
+    InputCoalescer(TimerWheel& timerWheel, Executor& executor, std::chrono::milliseconds window,
+        std::vector<InputManager::Button> coalescedButtons, Handler handler);
+    ~InputCoalescer();
+
+    void press(InputManager::Button button);
+    /* Handles the pending burst, if any, right away */
+    void flush();
+
+    unsigned long getPressCount() const { return nPresses_; }
+    unsigned long getHandledCount() const { return nHandled_; }
+    void printStats() const;
+
+private:
+    bool isCoalesced(InputManager::Button button) const;
+    void restartWindow();
+    void handle(InputManager::Button button, int nPresses);
+
+    TimerWheel& timerWheel_;
+    Executor& executor_;
+    std::chrono::milliseconds window_;
+    std::vector<InputManager::Button> coalescedButtons_;
+    Handler handler_;
+
+    InputManager::Button burstButton_;
+    int nBurstPresses_;                 /* 0 when no burst is pending */
+    TimerWheel::TimerId windowTimerId_; /* 0 when not running */
+
+    unsigned long nPresses_;
+    unsigned long nHandled_;
+    int longestBurst_;
+};
+
+}
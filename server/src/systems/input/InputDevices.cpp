@@ -0,0 +1,100 @@
+#include "InputDevices.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace Pdb
+{
+
+namespace
+{
+    bool hasKeys(int fd)
+    {
+        unsigned long eventTypes = 0;
+        return ioctl(fd, EVIOCGBIT(0, sizeof(eventTypes)), &eventTypes) >= 0 && (eventTypes & (1UL << EV_KEY));
+    }
+}
+
+InputDevices::InputDevices(EventLoop& eventLoop, EventsHandler eventsHandler) : eventLoop_(eventLoop),
+    eventsHandler_(std::move(eventsHandler)), nDevices_(0)
+{
+    open();
+}
+
+InputDevices::~InputDevices()
+{
+    for (auto& device : devices_)
+    {
+        eventLoop_.remove(device.second);
+        ::close(device.first);
+    }
+}
+
+std::chrono::steady_clock::time_point InputDevices::getEventTime(const input_event& event)
+{
+    return std::chrono::steady_clock::time_point(std::chrono::seconds(event.time.tv_sec) + std::chrono::microseconds(event.time.tv_usec));
+}
+
+void InputDevices::open()
+{
+    boost::system::error_code error;
+    for (boost::filesystem::directory_iterator it("/dev/input", error), end; !error && it != end; it.increment(error))
+    {
+        const std::string path = it->path().string();
+        if (it->path().filename().string().compare(0, 5, "event") != 0) continue;
+
+        const int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (!hasKeys(fd))
+        {
+            ::close(fd);
+            continue;
+        }
+        int clock = CLOCK_MONOTONIC;
+        ioctl(fd, EVIOCSCLOCKID, &clock);
+        const EventLoop::SourceId sourceId = eventLoop_.addFileDescriptor(fd, EPOLLIN, [this, fd](uint32_t events)
+        {
+            if (events & (EPOLLERR | EPOLLHUP)) close(fd);
+            else read(fd);
+        });
+        devices_.push_back(std::make_pair(fd, sourceId));
+        BOOST_LOG_TRIVIAL(info) << "Waiting for input on " << path << ".";
+    }
+    nDevices_ = devices_.size();
+}
+
+void InputDevices::read(int fd)
+{
+    events_.clear();
+    input_event events[64];
+    ssize_t nBytes;
+    while ((nBytes = ::read(fd, events, sizeof(events))) > 0)
+        events_.insert(events_.end(), events, events + nBytes / sizeof(input_event));
+    if (nBytes < 0 && errno == ENODEV)
+    {
+        close(fd);
+        return;
+    }
+    if (!events_.empty()) eventsHandler_(events_);
+}
+
+void InputDevices::close(int fd)
+{
+    auto device = std::find_if(devices_.begin(), devices_.end(), [fd](const std::pair<int, EventLoop::SourceId>& device) { return device.first == fd; });
+    if (device == devices_.end()) return;
+    BOOST_LOG_TRIVIAL(error) << "Input device lost (descriptor " << fd << ").";
+    eventLoop_.remove(device->second);
+    ::close(fd);
+    devices_.erase(device);
+    nDevices_ = devices_.size();
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "systems/executor/EventLoop.h"
+
+#include <linux/input.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Pdb
+{
+
+/* Keyboard-like devices (/dev/input/event* reporting EV_KEY) opened non-blocking and watched by the event loop.
+   Every open descriptor of a device gets all of its events, so these do not take them from other readers. */
+class InputDevices
+{
+public:
+    /* Called on the event loop thread with all the events drained from one device */
+    using EventsHandler = std::function<void(const std::vector<input_event>& events)>;
+
+    InputDevices(EventLoop& eventLoop, EventsHandler eventsHandler);
+    ~InputDevices();
+
+    size_t getCount() const { return nDevices_; }
+
+    /* Devices are switched to CLOCK_MONOTONIC, the clock of std::chrono::steady_clock */
+    static std::chrono::steady_clock::time_point getEventTime(const input_event& event);
+
+private:
+    void open();
+    void read(int fd);
+    /* Unplugged */
+    void close(int fd);
+
+    EventLoop& eventLoop_;
+    EventsHandler eventsHandler_;
+    std::vector<std::pair<int, EventLoop::SourceId>> devices_;     /* Descriptor and its event loop source */
+    std::atomic<size_t> nDevices_;
+    std::vector<input_event> events_;
+};
+
+}
@@ -6,6 +6,7 @@
 namespace Pdb
 {
 
+/* Keyboard through gainput (built with the GAINPUT option), Button is shared by all input backends */
 class InputManager
 {
 public:
@@ -15,6 +16,7 @@ public:
                     KeyKpEnd, KeyKpDown, KeyKpPageDown, 
                     KeyKpLeft, KeyKpBegin, KeyKpRight, 
                     KeyKpHome, KeyKpUp, KeyKpPageUp,
+                    BUTTON_COUNT    /* Not a button - number of buttons, for tables indexed by button */
                 };
 
     InputManager();
@@ -0,0 +1,82 @@
+#include "InputService.h"
+#include "systems/executor/Coroutine.h"
+
+#include <boost/log/trivial.hpp>
+#include <algorithm>
+
+namespace Pdb
+{
+
+InputService::InputService(EventLoop& eventLoop) : nextSubscriptionId_(0), nDispatchedEvents_(0), totalLatency_(0), maxLatency_(0)
+{
+    backend_ = InputBackend::create(eventLoop, [this](InputManager::Button button, std::chrono::steady_clock::time_point eventTime)
+    {
+        dispatch(button, eventTime);
+    });
+}
+
+void InputService::dispatch(InputManager::Button button, std::chrono::steady_clock::time_point eventTime)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Subscription& subscription : subscriptions_)
+    {
+        Handler handler = subscription.handler;
+        subscription.executor->post([this, handler, button, eventTime]
+        {
+            recordLatency(eventTime);
+            handler(button);
+        });
+    }
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+        [](const Subscription& subscription) { return subscription.once; }), subscriptions_.end());
+}
+
+InputService::SubscriptionId InputService::subscribe(Executor& executor, Handler handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.push_back(Subscription { nextSubscriptionId_, &executor, std::move(handler), false });
+    return nextSubscriptionId_++;
+}
+
+InputService::SubscriptionId InputService::subscribeOnce(Executor& executor, Handler handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.push_back(Subscription { nextSubscriptionId_, &executor, std::move(handler), true });
+    return nextSubscriptionId_++;
+}
+
+void InputService::NextButton::await_suspend(std::coroutine_handle<> handle)
+{
+    inputService_.subscribeOnce(executor_, [this, resumption = Resumption(handle)](InputManager::Button button)
+    {
+        button_ = button;
+        resumption();
+    });
+}
+
+void InputService::unsubscribe(SubscriptionId subscriptionId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+        [&](const Subscription& subscription) { return subscription.id == subscriptionId; }), subscriptions_.end());
+}
+
+void InputService::recordLatency(std::chrono::steady_clock::time_point eventTime)
+{
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - eventTime);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++nDispatchedEvents_;
+    totalLatency_ += latency;
+    maxLatency_ = std::max(maxLatency_, latency);
+}
+
+void InputService::printStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const double averageMilliseconds = nDispatchedEvents_ ? totalLatency_.count() / 1000.0 / nDispatchedEvents_ : 0.0;
+    BOOST_LOG_TRIVIAL(info) << "Input: " << backend_->getDeviceCount() << " devices, " << subscriptions_.size() << " subscribers, "
+        << nDispatchedEvents_ << " button presses handled, latency avg " << averageMilliseconds << " ms, max "
+        << maxLatency_.count() / 1000.0 << " ms";
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "systems/input/InputBackend.h"
+#include "systems/executor/EventLoop.h"
+#include "systems/executor/Executor.h"
+
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Pdb
+{
+
+/* The one owner of the keyboard, shared by all apps. Its backend (General.inputBackend) sleeps on the server
+   event loop until a keyboard device becomes readable, and every pressed button is posted to the executors
+   of the subscribed apps. Latency is measured from the kernel timestamp of the key event to the moment
+   the app starts handling it. */
+class InputService
+{
+public:
+    using SubscriptionId = unsigned int;
+    using Handler = std::function<void(InputManager::Button button)>;
+
+    InputService(EventLoop& eventLoop);
+
+    /* Handler runs on executor (e.g. the app loop) for each pressed button */
+    SubscriptionId subscribe(Executor& executor, Handler handler);
+    /* Handler runs on executor for the next pressed button only */
+    SubscriptionId subscribeOnce(Executor& executor, Handler handler);
+    void unsubscribe(SubscriptionId subscriptionId);
+
+    /* Awaitable of nextButton() */
+    class NextButton
+    {
+    public:
+        NextButton(InputService& inputService, Executor& executor) : inputService_(inputService), executor_(executor) { }
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        InputManager::Button await_resume() const noexcept { return button_; }
+
+    private:
+        InputService& inputService_;
+        Executor& executor_;
+        InputManager::Button button_;
+    };
+    /* InputManager::Button button = co_await inputService.nextButton(executor) - resumed on executor */
+    NextButton nextButton(Executor& executor) { return NextButton(*this, executor); }
+
+    void printStats() const;
+
+private:
+    struct Subscription
+    {
+        SubscriptionId id;
+        Executor* executor;
+        Handler handler;
+        bool once;
+    };
+
+    void dispatch(InputManager::Button button, std::chrono::steady_clock::time_point eventTime);
+    void recordLatency(std::chrono::steady_clock::time_point eventTime);
+
+    std::vector<Subscription> subscriptions_;
+    SubscriptionId nextSubscriptionId_;
+
+    unsigned long nDispatchedEvents_;
+    std::chrono::microseconds totalLatency_;
+    std::chrono::microseconds maxLatency_;
+
+    mutable std::mutex mutex_;
+
+    /* Last, its handlers use all of the above */
+    std::unique_ptr<InputBackend> backend_;
+};
+
+}
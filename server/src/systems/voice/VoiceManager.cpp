@@ -26,7 +26,7 @@ void VoiceManager::synthesizeVoiceMessage(const std::string& message, const std:
     boost::filesystem::path synthesizedVoiceMessageFilePath(outputDirectory + "/" + outputTrackName + ".mp3");
     if (boost::filesystem::exists(synthesizedVoiceMessageFilePath))
     {
-        synthesizedVoiceAudioTracks_.insert(std::make_pair(outputTrackName, AudioTrack(synthesizedVoiceMessageFilePath.c_str(), Config::getInstance().volumeForAwsSynthesized, AudioTrack::Type::VOICE_MESSAGE)));
+        synthesizedVoiceAudioTracks_.insert(std::make_pair(outputTrackName, AudioTrack(synthesizedVoiceMessageFilePath.c_str(), AudioTrack::Type::VOICE_MESSAGE)));
         return;
     }
 
@@ -52,7 +52,7 @@ void VoiceManager::synthesizeVoiceMessage(const std::string& message, const std:
         voiceFile.write(GetStreamBytes(audioStream), GetStreamSize(audioStream));
         voiceFile.close();
         lock.lock();
-        synthesizedVoiceAudioTracks_.insert(std::make_pair(outputTrackName, AudioTrack(synthesizedVoiceMessageFilePath.c_str(), Config::getInstance().volumeForAwsSynthesized, AudioTrack::Type::VOICE_MESSAGE)));
+        synthesizedVoiceAudioTracks_.insert(std::make_pair(outputTrackName, AudioTrack(synthesizedVoiceMessageFilePath.c_str(), AudioTrack::Type::VOICE_MESSAGE)));
         lock.unlock();
         BOOST_LOG_TRIVIAL(info) << "Saving to file done.";
     }
@@ -63,6 +63,19 @@ void VoiceManager::synthesizeVoiceMessage(const std::string& message, const std:
 
 }
 
+AudioTrack& VoiceManager::getVoiceMessage(const std::string& trackName)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return synthesizedVoiceAudioTracks_.at(trackName);
+}
+
+AudioTrack* VoiceManager::findVoiceMessage(const std::string& trackName)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto track = synthesizedVoiceAudioTracks_.find(trackName);
+    return track != synthesizedVoiceAudioTracks_.end() ? &track->second : nullptr;
+}
+
 int VoiceManager::GetStreamSize(Aws::IOStream* stream)
 {
     // Ensure the stream is at the beginning
@@ -29,6 +29,12 @@ public:
     ~VoiceManager();
 
     void synthesizeVoiceMessage(const std::string& message, const std::string& outputDirectory, const std::string& outputTrackName);
+    /* Apps are initialized in parallel, lookups are locked against the messages being added. Messages are never
+       removed and references to them stay valid. Throws std::out_of_range when not synthesized. */
+    AudioTrack& getVoiceMessage(const std::string& trackName);
+    /* nullptr when not synthesized (yet) */
+    AudioTrack* findVoiceMessage(const std::string& trackName);
+    /* Unlocked, only while no app is initializing */
     std::unordered_map<std::string, AudioTrack>& getSynthesizedVoiceAudioTracks() { return synthesizedVoiceAudioTracks_; }
 
 private:
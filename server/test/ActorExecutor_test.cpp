@@ -0,0 +1,51 @@
+#include "catch.hpp"
+
+#include "systems/executor/ActorExecutor.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+SCENARIO("Sending commands to an actor from many threads")
+{
+    GIVEN("A started actor")
+    {
+        Pdb::ActorExecutor actor("test");
+        actor.start();
+
+        WHEN ("Several threads send commands at the same time")
+        {
+            const int nSenders = 4, nCommandsPerSender = 10000;
+            std::vector<int> lastCommandOfSender(nSenders, -1);
+            std::atomic<int> nOutOfOrder(0), nConcurrent(0);
+            std::atomic<bool> running(false);
+
+            std::vector<std::thread> senders;
+            for (int sender = 0; sender < nSenders; ++sender)
+            {
+                senders.emplace_back([&, sender]
+                {
+                    for (int command = 0; command < nCommandsPerSender; ++command)
+                    {
+                        actor.send("command", [&, sender, command]
+                        {
+                            if (running.exchange(true)) ++nConcurrent;
+                            if (lastCommandOfSender[sender] != command - 1) ++nOutOfOrder;
+                            lastCommandOfSender[sender] = command;
+                            running = false;
+                        });
+                    }
+                });
+            }
+            for (auto& sender : senders) sender.join();
+            actor.stop();
+
+            THEN ("All commands run one at a time, in the order each thread sent them")
+            {
+                REQUIRE ( nConcurrent == 0 );
+                REQUIRE ( nOutOfOrder == 0 );
+                for (int sender = 0; sender < nSenders; ++sender)
+                    REQUIRE ( lastCommandOfSender[sender] == nCommandsPerSender - 1 );
+            }
+        }
+    }
+}
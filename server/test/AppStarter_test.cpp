@@ -0,0 +1,85 @@
+#include "catch.hpp"
+
+#include "apps/AppStarter.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+bool isStartedBefore(const std::vector<std::string>& startOrder, const std::string& first, const std::string& second)
+{
+    return std::find(startOrder.begin(), startOrder.end(), first) < std::find(startOrder.begin(), startOrder.end(), second);
+}
+
+}
+
+SCENARIO("Resolving the order apps are started in")
+{
+    GIVEN("Apps depending on each other")
+    {
+        std::unordered_map<std::string, std::vector<std::string>> dependencies {
+            { "audiobook", { "clock", "network" } },
+            { "clock", { } },
+            { "network", { "clock" } },
+            { "radio", { } }
+        };
+        std::vector<std::string> startOrder;
+        std::string error;
+
+        WHEN ("The dependencies are acyclic")
+        {
+            const bool isResolved = Pdb::AppStarter::resolveStartOrder(dependencies, startOrder, error);
+
+            THEN ("Every app is started once, after all the apps it depends on")
+            {
+                REQUIRE ( isResolved );
+                REQUIRE ( error.empty() );
+                REQUIRE ( startOrder.size() == 4 );
+                REQUIRE ( std::count(startOrder.begin(), startOrder.end(), "radio") == 1 );
+                REQUIRE ( isStartedBefore(startOrder, "clock", "network") );
+                REQUIRE ( isStartedBefore(startOrder, "clock", "audiobook") );
+                REQUIRE ( isStartedBefore(startOrder, "network", "audiobook") );
+            }
+        }
+
+        WHEN ("An app depends on an app that is not registered")
+        {
+            dependencies["radio"] = { "podcast" };
+            const bool isResolved = Pdb::AppStarter::resolveStartOrder(dependencies, startOrder, error);
+
+            THEN ("Resolving fails, naming both apps")
+            {
+                REQUIRE ( !isResolved );
+                REQUIRE ( error.find("radio") != std::string::npos );
+                REQUIRE ( error.find("podcast") != std::string::npos );
+            }
+        }
+
+        WHEN ("Two apps depend on each other")
+        {
+            dependencies["clock"] = { "audiobook" };
+            const bool isResolved = Pdb::AppStarter::resolveStartOrder(dependencies, startOrder, error);
+
+            THEN ("Resolving fails on the cycle")
+            {
+                REQUIRE ( !isResolved );
+                REQUIRE ( error.find("cyclic") != std::string::npos );
+            }
+        }
+
+        WHEN ("An app depends on itself")
+        {
+            dependencies["radio"] = { "radio" };
+            const bool isResolved = Pdb::AppStarter::resolveStartOrder(dependencies, startOrder, error);
+
+            THEN ("Resolving fails on that app")
+            {
+                REQUIRE ( !isResolved );
+                REQUIRE ( error == "App radio has cyclic dependencies." );
+            }
+        }
+    }
+}
@@ -0,0 +1,233 @@
+#include "catch.hpp"
+
+#include "Config.h"
+#include "systems/audio/AudioManager.h"
+#include "systems/audio/AudioScheduler.h"
+#include "systems/audio/transcoding/WavFileWriter.h"
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/* Runs continuations right away, on the thread completing the request */
+class InlineExecutor : public Pdb::Executor
+{
+public:
+    void post(std::function<void()> job) override { job(); }
+};
+
+/* Silent 22050 Hz mono WAV */
+std::string writeWav(int milliseconds)
+{
+    const std::string filePath = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pdb-scheduler-%%%%%%.wav")).string();
+    std::vector<int16_t> samples(22050 * milliseconds / 1000);
+    Pdb::WavFileWriter writer;
+    writer.open(filePath, 22050, 1);
+    writer.write(samples.data(), samples.size());
+    writer.close();
+    return filePath;
+}
+
+/* Null backend paced like a sound card, so long tracks stay playing until stopped */
+Pdb::Config schedulerConfig(Pdb::AudioSchedulingRule navigationRule)
+{
+    Pdb::Config config = Pdb::Config::getInstance();
+    config.audioBackend = Pdb::AudioBackend::NULL_OUTPUT;
+    config.nullAudioBackendRealtime = true;
+    config.skipSilence = false;
+    config.loudnessNormalization = false;
+    config.alertSchedulingRule = Pdb::AudioSchedulingRule::PREEMPT;
+    config.navigationSchedulingRule = navigationRule;
+    config.contentSchedulingRule = Pdb::AudioSchedulingRule::DROP;
+    return config;
+}
+
+bool waitUntil(const std::function<bool()>& condition)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/* Stopped tasks finish on the audio sequencer, the manager must outlive them */
+bool waitUntilIdle(const Pdb::AudioManager& audioManager)
+{
+    return waitUntil([&] { return audioManager.getFreeAudioTaskCount() == (int)audioManager.getAudioTaskCount(); });
+}
+
+}
+
+SCENARIO("Preempting, queueing and dropping requests on the audio scheduler")
+{
+    GIVEN("A scheduler preempting alerts, queueing navigation prompts and dropping content, playing through the null backend")
+    {
+        const Pdb::Config initial = Pdb::Config::getInstance();
+        Pdb::Config::publish(schedulerConfig(Pdb::AudioSchedulingRule::QUEUE));
+        Pdb::AudioScheduler audioScheduler;
+        Pdb::AudioManager audioManager(audioScheduler.getPlayingOverlayCount(), 0, 3);
+        InlineExecutor executor;
+        const std::string longFilePath = writeWav(30000), shortFilePath = writeWav(100);
+        Pdb::AudioTrack longPrompt(longFilePath, Pdb::AudioTrack::Type::VOICE_MESSAGE);
+        Pdb::AudioTrack shortPrompt(shortFilePath, Pdb::AudioTrack::Type::VOICE_MESSAGE);
+        Pdb::AudioTrack content(longFilePath, Pdb::AudioTrack::Type::STANDARD);
+        std::atomic<int> nAlertsDone(0), nNavigationsDone(0), nContentsDone(0);
+
+        WHEN ("An alert is played over a navigation prompt")
+        {
+            Pdb::AudioTask* navigationTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::NAVIGATION,
+                { longPrompt }, executor, [&] { ++nNavigationsDone; });
+            Pdb::AudioTask* alertTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::ALERT,
+                { longPrompt }, executor, [&] { ++nAlertsDone; });
+            const int nNavigationsDoneBeforeStop = nNavigationsDone, nAlertsDoneBeforeStop = nAlertsDone;
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::ALERT);
+
+            THEN ("The navigation prompt is preempted, the alert plays until stopped")
+            {
+                REQUIRE ( navigationTask != nullptr );
+                REQUIRE ( alertTask != nullptr );
+                REQUIRE ( nNavigationsDoneBeforeStop == 1 );
+                REQUIRE ( nAlertsDoneBeforeStop == 0 );
+                REQUIRE ( nAlertsDone == 1 );
+                REQUIRE ( nNavigationsDone == 1 );
+            }
+        }
+
+        WHEN ("A navigation prompt is played during an alert, which is then stopped")
+        {
+            std::promise<void> navigationDone;
+            audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::ALERT, { longPrompt }, executor, [&] { ++nAlertsDone; });
+            Pdb::AudioTask* navigationTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::NAVIGATION,
+                { shortPrompt }, executor, [&] { ++nNavigationsDone; navigationDone.set_value(); });
+            const int nNavigationsDoneWhileQueued = nNavigationsDone;
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::ALERT);
+            const int nNavigationsDoneAfterAlert = nNavigationsDone;
+            const bool isNavigationDone = navigationDone.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::NAVIGATION);
+
+            THEN ("The navigation prompt is queued, then played to its end, its continuation runs once")
+            {
+                REQUIRE ( navigationTask == nullptr );
+                REQUIRE ( nNavigationsDoneWhileQueued == 0 );
+                REQUIRE ( nNavigationsDoneAfterAlert == 0 );
+                REQUIRE ( isNavigationDone );
+                REQUIRE ( nNavigationsDone == 1 );
+                REQUIRE ( nAlertsDone == 1 );
+            }
+        }
+
+        WHEN ("Content is played over content, and an alert over content")
+        {
+            Pdb::AudioTask* contentTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::CONTENT,
+                { content }, executor, [&] { ++nContentsDone; });
+            Pdb::AudioTask* droppedTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::CONTENT,
+                { content }, executor, [&] { ++nContentsDone; });
+            const int nContentsDoneAfterDrop = nContentsDone;
+            Pdb::AudioTask* alertTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::ALERT,
+                { longPrompt }, executor, [&] { ++nAlertsDone; });
+            const int nContentsDoneAfterAlert = nContentsDone;
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::ALERT);
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::CONTENT);
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::CONTENT);
+
+            THEN ("The second content is dropped, the alert plays on top of the first one, each continuation runs once")
+            {
+                REQUIRE ( contentTask != nullptr );
+                REQUIRE ( droppedTask == nullptr );
+                REQUIRE ( nContentsDoneAfterDrop == 1 );
+                REQUIRE ( alertTask != nullptr );
+                REQUIRE ( nContentsDoneAfterAlert == 1 );
+                REQUIRE ( nAlertsDone == 1 );
+                REQUIRE ( nContentsDone == 2 );
+            }
+        }
+
+        REQUIRE ( waitUntilIdle(audioManager) );
+        boost::filesystem::remove(longFilePath);
+        boost::filesystem::remove(shortFilePath);
+        Pdb::Config::publish(initial);
+    }
+
+    GIVEN("A scheduler dropping navigation prompts")
+    {
+        const Pdb::Config initial = Pdb::Config::getInstance();
+        Pdb::Config::publish(schedulerConfig(Pdb::AudioSchedulingRule::DROP));
+        Pdb::AudioScheduler audioScheduler;
+        Pdb::AudioManager audioManager(audioScheduler.getPlayingOverlayCount(), 0, 2);
+        InlineExecutor executor;
+        const std::string filePath = writeWav(30000);
+        Pdb::AudioTrack prompt(filePath, Pdb::AudioTrack::Type::VOICE_MESSAGE);
+        std::atomic<int> nAlertsDone(0), nNavigationsDone(0);
+
+        WHEN ("A navigation prompt is played during an alert")
+        {
+            audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::ALERT, { prompt }, executor, [&] { ++nAlertsDone; });
+            Pdb::AudioTask* navigationTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::NAVIGATION,
+                { prompt }, executor, [&] { ++nNavigationsDone; });
+            const int nAlertsDoneAfterDrop = nAlertsDone;
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::ALERT);
+
+            THEN ("It is dropped right away, the alert keeps playing")
+            {
+                REQUIRE ( navigationTask == nullptr );
+                REQUIRE ( nNavigationsDone == 1 );
+                REQUIRE ( nAlertsDoneAfterDrop == 0 );
+                REQUIRE ( nAlertsDone == 1 );
+            }
+        }
+
+        REQUIRE ( waitUntilIdle(audioManager) );
+        boost::filesystem::remove(filePath);
+        Pdb::Config::publish(initial);
+    }
+}
+
+SCENARIO("Reusing the pooled task of a finished prompt for content")
+{
+    GIVEN("A scheduler playing through an audio manager with a single task")
+    {
+        const Pdb::Config initial = Pdb::Config::getInstance();
+        Pdb::Config::publish(schedulerConfig(Pdb::AudioSchedulingRule::QUEUE));
+        Pdb::AudioScheduler audioScheduler;
+        Pdb::AudioManager audioManager(audioScheduler.getPlayingOverlayCount(), 0, 1);
+        InlineExecutor executor;
+        const std::string shortFilePath = writeWav(100), longFilePath = writeWav(30000);
+        Pdb::AudioTrack prompt(shortFilePath, Pdb::AudioTrack::Type::VOICE_MESSAGE);
+        Pdb::AudioTrack content(longFilePath, Pdb::AudioTrack::Type::STANDARD);
+        std::atomic<int> nPromptsDone(0), nContentsDone(0);
+
+        WHEN ("Content is played once the prompt finished, whether or not its completion was dispatched yet")
+        {
+            Pdb::AudioTask* promptTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::NAVIGATION,
+                { prompt }, executor, [&] { ++nPromptsDone; });
+            const bool isPromptFinished = promptTask && waitUntil([&] { return promptTask->isAvailable(); });
+            Pdb::AudioTask* contentTask = audioScheduler.play(audioManager, Pdb::AudioScheduler::Priority::CONTENT,
+                { content }, executor, [&] { ++nContentsDone; });
+            const int nPromptsDoneAfterReuse = nPromptsDone, nContentsDoneAfterReuse = nContentsDone;
+            audioScheduler.stop(audioManager, Pdb::AudioScheduler::Priority::CONTENT);
+
+            THEN ("The prompt is completed once and the content plays on the same task until stopped")
+            {
+                REQUIRE ( isPromptFinished );
+                REQUIRE ( contentTask == promptTask );
+                REQUIRE ( nPromptsDoneAfterReuse == 1 );
+                REQUIRE ( nContentsDoneAfterReuse == 0 );
+                REQUIRE ( nPromptsDone == 1 );
+                REQUIRE ( nContentsDone == 1 );
+            }
+        }
+
+        REQUIRE ( waitUntilIdle(audioManager) );
+        boost::filesystem::remove(shortFilePath);
+        boost::filesystem::remove(longFilePath);
+        Pdb::Config::publish(initial);
+    }
+}
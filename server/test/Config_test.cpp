@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "Config.h"
+#include "systems/executor/ActorExecutor.h"
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+/* config.ini of the repository with one value replaced */
+std::string writeConfig(const std::string& from, const std::string& to)
+{
+    std::ifstream input("../config.ini");
+    std::stringstream content;
+    content << input.rdbuf();
+    const std::string filePath = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pdb-config-%%%%%%.ini")).string();
+    std::ofstream output(filePath);
+    output << boost::algorithm::replace_all_copy(content.str(), from, to);
+    return filePath;
+}
+
+}
+
+SCENARIO("Reloading config snapshots")
+{
+    GIVEN("The current snapshot and a subscriber running on an actor")
+    {
+        const Pdb::Config& initial = Pdb::Config::getInstance();
+        Pdb::ActorExecutor actor("test");
+        actor.start();
+        std::vector<Pdb::InputMode> previousModes, currentModes;
+        const Pdb::Config::SubscriptionId subscriptionId = Pdb::Config::subscribe(actor, [&](const Pdb::Config& previous, const Pdb::Config& current)
+        {
+            previousModes.push_back(previous.inputMode);
+            currentModes.push_back(current.inputMode);
+        });
+
+        WHEN ("A file with another input mode is reloaded")
+        {
+            const std::string filePath = writeConfig("inputMode=debug", "inputMode=prod");
+            const bool isReloaded = Pdb::Config::reload(filePath);
+            actor.stop();
+
+            THEN ("A new snapshot is published and the subscriber gets both, the initial one stays valid")
+            {
+                REQUIRE ( isReloaded );
+                REQUIRE ( Pdb::Config::getInstance().inputMode == Pdb::InputMode::PROD );
+                REQUIRE ( &Pdb::Config::getInstance() != &initial );
+                REQUIRE ( initial.inputMode == Pdb::InputMode::DEBUG );
+                REQUIRE ( previousModes == std::vector<Pdb::InputMode> { Pdb::InputMode::DEBUG } );
+                REQUIRE ( currentModes == std::vector<Pdb::InputMode> { Pdb::InputMode::PROD } );
+            }
+            boost::filesystem::remove(filePath);
+        }
+
+        WHEN ("A file with a wrong value is reloaded")
+        {
+            const std::string filePath = writeConfig("inputMode=debug", "inputMode=keyboard");
+            const bool isReloaded = Pdb::Config::reload(filePath);
+            actor.stop();
+
+            THEN ("The current snapshot is kept and nobody is notified")
+            {
+                REQUIRE ( !isReloaded );
+                REQUIRE ( &Pdb::Config::getInstance() == &initial );
+                REQUIRE ( currentModes.empty() );
+            }
+            boost::filesystem::remove(filePath);
+        }
+
+        Pdb::Config::unsubscribe(subscriptionId);
+        Pdb::Config::publish(initial);
+    }
+}
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+
+#include "ExecutorFixture.h"
+#include "systems/executor/Coroutine.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+Pdb::Coroutine sequence(Pdb::TimerWheel& timerWheel, Pdb::ActorExecutor& actor, std::vector<int>& steps,
+    std::atomic<bool>& onActorThread, Pdb::Test::Countdown& finished)
+{
+    co_await Pdb::resumeOn(actor);
+    const std::thread::id actorThreadId = std::this_thread::get_id();
+    steps.push_back(1);
+    co_await timerWheel.sleepFor(std::chrono::milliseconds(20), actor);
+    onActorThread = (std::this_thread::get_id() == actorThreadId);
+    steps.push_back(2);
+    co_await timerWheel.sleepFor(std::chrono::milliseconds(20), actor);
+    steps.push_back(3);
+    finished.countDown();
+}
+
+/* Parks on the actor, then sleeps far longer than any test runs */
+Pdb::Coroutine parkedFlow(Pdb::TimerWheel& timerWheel, Pdb::ActorExecutor& actor, std::shared_ptr<int> local,
+    std::promise<void>& onActor, std::atomic<bool>& resumed)
+{
+    co_await Pdb::resumeOn(actor);
+    onActor.set_value();
+    co_await timerWheel.sleepFor(std::chrono::hours(1), actor);
+    resumed = true;
+}
+
+Pdb::Coroutine movingFlow(Pdb::ActorExecutor& actor, std::shared_ptr<int> local, std::atomic<bool>& resumed)
+{
+    co_await Pdb::resumeOn(actor);
+    resumed = true;
+}
+
+}
+
+SCENARIO("Sequencing a flow with coroutines")
+{
+    GIVEN("A timer wheel on a running event loop and an actor")
+    {
+        Pdb::Test::ExecutorFixture executors;
+        Pdb::TimerWheel& timerWheel = executors.timerWheel;
+        Pdb::ActorExecutor& actor = executors.actor;
+
+        WHEN ("A flow moves to the actor and sleeps twice")
+        {
+            std::vector<int> steps;
+            std::atomic<bool> onActorThread(false);
+            Pdb::Test::Countdown finished(1);
+            auto actorGate = executors.holdActor();
+            sequence(timerWheel, actor, steps, onActorThread, finished);
+            /* The actor is held, nothing of the flow ran on the caller */
+            const bool hasReturnedBeforeSteps = steps.empty();
+            actorGate->countDown();
+            const bool hasFinished = finished.wait();
+
+            THEN ("The caller is not blocked, the steps run in order on the actor thread")
+            {
+                REQUIRE ( hasReturnedBeforeSteps );
+                REQUIRE ( hasFinished );
+                REQUIRE ( onActorThread );
+                REQUIRE ( steps == std::vector<int>({ 1, 2, 3 }) );
+                REQUIRE ( timerWheel.getPendingCount() == 0 );
+            }
+        }
+
+        WHEN ("The timers of a stopped actor are cancelled while a flow sleeps on it")
+        {
+            std::promise<void> onActor;
+            std::atomic<bool> resumed(false);
+            auto local = std::make_shared<int>(0);
+            std::weak_ptr<int> weakLocal = local;
+            parkedFlow(timerWheel, actor, std::move(local), onActor, resumed);
+            onActor.get_future().wait();
+            actor.stop();       /* Returns once the flow suspended, the actor thread ran it */
+            timerWheel.cancelAll(actor);
+
+            THEN ("The flow is destroyed without being resumed")
+            {
+                REQUIRE ( weakLocal.expired() );
+                REQUIRE ( !resumed );
+                REQUIRE ( timerWheel.getPendingCount() == 0 );
+            }
+        }
+
+        WHEN ("A flow moves to an actor that is stopped")
+        {
+            actor.stop();
+            std::atomic<bool> resumed(false);
+            auto local = std::make_shared<int>(0);
+            std::weak_ptr<int> weakLocal = local;
+            movingFlow(actor, std::move(local), resumed);
+
+            THEN ("The flow is destroyed without being resumed")
+            {
+                REQUIRE ( weakLocal.expired() );
+                REQUIRE ( !resumed );
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+
+#include "apps/DispatchTable.h"
+
+namespace
+{
+
+enum class State { FIRST, SECOND };
+
+struct Counter
+{
+    int nPlays = 0;
+    int nSkipped = 0;
+};
+
+}
+
+SCENARIO("Dispatching buttons through a state by button table")
+{
+    GIVEN("A table with actions for some buttons, one of them in all states")
+    {
+        Pdb::DispatchTable<Counter, State, 2, int> actions;
+        actions.set(State::FIRST, Pdb::InputManager::Button::BUTTON_S, [](Counter& counter, int) { ++counter.nPlays; });
+        actions.setAll(Pdb::InputManager::Button::BUTTON_D, [](Counter& counter, int nPresses) { counter.nSkipped += nPresses; });
+        Counter counter;
+
+        WHEN ("Buttons are dispatched in both states")
+        {
+            const bool playedInFirst = actions.dispatch(counter, State::FIRST, Pdb::InputManager::Button::BUTTON_S, 1);
+            const bool playedInSecond = actions.dispatch(counter, State::SECOND, Pdb::InputManager::Button::BUTTON_S, 1);
+            actions.dispatch(counter, State::FIRST, Pdb::InputManager::Button::BUTTON_D, 2);
+            actions.dispatch(counter, State::SECOND, Pdb::InputManager::Button::BUTTON_D, 3);
+            const bool unmapped = actions.dispatch(counter, State::FIRST, Pdb::InputManager::Button::BUTTON_Q, 1);
+
+            THEN ("Only the actions set for the state run, with the dispatched arguments")
+            {
+                REQUIRE ( playedInFirst );
+                REQUIRE ( !playedInSecond );
+                REQUIRE ( !unmapped );
+                REQUIRE ( counter.nPlays == 1 );
+                REQUIRE ( counter.nSkipped == 5 );
+            }
+        }
+    }
+}
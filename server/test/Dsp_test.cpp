@@ -0,0 +1,122 @@
+#include "catch.hpp"
+
+#include "systems/audio/analysis/LoudnessMeter.h"
+#include "systems/audio/dsp/Biquad.h"
+#include "systems/audio/dsp/Compressor.h"
+#include "systems/audio/dsp/DspKernels.h"
+#include <cmath>
+#include <vector>
+
+SCENARIO("Converting samples between int16 and float")
+{
+    GIVEN("Samples covering the whole int16 range")
+    {
+        std::vector<int16_t> samples;
+        for (int i = -32768; i <= 32767; i += 37) samples.push_back(static_cast<int16_t>(i));
+
+        WHEN ("Converting them to float and back")
+        {
+            std::vector<float> floatSamples(samples.size());
+            std::vector<int16_t> convertedSamples(samples.size());
+            Pdb::DspKernels::int16ToFloat(samples.data(), floatSamples.data(), samples.size());
+            Pdb::DspKernels::floatToInt16(floatSamples.data(), convertedSamples.data(), samples.size());
+
+            THEN ("Samples are unchanged")
+            {
+                REQUIRE ( convertedSamples == samples );
+            }
+        }
+
+        WHEN ("Converting out of range floats")
+        {
+            std::vector<float> floatSamples(19, 1.5f);
+            floatSamples[3] = -2.0f;
+            std::vector<int16_t> convertedSamples(floatSamples.size());
+            Pdb::DspKernels::floatToInt16(floatSamples.data(), convertedSamples.data(), floatSamples.size());
+
+            THEN ("They saturate")
+            {
+                REQUIRE ( convertedSamples[0] == 32767 );
+                REQUIRE ( convertedSamples[3] == -32768 );
+                REQUIRE ( convertedSamples[18] == 32767 );
+            }
+        }
+    }
+}
+
+SCENARIO("Filtering and compressing a block of samples")
+{
+    const unsigned int sampleRate = 16000;
+
+    GIVEN("A constant (DC) signal")
+    {
+        std::vector<float> samples(sampleRate, 0.5f);
+
+        WHEN ("Passing it through a high-pass filter")
+        {
+            Pdb::Biquad highPass(Pdb::Biquad::Type::HIGHPASS, 100.0f, 0.707f);
+            highPass.prepare(sampleRate, 1);
+            highPass.process(samples.data(), samples.size());
+
+            THEN ("It is removed")
+            {
+                REQUIRE ( std::fabs(samples.back()) < 0.001f );
+            }
+        }
+    }
+
+    GIVEN("A loud sine")
+    {
+        std::vector<float> samples(sampleRate);
+        for (size_t i = 0; i < samples.size(); ++i) samples[i] = 0.9f * std::sin(2.0f * M_PI * 440.0f * i / sampleRate);
+
+        WHEN ("Passing it through a limiter")
+        {
+            Pdb::Compressor limiter = Pdb::Compressor::limiter(-6.0f, 50.0f);
+            limiter.prepare(sampleRate, 1);
+            limiter.process(samples.data(), samples.size());
+
+            THEN ("Its peak settles at the threshold")
+            {
+                float peak = Pdb::DspKernels::peak(samples.data() + sampleRate / 2, sampleRate / 2);
+                REQUIRE ( peak < std::pow(10.0f, -5.5f / 20.0f) );
+                REQUIRE ( peak > std::pow(10.0f, -7.0f / 20.0f) );
+            }
+        }
+    }
+}
+
+SCENARIO("Measuring loudness")
+{
+    const unsigned int sampleRate = 48000;
+
+    GIVEN("A 1 kHz sine with amplitude 0.1 (-23 dBFS RMS)")
+    {
+        std::vector<float> samples(sampleRate * 5);
+        for (size_t i = 0; i < samples.size(); ++i) samples[i] = 0.1f * std::sin(2.0f * M_PI * 1000.0f * i / sampleRate);
+
+        WHEN ("Measuring its integrated loudness in small chunks")
+        {
+            Pdb::LoudnessMeter loudnessMeter(sampleRate, 1);
+            for (size_t offset = 0; offset < samples.size(); offset += 1000)
+                loudnessMeter.addSamples(samples.data() + offset, std::min<size_t>(1000, samples.size() - offset));
+
+            THEN ("It is about -23 LUFS")
+            {
+                REQUIRE ( loudnessMeter.getIntegratedLoudness() == Approx(-23.0).epsilon(0.02) );
+            }
+        }
+    }
+
+    GIVEN("Digital silence")
+    {
+        std::vector<float> samples(sampleRate, 0.0f);
+        Pdb::LoudnessMeter loudnessMeter(sampleRate, 2);
+        loudnessMeter.addSamples(samples.data(), samples.size());
+
+        THEN ("Everything is gated out")
+        {
+            REQUIRE ( std::isinf(loudnessMeter.getIntegratedLoudness()) );
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include "catch.hpp"
+
+#include "systems/input/EvdevInputBackend.h"
+
+SCENARIO("Mapping evdev key codes to buttons")
+{
+    GIVEN("Key codes of the keypad and of the debug keyboard")
+    {
+        Pdb::InputManager::Button button;
+
+        THEN ("Keypad keys map to their num lock off buttons")
+        {
+            REQUIRE ( Pdb::EvdevInputBackend::toButton(KEY_KP5, button) );
+            REQUIRE ( button == Pdb::InputManager::Button::KeyKpBegin );
+            REQUIRE ( Pdb::EvdevInputBackend::toButton(KEY_KPDOT, button) );
+            REQUIRE ( button == Pdb::InputManager::Button::KeyKpDelete );
+            REQUIRE ( Pdb::EvdevInputBackend::toButton(KEY_KPENTER, button) );
+            REQUIRE ( button == Pdb::InputManager::Button::KeyKpEnter );
+        }
+
+        THEN ("Debug keyboard letters map to their buttons")
+        {
+            REQUIRE ( Pdb::EvdevInputBackend::toButton(KEY_Q, button) );
+            REQUIRE ( button == Pdb::InputManager::Button::BUTTON_Q );
+            REQUIRE ( Pdb::EvdevInputBackend::toButton(KEY_UP, button) );
+            REQUIRE ( button == Pdb::InputManager::Button::BUTTON_UP );
+        }
+
+        THEN ("Other keys are ignored")
+        {
+            REQUIRE_FALSE ( Pdb::EvdevInputBackend::toButton(KEY_Z, button) );
+            REQUIRE_FALSE ( Pdb::EvdevInputBackend::toButton(KEY_ESC, button) );
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+
+#include "ExecutorFixture.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+SCENARIO("Running timers, descriptors and posted jobs on the event loop")
+{
+    GIVEN("An event loop running on its own thread")
+    {
+        Pdb::Test::ExecutorFixture executors;
+        Pdb::EventLoop& eventLoop = executors.eventLoop;
+
+        WHEN ("A one-shot and a periodic timer are added, the periodic one removed after 3 firings")
+        {
+            std::atomic<int> nOneShotFirings(0), nPeriodicFirings(0);
+            Pdb::Test::Countdown oneShotFired(1), periodicFired(3), laterTimerFired(1);
+            eventLoop.addTimer(std::chrono::milliseconds(10), std::chrono::milliseconds(0), [&] { ++nOneShotFirings; oneShotFired.countDown(); });
+            auto periodicTimer = eventLoop.addTimer(std::chrono::milliseconds(10), std::chrono::milliseconds(10), [&]
+            {
+                ++nPeriodicFirings;
+                periodicFired.countDown();
+            });
+            const bool hasPeriodicFired = periodicFired.wait() && oneShotFired.wait();
+            eventLoop.remove(periodicTimer);
+            const int nPeriodicFiringsAfterRemoval = nPeriodicFirings;
+            /* The periodic timer would have fired meanwhile */
+            eventLoop.addTimer(std::chrono::milliseconds(30), std::chrono::milliseconds(0), [&] { laterTimerFired.countDown(); });
+            const bool hasLaterTimerFired = laterTimerFired.wait();
+
+            THEN ("The one-shot timer fires once, the periodic one repeatedly until removed")
+            {
+                REQUIRE ( hasPeriodicFired );
+                REQUIRE ( hasLaterTimerFired );
+                REQUIRE ( nOneShotFirings == 1 );
+                REQUIRE ( nPeriodicFiringsAfterRemoval >= 3 );
+                REQUIRE ( nPeriodicFirings == nPeriodicFiringsAfterRemoval );
+            }
+        }
+
+        WHEN ("A readable descriptor is added and a job is posted")
+        {
+            int pipeFds[2];
+            REQUIRE ( pipe(pipeFds) == 0 );
+            std::atomic<bool> isReadable(false);
+            Pdb::Test::Countdown handled(2);
+            std::thread::id handlerThreadId, jobThreadId;
+            eventLoop.addFileDescriptor(pipeFds[0], EPOLLIN, [&](uint32_t events)
+            {
+                char byte;
+                if ((events & EPOLLIN) && read(pipeFds[0], &byte, 1) == 1) isReadable = true;
+                handlerThreadId = std::this_thread::get_id();
+                handled.countDown();
+            });
+            eventLoop.post([&] { jobThreadId = std::this_thread::get_id(); handled.countDown(); });
+            REQUIRE ( write(pipeFds[1], "x", 1) == 1 );
+            const bool hasHandledBoth = handled.wait();
+
+            THEN ("Both run on the loop thread")
+            {
+                REQUIRE ( hasHandledBoth );
+                REQUIRE ( isReadable );
+                REQUIRE ( handlerThreadId == executors.loopThread.get_id() );
+                REQUIRE ( jobThreadId == executors.loopThread.get_id() );
+            }
+            close(pipeFds[0]);
+            close(pipeFds[1]);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "systems/executor/ActorExecutor.h"
+#include "systems/executor/EventLoop.h"
+#include "systems/executor/TimerWheel.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Pdb
+{
+namespace Test
+{
+
+/* Lets the test thread wait until something happened a number of times on other threads, instead of sleeping long
+   enough. Waits time out (generously) so that a broken test fails instead of hanging. */
+class Countdown
+{
+public:
+    explicit Countdown(int count) : count_(count) { }
+
+    void countDown()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ > 0 && --count_ == 0) reachedZeroCondVar_.notify_all();
+    }
+    bool wait(std::chrono::milliseconds timeout = std::chrono::seconds(5))
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return reachedZeroCondVar_.wait_for(lock, timeout, [this] { return count_ == 0; });
+    }
+
+private:
+    int count_;
+    std::mutex mutex_;
+    std::condition_variable reachedZeroCondVar_;
+};
+
+/* An event loop running on a thread of its own, a 1 ms timer wheel on it and a started actor - what the timers,
+   flows and coalescers under test run on. All of them are stopped when the fixture goes away. */
+class ExecutorFixture
+{
+public:
+    ExecutorFixture() : timerWheel(eventLoop, std::chrono::milliseconds(1)), actor("test")
+    {
+        loopThread = std::thread([this] { eventLoop.run(); });
+        actor.start();
+    }
+    ~ExecutorFixture()
+    {
+        actor.stop();
+        eventLoop.stop();
+        loopThread.join();
+    }
+
+    /* Keeps the actor busy until the returned gate is counted down, jobs posted meanwhile are all queued before
+       the first of them runs */
+    std::shared_ptr<Countdown> holdActor()
+    {
+        auto gate = std::make_shared<Countdown>(1);
+        actor.post([gate] { gate->wait(); });
+        return gate;
+    }
+
+    EventLoop eventLoop;
+    TimerWheel timerWheel;
+    ActorExecutor actor;
+    std::thread loopThread;
+};
+
+}
+}
@@ -0,0 +1,76 @@
+#include "catch.hpp"
+
+#include "ExecutorFixture.h"
+#include "systems/input/InputCoalescer.h"
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using Button = Pdb::InputManager::Button;
+
+namespace
+{
+
+/* Presses queued on the held actor and then handled back to back, like a user hammering the keys faster than
+   any window */
+void pressScripted(Pdb::Test::ExecutorFixture& executors, Pdb::InputCoalescer& inputCoalescer, const std::vector<Button>& buttons)
+{
+    auto actorGate = executors.holdActor();
+    for (Button button : buttons) executors.actor.post([&inputCoalescer, button] { inputCoalescer.press(button); });
+    actorGate->countDown();
+}
+
+}
+
+SCENARIO("Coalescing bursts of button presses")
+{
+    GIVEN("A timer wheel on a running event loop and an actor handling the presses")
+    {
+        Pdb::Test::ExecutorFixture executors;
+        Pdb::TimerWheel& timerWheel = executors.timerWheel;
+        Pdb::ActorExecutor& actor = executors.actor;
+
+        std::vector<std::pair<Button, int>> commands;
+        Pdb::Test::Countdown burstsHandled(4);
+        auto handler = [&](Button button, int nPresses)
+        {
+            commands.push_back(std::make_pair(button, nPresses));
+            burstsHandled.countDown();
+        };
+        const std::vector<Button> script { Button::BUTTON_D, Button::BUTTON_D, Button::BUTTON_D, Button::BUTTON_D, Button::BUTTON_D,
+            Button::BUTTON_S, Button::BUTTON_D, Button::BUTTON_D, Button::BUTTON_A, Button::BUTTON_A, Button::BUTTON_A };
+
+        WHEN ("Bursts of repeatable buttons are pressed within the window, interleaved with another button")
+        {
+            Pdb::InputCoalescer inputCoalescer(timerWheel, actor, std::chrono::milliseconds(50),
+                { Button::BUTTON_D, Button::BUTTON_A }, handler);
+            pressScripted(executors, inputCoalescer, script);
+            const bool hasHandledBursts = burstsHandled.wait();
+            actor.stop();
+
+            THEN ("Each burst is one command with its press count, in the order pressed")
+            {
+                REQUIRE ( hasHandledBursts );
+                const std::vector<std::pair<Button, int>> expected { { Button::BUTTON_D, 5 }, { Button::BUTTON_S, 1 },
+                    { Button::BUTTON_D, 2 }, { Button::BUTTON_A, 3 } };
+                REQUIRE ( commands == expected );
+                REQUIRE ( inputCoalescer.getPressCount() == 11 );
+                REQUIRE ( inputCoalescer.getHandledCount() == 4 );
+            }
+        }
+
+        WHEN ("The window is zero")
+        {
+            Pdb::InputCoalescer inputCoalescer(timerWheel, actor, std::chrono::milliseconds(0),
+                { Button::BUTTON_D, Button::BUTTON_A }, handler);
+            pressScripted(executors, inputCoalescer, script);
+            actor.stop();
+
+            THEN ("Every press is handled on its own")
+            {
+                REQUIRE ( commands.size() == script.size() );
+                REQUIRE ( inputCoalescer.getHandledCount() == 11 );
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#include "catch.hpp"
+
+#include "systems/executor/ThreadRole.h"
+#include <string>
+#include <vector>
+
+SCENARIO("Parsing CPU lists of thread roles")
+{
+    GIVEN("Threads.*Cpus values")
+    {
+        std::vector<int> cpus;
+
+        WHEN ("A list of single CPUs and ranges is parsed")
+        {
+            const bool isParsed = Pdb::parseCpuList(" 0-1, 3 ,5-7", cpus);
+
+            THEN ("Every CPU of it is listed, in order")
+            {
+                REQUIRE ( isParsed );
+                REQUIRE ( cpus == std::vector<int> { 0, 1, 3, 5, 6, 7 } );
+            }
+        }
+
+        WHEN ("An empty list is parsed")
+        {
+            cpus = { 2 };
+            const bool isParsed = Pdb::parseCpuList("", cpus);
+
+            THEN ("No CPU is listed - threads of the role may run on all of them")
+            {
+                REQUIRE ( isParsed );
+                REQUIRE ( cpus.empty() );
+            }
+        }
+
+        WHEN ("Malformed lists are parsed")
+        {
+            THEN ("Each of them is rejected")
+            {
+                for (const std::string& malformedCpus : { "a", "1-", "3-1", "-1", "1-2-3", "1:2", "0,x" })
+                {
+                    INFO ( malformedCpus );
+                    REQUIRE ( !Pdb::parseCpuList(malformedCpus, cpus) );
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include "catch.hpp"
+
+#include "ExecutorFixture.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+SCENARIO("Scheduling and cancelling timers on the timer wheel")
+{
+    GIVEN("A timer wheel with 1 ms resolution on a running event loop")
+    {
+        Pdb::Test::ExecutorFixture executors;
+        Pdb::EventLoop& eventLoop = executors.eventLoop;
+        Pdb::TimerWheel& timerWheel = executors.timerWheel;
+
+        WHEN ("One-shot and periodic timers are scheduled, and the periodic one cancelled")
+        {
+            std::atomic<int> nOneShotFirings(0), nPeriodicFirings(0);
+            Pdb::Test::Countdown oneShotFired(1), periodicFired(3), laterTimerFired(1);
+            timerWheel.schedule(std::chrono::milliseconds(10), std::chrono::milliseconds(0), eventLoop, [&] { ++nOneShotFirings; oneShotFired.countDown(); });
+            auto periodicTimer = timerWheel.schedule(std::chrono::milliseconds(10), std::chrono::milliseconds(10), eventLoop, [&]
+            {
+                ++nPeriodicFirings;
+                periodicFired.countDown();
+            });
+            const bool hasPeriodicFired = periodicFired.wait() && oneShotFired.wait();
+            timerWheel.cancel(periodicTimer);
+            const int nPeriodicFiringsAfterCancel = nPeriodicFirings;
+            /* The periodic timer would have fired meanwhile */
+            timerWheel.schedule(std::chrono::milliseconds(30), std::chrono::milliseconds(0), eventLoop, [&] { laterTimerFired.countDown(); });
+            const bool hasLaterTimerFired = laterTimerFired.wait();
+
+            THEN ("The one-shot timer fires once, the periodic one repeatedly until cancelled")
+            {
+                REQUIRE ( hasPeriodicFired );
+                REQUIRE ( hasLaterTimerFired );
+                REQUIRE ( nOneShotFirings == 1 );
+                REQUIRE ( nPeriodicFiringsAfterCancel >= 3 );
+                REQUIRE ( nPeriodicFirings == nPeriodicFiringsAfterCancel );
+                REQUIRE ( timerWheel.getPendingCount() == 0 );
+            }
+        }
+
+        WHEN ("Timers are scheduled in upper levels of the wheel, one of them cancelled")
+        {
+            std::atomic<int> nFirings(0), nCancelledFirings(0);
+            Pdb::Test::Countdown fired(1), laterTimerFired(1);
+            auto startTime = std::chrono::steady_clock::now();
+            std::atomic<long long> firedAfterMilliseconds(0);
+            timerWheel.schedule(std::chrono::milliseconds(150), std::chrono::milliseconds(0), eventLoop, [&]
+            {
+                firedAfterMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+                ++nFirings;
+                fired.countDown();
+            });
+            auto cancelledTimer = timerWheel.schedule(std::chrono::milliseconds(100), std::chrono::milliseconds(0), eventLoop, [&] { ++nCancelledFirings; });
+            timerWheel.cancel(cancelledTimer);
+            const bool hasFired = fired.wait();
+            /* Catches a second firing of the one-shot timer */
+            timerWheel.schedule(std::chrono::milliseconds(30), std::chrono::milliseconds(0), eventLoop, [&] { laterTimerFired.countDown(); });
+            const bool hasLaterTimerFired = laterTimerFired.wait();
+
+            THEN ("Only the remaining timer fires, not before it is due")
+            {
+                REQUIRE ( hasFired );
+                REQUIRE ( hasLaterTimerFired );
+                REQUIRE ( nFirings == 1 );
+                REQUIRE ( nCancelledFirings == 0 );
+                REQUIRE ( firedAfterMilliseconds >= 140 );
+            }
+        }
+
+        WHEN ("All timers of a stopped actor are cancelled, while another executor has one too")
+        {
+            std::atomic<int> nActorFirings(0), nLoopFirings(0);
+            Pdb::Test::Countdown loopTimerFired(1), laterTimerFired(1);
+            Pdb::ActorExecutor actor("test");
+            auto capture = std::make_shared<int>(0);
+            std::weak_ptr<int> handlerCapture = capture;
+            timerWheel.schedule(std::chrono::milliseconds(20), std::chrono::milliseconds(0), actor, [&, capture] { ++nActorFirings; });
+            timerWheel.schedule(std::chrono::milliseconds(20), std::chrono::milliseconds(10), actor, [&, capture] { ++nActorFirings; });
+            timerWheel.schedule(std::chrono::milliseconds(20), std::chrono::milliseconds(0), eventLoop, [&] { ++nLoopFirings; loopTimerFired.countDown(); });
+            capture.reset();
+            actor.stop();
+            timerWheel.cancelAll(actor);
+            const bool handlersDestroyed = handlerCapture.expired();
+            const bool hasLoopTimerFired = loopTimerFired.wait();
+            /* The periodic timer of the actor would have fired meanwhile */
+            timerWheel.schedule(std::chrono::milliseconds(30), std::chrono::milliseconds(0), eventLoop, [&] { laterTimerFired.countDown(); });
+            const bool hasLaterTimerFired = laterTimerFired.wait();
+
+            THEN ("Handlers of the actor are destroyed right away and never run, the other timer fires")
+            {
+                REQUIRE ( hasLoopTimerFired );
+                REQUIRE ( hasLaterTimerFired );
+                REQUIRE ( handlersDestroyed );
+                REQUIRE ( nActorFirings == 0 );
+                REQUIRE ( nLoopFirings == 1 );
+                REQUIRE ( timerWheel.getPendingCount() == 0 );
+            }
+        }
+    }
+}